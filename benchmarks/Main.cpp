@@ -0,0 +1,402 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Kedarium/Simd.hpp"
+#include "Kedarium/Space.hpp"
+#include "Kedarium/Culling.hpp"
+
+// Constants
+constexpr size_t BATCH_SIZE       {65536};
+constexpr double DEFAULT_MIN_TIME {0.25};
+constexpr size_t SINCOS_SAMPLES   {1 << 22};
+
+/**
+ * @brief Stores the timing of a single benchmark.
+ */
+struct BenchmarkResult
+{
+  std::string name;
+  size_t operations;
+  double seconds;
+};
+
+/**
+ * @brief Prevents the compiler from optimizing away a value or the computations leading to it.
+ *
+ * @param value The value that must be considered observed.
+ */
+template <typename T>
+inline void doNotOptimize(T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r"(&value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+#endif
+}
+
+/**
+ * @brief Times a function, doubling the number of calls until the minimum time is reached.
+ *
+ * @param name The name of the benchmark.
+ * @param operationsPerCall The number of operations performed by one call of the function.
+ * @param minTime The minimum measured time in seconds.
+ * @param function The function to time.
+ * @return The result of the benchmark.
+ */
+template <typename F>
+BenchmarkResult runBenchmark(const std::string& name, const size_t operationsPerCall, const double minTime, F function)
+{
+  // Warm up caches and the branch predictor
+  function();
+
+  size_t calls {1};
+  while (true)
+  {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < calls; i++)
+    {
+      function();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (elapsed.count() >= minTime)
+    {
+      return {name, calls * operationsPerCall, elapsed.count()};
+    }
+    calls *= 2;
+  }
+}
+
+/**
+ * @brief Creates a matrix with random entries and a well-conditioned diagonal.
+ *
+ * @param engine The random number generator.
+ * @return The random matrix.
+ */
+kdr::Space::Mat4 randomMatrix(std::mt19937& engine)
+{
+  std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+  kdr::Space::Mat4 mat;
+  for (int c = 0; c < 4; c++)
+  {
+    for (int r = 0; r < 4; r++)
+    {
+      mat[c][r] = distribution(engine) + (c == r ? 4.f : 0.f);
+    }
+  }
+  return mat;
+}
+
+/**
+ * @brief Measures the largest error of the fast sincos path against double precision libm.
+ *
+ * The angles are spread evenly over [-SINCOS_MAX_RADIANS, SINCOS_MAX_RADIANS].
+ *
+ * @return The largest absolute error of either the sine or the cosine.
+ */
+double measureSinCosError()
+{
+  std::vector<float> radians(SINCOS_SAMPLES);
+  std::vector<float> sines(SINCOS_SAMPLES);
+  std::vector<float> cosines(SINCOS_SAMPLES);
+  for (size_t i = 0; i < SINCOS_SAMPLES; i++)
+  {
+    radians[i] = kdr::Simd::SINCOS_MAX_RADIANS * (2.f * i / (SINCOS_SAMPLES - 1) - 1.f);
+  }
+  kdr::Simd::sinCos(radians.data(), sines.data(), cosines.data(), SINCOS_SAMPLES);
+
+  double maxError {0.0};
+  for (size_t i = 0; i < SINCOS_SAMPLES; i++)
+  {
+    const double sineError = std::fabs(sines[i] - std::sin(static_cast<double>(radians[i])));
+    const double cosineError = std::fabs(cosines[i] - std::cos(static_cast<double>(radians[i])));
+    maxError = std::fmax(maxError, std::fmax(sineError, cosineError));
+  }
+  return maxError;
+}
+
+/**
+ * @brief Prints the results as a table.
+ *
+ * @param results The results to print.
+ * @param sinCosError The largest error of the fast sincos path.
+ */
+void printTable(const std::vector<BenchmarkResult>& results, const double sinCosError)
+{
+  std::cout << "Instruction set: " << kdr::Simd::getInstructionSet() << '\n';
+  std::cout << "Fast sincos max error: " << sinCosError << " (bound " << kdr::Simd::SINCOS_MAX_ERROR << ")\n";
+  std::cout << std::left << std::setw(36) << "Benchmark" << std::right << std::setw(14) << "ns/op" << std::setw(18) << "ops/s" << '\n';
+  for (const BenchmarkResult& result : results)
+  {
+    const double nsPerOp = result.seconds * 1e9 / result.operations;
+    std::cout
+      << std::left << std::setw(36) << result.name
+      << std::right << std::setw(14) << std::fixed << std::setprecision(3) << nsPerOp
+      << std::setw(18) << std::setprecision(0) << result.operations / result.seconds
+      << '\n';
+  }
+}
+
+/**
+ * @brief Prints the results as JSON for tracking regressions across releases.
+ *
+ * @param results The results to print.
+ * @param sinCosError The largest error of the fast sincos path.
+ */
+void printJson(const std::vector<BenchmarkResult>& results, const double sinCosError)
+{
+  std::cout << "{\n";
+  std::cout << "  \"instructionSet\": \"" << kdr::Simd::getInstructionSet() << "\",\n";
+  std::cout << "  \"sincosMaxError\": " << sinCosError << ",\n";
+  std::cout << "  \"benchmarks\": [\n";
+  for (size_t i = 0; i < results.size(); i++)
+  {
+    const BenchmarkResult& result = results[i];
+    std::cout
+      << "    {\"name\": \"" << result.name << "\""
+      << ", \"operations\": " << result.operations
+      << ", \"nsPerOp\": " << std::setprecision(6) << result.seconds * 1e9 / result.operations
+      << ", \"opsPerSecond\": " << std::setprecision(6) << result.operations / result.seconds
+      << "}" << (i + 1 < results.size() ? "," : "") << '\n';
+  }
+  std::cout << "  ]\n";
+  std::cout << "}\n";
+}
+
+int main(int argc, char** argv)
+{
+  bool isJson {false};
+  double minTime {DEFAULT_MIN_TIME};
+  std::string filter;
+  for (int i = 1; i < argc; i++)
+  {
+    if (std::strcmp(argv[i], "--json") == 0)
+    {
+      isJson = true;
+    }
+    else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc)
+    {
+      minTime = std::atof(argv[++i]);
+    }
+    else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+    {
+      filter = argv[++i];
+    }
+    else
+    {
+      std::cerr << "Usage: " << argv[0] << " [--json] [--min-time seconds] [--filter substring]\n";
+      return 1;
+    }
+  }
+
+  std::mt19937 engine(42);
+  std::uniform_real_distribution<float> distribution(-10.f, 10.f);
+  const unsigned int threadCount = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+
+  // Single operation inputs
+  kdr::Space::Mat4 matA = randomMatrix(engine);
+  kdr::Space::Mat4 matB = randomMatrix(engine);
+  kdr::Space::Affine3x4 affineA(matA);
+  kdr::Space::Affine3x4 affineB(matB);
+  kdr::Space::Vec3 vecA(distribution(engine), distribution(engine), distribution(engine));
+  kdr::Space::Vec3 vecB(distribution(engine), distribution(engine), distribution(engine));
+  kdr::Space::Vec4 vec4(distribution(engine), distribution(engine), distribution(engine), 1.f);
+  kdr::Space::Quat quat = kdr::Space::angleAxis(kdr::Space::normalize(vecA), distribution(engine));
+  float angle = distribution(engine);
+
+  // Batch inputs
+  std::vector<kdr::Space::Mat4> lhs(BATCH_SIZE);
+  std::vector<kdr::Space::Mat4> rhs(BATCH_SIZE);
+  std::vector<kdr::Space::Mat4> batchResult(BATCH_SIZE);
+  std::vector<float> xs(BATCH_SIZE);
+  std::vector<float> ys(BATCH_SIZE);
+  std::vector<float> zs(BATCH_SIZE);
+  std::vector<float> radii(BATCH_SIZE);
+  std::vector<float> outXs(BATCH_SIZE);
+  std::vector<float> outYs(BATCH_SIZE);
+  std::vector<float> outZs(BATCH_SIZE);
+  std::vector<unsigned char> visible(BATCH_SIZE);
+  std::vector<float> angles(BATCH_SIZE);
+  std::vector<float> sines(BATCH_SIZE);
+  std::vector<float> cosines(BATCH_SIZE);
+  for (size_t i = 0; i < BATCH_SIZE; i++)
+  {
+    lhs[i] = randomMatrix(engine);
+    rhs[i] = randomMatrix(engine);
+    xs[i] = distribution(engine);
+    ys[i] = distribution(engine);
+    zs[i] = distribution(engine);
+    radii[i] = distribution(engine) * 0.1f + 1.f;
+    angles[i] = distribution(engine) * 36.f;
+  }
+  const kdr::Space::Mat4 cameraMatrix =
+    kdr::Space::perspective(60.f, 4.f / 3.f, 0.1f, 100.f) *
+    kdr::Space::lookAt({0.f, 0.f, 5.f}, {0.f, 0.f, 0.f}, {0.f, 1.f, 0.f});
+  const kdr::Culling::Frustum frustum(cameraMatrix);
+
+  std::vector<BenchmarkResult> results;
+  auto run = [&](const std::string& name, const size_t operationsPerCall, auto function)
+  {
+    if (filter.empty() || name.find(filter) != std::string::npos)
+    {
+      results.push_back(runBenchmark(name, operationsPerCall, minTime, function));
+    }
+  };
+
+  // Single operations
+  run("Mat4::operator*(Mat4)", 1, [&]()
+  {
+    doNotOptimize(matA);
+    kdr::Space::Mat4 result = matA * matB;
+    doNotOptimize(result);
+  });
+  run("Mat4::operator*(Vec4)", 1, [&]()
+  {
+    doNotOptimize(matA);
+    kdr::Space::Vec4 result = matA * vec4;
+    doNotOptimize(result);
+  });
+  run("Affine3x4::operator*", 1, [&]()
+  {
+    doNotOptimize(affineA);
+    kdr::Space::Affine3x4 result = affineA * affineB;
+    doNotOptimize(result);
+  });
+  run("sincos", 1, [&]()
+  {
+    doNotOptimize(angle);
+    float sine {0.f};
+    float cosine {0.f};
+    kdr::Space::sincos(angle, sine, cosine);
+    doNotOptimize(sine);
+    doNotOptimize(cosine);
+  });
+  run("rotate", 1, [&]()
+  {
+    doNotOptimize(angle);
+    kdr::Space::Mat4 result = kdr::Space::rotate(matA, vecA, angle);
+    doNotOptimize(result);
+  });
+  for (const kdr::Space::TrigMode trigMode : {kdr::Space::TrigMode::Exact, kdr::Space::TrigMode::Fast})
+  {
+    const std::string suffix = trigMode == kdr::Space::TrigMode::Fast ? " (fast)" : " (exact)";
+    kdr::Space::setTrigMode(trigMode);
+    run("sincos batch" + suffix, BATCH_SIZE, [&]()
+    {
+      kdr::Space::sincos(angles.data(), sines.data(), cosines.data(), BATCH_SIZE);
+      doNotOptimize(sines[0]);
+    });
+    run("rotateMatrices" + suffix, BATCH_SIZE, [&]()
+    {
+      kdr::Space::rotateMatrices(lhs.data(), vecA, angles.data(), batchResult.data(), BATCH_SIZE);
+      doNotOptimize(batchResult[0]);
+    });
+  }
+  kdr::Space::setTrigMode(kdr::Space::TrigMode::Exact);
+  run("translate", 1, [&]()
+  {
+    doNotOptimize(vecA);
+    kdr::Space::Mat4 result = kdr::Space::translate(matA, vecA);
+    doNotOptimize(result);
+  });
+  run("lookAt", 1, [&]()
+  {
+    doNotOptimize(vecA);
+    kdr::Space::Mat4 result = kdr::Space::lookAt(vecA, vecB, {0.f, 1.f, 0.f});
+    doNotOptimize(result);
+  });
+  run("perspective", 1, [&]()
+  {
+    doNotOptimize(angle);
+    kdr::Space::Mat4 result = kdr::Space::perspective(angle, 4.f / 3.f, 0.1f, 100.f);
+    doNotOptimize(result);
+  });
+  run("normalize(Vec3)", 1, [&]()
+  {
+    doNotOptimize(vecA);
+    kdr::Space::Vec3 result = kdr::Space::normalize(vecA);
+    doNotOptimize(result);
+  });
+  run("cross", 1, [&]()
+  {
+    doNotOptimize(vecA);
+    kdr::Space::Vec3 result = kdr::Space::cross(vecA, vecB);
+    doNotOptimize(result);
+  });
+  run("compose", 1, [&]()
+  {
+    doNotOptimize(quat);
+    kdr::Space::Mat4 result = kdr::Space::compose(vecA, quat, vecB);
+    doNotOptimize(result);
+  });
+  run("inverse(Mat4)", 1, [&]()
+  {
+    doNotOptimize(matA);
+    kdr::Space::Mat4 result = kdr::Space::inverse(matA);
+    doNotOptimize(result);
+  });
+  run("inverse(Affine3x4)", 1, [&]()
+  {
+    doNotOptimize(affineA);
+    kdr::Space::Affine3x4 result = kdr::Space::inverse(affineA);
+    doNotOptimize(result);
+  });
+
+  // Batched operations
+  run("composeMatrices", BATCH_SIZE, [&]()
+  {
+    kdr::Space::composeMatrices(lhs.data(), rhs.data(), batchResult.data(), BATCH_SIZE);
+    doNotOptimize(batchResult[0]);
+  });
+  run("composeMatrices (threaded)", BATCH_SIZE, [&]()
+  {
+    kdr::Space::composeMatrices(lhs.data(), rhs.data(), batchResult.data(), BATCH_SIZE, threadCount);
+    doNotOptimize(batchResult[0]);
+  });
+  run("multiplyMatrices", BATCH_SIZE, [&]()
+  {
+    kdr::Space::multiplyMatrices(matA, rhs.data(), batchResult.data(), BATCH_SIZE);
+    doNotOptimize(batchResult[0]);
+  });
+  run("translateMatrices", BATCH_SIZE, [&]()
+  {
+    kdr::Space::translateMatrices(lhs.data(), xs.data(), ys.data(), zs.data(), batchResult.data(), BATCH_SIZE);
+    doNotOptimize(batchResult[0]);
+  });
+  run("transformPoints", BATCH_SIZE, [&]()
+  {
+    kdr::Space::transformPoints(matA, xs.data(), ys.data(), zs.data(), outXs.data(), outYs.data(), outZs.data(), BATCH_SIZE);
+    doNotOptimize(outXs[0]);
+  });
+  run("Culling::testSpheres", BATCH_SIZE, [&]()
+  {
+    kdr::Culling::testSpheres(frustum, xs.data(), ys.data(), zs.data(), radii.data(), BATCH_SIZE, visible.data());
+    doNotOptimize(visible[0]);
+  });
+
+  const double sinCosError = measureSinCosError();
+  if (isJson)
+  {
+    printJson(results, sinCosError);
+  }
+  else
+  {
+    printTable(results, sinCosError);
+  }
+
+  if (sinCosError > kdr::Simd::SINCOS_MAX_ERROR)
+  {
+    std::cerr << "Fast sincos exceeds its error bound!\n";
+    return 1;
+  }
+  return 0;
+}
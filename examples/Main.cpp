@@ -84,14 +84,19 @@ class MainWindow : public kdr::Window::Window
   public:
     ~MainWindow()
     {
-      defaultShader.Delete();
-      emeraldTexture.Delete();
+      instancedShader.Delete();
+      this->getTextureCache().release(this->emeraldTexture);
     }
 
     void initialize()
     {
       kdr::Graphics::setPointSize(5.f);
       kdr::Graphics::setLineWidth(2.f);
+      this->emeraldTexture = this->getTextureCache().acquire(
+        "resources/Textures/emerald.png",
+        kdr::Graphics::TextureSampling(),
+        kdr::Compression::Format::BC1
+      );
 
       kdr::Solids::Octahedron* octahedron;
       for (int z = 0; z < 10; z++)
@@ -156,27 +161,27 @@ class MainWindow : public kdr::Window::Window
     
     void render()
     {
-      this->bindShader(this->defaultShader);
-      this->bindTexture(this->emeraldTexture);
-
-      for (kdr::Solids::Octahedron* octahedron : this->octahedrons)
+      if (!this->instancedShader.getIsReady())
       {
-        this->renderSolid(*octahedron);
+        return;
       }
+
+      this->bindShader(this->instancedShader);
+      this->bindTexture(this->getTextureCache().getTexture(this->emeraldTexture));
+
+      this->cullSolids(this->octahedrons, this->visibleOctahedrons);
+      this->renderSolidsInstanced(this->visibleOctahedrons);
     }
 
   private:
-    kdr::Graphics::Shader defaultShader { 
-      "resources/Shaders/default.vert",
+    kdr::Graphics::Shader instancedShader {
+      this->getShaderCompiler(),
+      "resources/Shaders/instanced.vert",
       "resources/Shaders/default.frag"
     };
-    kdr::Graphics::Texture emeraldTexture {
-      "resources/Textures/emerald.png",
-      GL_TEXTURE_2D,
-      GL_TEXTURE0,
-      GL_UNSIGNED_BYTE
-    };
+    size_t emeraldTexture {0};
     std::vector<kdr::Solids::Octahedron*> octahedrons;
+    std::vector<kdr::Solids::Octahedron*> visibleOctahedrons;
     bool canMaximize {true};
 };
 
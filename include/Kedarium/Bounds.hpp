@@ -0,0 +1,155 @@
+#ifndef KDR_BOUNDS_HPP
+#define KDR_BOUNDS_HPP
+
+#include "Space.hpp"
+
+namespace kdr
+{
+  /**
+   * @namespace Bounds
+   * @brief Contains bounding volumes and functions for moving them between spaces.
+   *
+   * This namespace provides axis-aligned bounding boxes and bounding spheres, which are the
+   * foundation for culling, picking, and broadphase queries.
+   */
+  namespace Bounds
+  {
+    /**
+     * @class Box
+     * @brief Represents an axis-aligned bounding box.
+     */
+    class Box
+    {
+      public:
+        /**
+         * @brief Constructs an empty box at the origin.
+         */
+        constexpr Box()
+        : min(0.f), max(0.f)
+        {}
+        /**
+         * @brief Constructs a box from its minimum and maximum corners.
+         *
+         * @param min The minimum corner of the box.
+         * @param max The maximum corner of the box.
+         */
+        constexpr Box(const kdr::Space::Vec3& min, const kdr::Space::Vec3& max)
+        : min(min), max(max)
+        {}
+
+        kdr::Space::Vec3 min;
+        kdr::Space::Vec3 max;
+
+        /**
+         * @brief Gets the center of the box.
+         *
+         * @return The point halfway between the corners.
+         */
+        constexpr kdr::Space::Vec3 getCenter() const
+        { return (this->min + this->max) * 0.5f; }
+        /**
+         * @brief Gets the half extents of the box.
+         *
+         * @return The distance from the center to the maximum corner along each axis.
+         */
+        constexpr kdr::Space::Vec3 getExtents() const
+        { return (this->max - this->min) * 0.5f; }
+    };
+
+    /**
+     * @class Sphere
+     * @brief Represents a bounding sphere.
+     */
+    class Sphere
+    {
+      public:
+        /**
+         * @brief Constructs an empty sphere at the origin.
+         */
+        constexpr Sphere()
+        : center(0.f), radius(0.f)
+        {}
+        /**
+         * @brief Constructs a sphere from its center and radius.
+         *
+         * @param center The center of the sphere.
+         * @param radius The radius of the sphere.
+         */
+        constexpr Sphere(const kdr::Space::Vec3& center, const float radius)
+        : center(center), radius(radius)
+        {}
+
+        kdr::Space::Vec3 center;
+        float radius;
+    };
+
+    /**
+     * @brief Transforms a box and returns the axis-aligned box enclosing the result.
+     *
+     * This function uses Arvo's method: the new extents are the old extents multiplied by the
+     * absolute upper 3x3 part of the matrix, so no corners have to be transformed.
+     *
+     * @param mat The affine transformation matrix.
+     * @param box The box to transform.
+     * @return The enclosing axis-aligned box in the target space.
+     */
+    constexpr kdr::Bounds::Box transform(const kdr::Space::Mat4& mat, const kdr::Bounds::Box& box)
+    {
+      const kdr::Space::Vec3 center  = box.getCenter();
+      const kdr::Space::Vec3 extents = box.getExtents();
+      float newCenter[3] {};
+      float newExtents[3] {};
+      for (int r = 0; r < 3; r++)
+      {
+        newCenter[r] = mat[0][r] * center.x + mat[1][r] * center.y + mat[2][r] * center.z + mat[3][r];
+        newExtents[r] =
+          (mat[0][r] < 0.f ? -mat[0][r] : mat[0][r]) * extents.x +
+          (mat[1][r] < 0.f ? -mat[1][r] : mat[1][r]) * extents.y +
+          (mat[2][r] < 0.f ? -mat[2][r] : mat[2][r]) * extents.z;
+      }
+      return kdr::Bounds::Box(
+        {newCenter[0] - newExtents[0], newCenter[1] - newExtents[1], newCenter[2] - newExtents[2]},
+        {newCenter[0] + newExtents[0], newCenter[1] + newExtents[1], newCenter[2] + newExtents[2]}
+      );
+    }
+    /**
+     * @brief Transforms a sphere and returns a sphere enclosing the result.
+     *
+     * The radius is scaled by the longest axis of the matrix, so non-uniform scales stay conservative.
+     *
+     * @param mat The affine transformation matrix.
+     * @param sphere The sphere to transform.
+     * @return The enclosing sphere in the target space.
+     */
+    constexpr kdr::Bounds::Sphere transform(const kdr::Space::Mat4& mat, const kdr::Bounds::Sphere& sphere)
+    {
+      float maxLengthSquared {0.f};
+      for (int c = 0; c < 3; c++)
+      {
+        const float lengthSquared = mat[c][0] * mat[c][0] + mat[c][1] * mat[c][1] + mat[c][2] * mat[c][2];
+        maxLengthSquared = lengthSquared > maxLengthSquared ? lengthSquared : maxLengthSquared;
+      }
+      const kdr::Space::Vec4 center = mat * kdr::Space::Vec4(sphere.center, 1.f);
+      return kdr::Bounds::Sphere(
+        {center.x, center.y, center.z},
+        sphere.radius * kdr::Space::sqrt(maxLengthSquared)
+      );
+    }
+    /**
+     * @brief Calculates the sphere enclosing a box.
+     *
+     * @param box The box to enclose.
+     * @return The sphere centered on the box that touches its corners.
+     */
+    constexpr kdr::Bounds::Sphere enclose(const kdr::Bounds::Box& box)
+    {
+      const kdr::Space::Vec3 extents = box.getExtents();
+      return kdr::Bounds::Sphere(
+        box.getCenter(),
+        kdr::Space::sqrt(extents.x * extents.x + extents.y * extents.y + extents.z * extents.z)
+      );
+    }
+  }
+}
+
+#endif // KDR_BOUNDS_HPP
@@ -6,6 +6,7 @@
 
 #include "Keys.hpp"
 #include "Space.hpp"
+#include "Graphics.hpp"
 
 namespace kdr
 {
@@ -38,6 +39,27 @@ namespace kdr
     {}
   };
 
+  /**
+   * @brief Mirrors the std140 layout of the camera uniform block.
+   *
+   * Matches the following block, which shaders declare to read the camera:
+   *
+   *     layout (std140) uniform Camera
+   *     {
+   *       mat4 view;
+   *       mat4 projection;
+   *       mat4 viewProjection;
+   *       vec4 position;
+   *     } camera;
+   */
+  struct CameraUniforms
+  {
+    kdr::Space::Mat4 view;
+    kdr::Space::Mat4 projection;
+    kdr::Space::Mat4 viewProjection;
+    kdr::Space::Vec4 position;
+  };
+
   /**
    * @brief Represents a camera in a 3D scene.
    */
@@ -118,6 +140,41 @@ namespace kdr
        */
       float getSensitivity() const
       { return this->sensitivity; }
+      /**
+       * @brief Gets the camera matrix.
+       *
+       * @return The combined projection and view matrix computed by the last updateMatrix() call.
+       */
+      const kdr::Space::Mat4& getMatrix() const
+      { return this->matrix; }
+      /**
+       * @brief Gets the view matrix.
+       *
+       * @return The view matrix computed by the last updateMatrix() call.
+       */
+      const kdr::Space::Mat4& getView() const
+      { return this->view; }
+      /**
+       * @brief Gets the projection matrix.
+       *
+       * @return The projection matrix computed by the last updateMatrix() call.
+       */
+      const kdr::Space::Mat4& getProjection() const
+      { return this->projection; }
+      /**
+       * @brief Gets the position of the camera.
+       *
+       * @return The position of the camera in 3D space.
+       */
+      const kdr::Space::Vec3& getPosition() const
+      { return this->position; }
+      /**
+       * @brief Gets the contents of the camera uniform block.
+       *
+       * @return The view, projection, and view-projection matrices and the camera position.
+       */
+      kdr::CameraUniforms getUniforms() const
+      { return {this->view, this->projection, this->matrix, kdr::Space::Vec4(this->position, 1.f)}; }
 
       /**
        * @brief Updates the keys for camera movement.
@@ -146,18 +203,21 @@ namespace kdr
       /**
        * @brief Applies the camera matrix to a shader.
        *
-       * This function sets the value of the "cameraMatrix" uniform variable in the specified shader
+       * This function sets the camera matrix uniform of the specified shader
        * using the camera's internal camera matrix.
        *
-       * @param shaderID The ID of the shader program.
+       * @param shader The shader program.
+       * @param uniform The handle of the camera matrix uniform.
        */
-      void applyMatrix(GLuint shaderID);
+      void applyMatrix(kdr::Graphics::Shader& shader, const GLint uniform);
 
     private:
       kdr::Space::Vec3 position {0.f};
       kdr::Space::Vec3 up       {0.f, 1.f, 0.f};
       kdr::Space::Vec3 front    {0.f, 0.f, -1.f};
-      kdr::Space::Mat4 matrix   {1.f};
+      kdr::Space::Mat4 view       {1.f};
+      kdr::Space::Mat4 projection {1.f};
+      kdr::Space::Mat4 matrix     {1.f};
 
       float fov;
       float aspect;
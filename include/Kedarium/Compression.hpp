@@ -0,0 +1,135 @@
+#ifndef KDR_COMPRESSION_HPP
+#define KDR_COMPRESSION_HPP
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace kdr
+{
+  /**
+   * @namespace Compression
+   * @brief Contains the block compression encoder and the compressed texture cache.
+   *
+   * This namespace encodes 8-bit RGBA images into GPU block-compressed formats on the CPU and
+   * stores the results on disk, so each PNG is only encoded once.
+   */
+  namespace Compression
+  {
+    /**
+     * @brief The directory compressed textures are cached in by default.
+     */
+    constexpr const char* DEFAULT_CACHE_DIRECTORY {".kdrcache"};
+
+    /**
+     * @enum Format
+     * @brief Lists the formats textures can be stored in on the GPU.
+     */
+    enum class Format
+    {
+      None, ///< Uncompressed 8-bit RGBA, 4 bytes per texel.
+      BC1,  ///< Opaque RGB (DXT1), 0.5 bytes per texel.
+      BC3   ///< RGB with smooth alpha (DXT5), 1 byte per texel.
+    };
+
+    /**
+     * @struct CompressedImage
+     * @brief Holds a block-compressed image with its mipmap chain.
+     */
+    struct CompressedImage
+    {
+      kdr::Compression::Format format {kdr::Compression::Format::None};
+      GLsizei width {0};
+      GLsizei height {0};
+      std::vector<std::vector<GLubyte>> levels;
+    };
+
+    /**
+     * @brief Gets the OpenGL internal format of a compressed format.
+     *
+     * @param format The compressed format.
+     * @return The internal format, or GL_RGBA8 for kdr::Compression::Format::None.
+     */
+    GLenum getInternalFormat(const kdr::Compression::Format format);
+    /**
+     * @brief Gets the size of a 4x4 block of a compressed format.
+     *
+     * @param format The compressed format.
+     * @return The size (in bytes) of one block, or 0 for kdr::Compression::Format::None.
+     */
+    size_t getBlockSize(const kdr::Compression::Format format);
+    /**
+     * @brief Checks whether the current OpenGL context can sample a format.
+     *
+     * @param format The format to check.
+     * @return True if textures can be uploaded in the format, false otherwise.
+     */
+    bool isSupported(const kdr::Compression::Format format);
+
+    /**
+     * @brief Encodes one 4x4 block as BC1.
+     *
+     * The endpoints are the extremes of the block's colors along their principal axis, and
+     * every texel picks the nearest of the four palette colors. Alpha is ignored.
+     *
+     * @param texels The 16 texels of the block as 8-bit RGBA, row by row.
+     * @param block The 8 bytes receiving the block.
+     */
+    void encodeBC1Block(const GLubyte texels[64], GLubyte block[8]);
+    /**
+     * @brief Encodes one 4x4 block as BC3.
+     *
+     * The color is encoded like encodeBC1Block() and the alpha between the block's extremes
+     * in eight steps.
+     *
+     * @param texels The 16 texels of the block as 8-bit RGBA, row by row.
+     * @param block The 16 bytes receiving the block.
+     */
+    void encodeBC3Block(const GLubyte texels[64], GLubyte block[16]);
+    /**
+     * @brief Encodes an image into a compressed format.
+     *
+     * Blocks reaching past the edges of the image repeat its last row and column.
+     *
+     * @param rgba The width * height * 4 bytes of the image.
+     * @param width The width of the image.
+     * @param height The height of the image.
+     * @param format The compressed format, BC1 or BC3.
+     * @return The blocks of the image, row by row.
+     */
+    std::vector<GLubyte> encode(const GLubyte* rgba, const GLsizei width, const GLsizei height, const kdr::Compression::Format format);
+    /**
+     * @brief Encodes an image and its mipmap chain into a compressed format.
+     *
+     * The mipmaps are box filtered from the image on the CPU, since OpenGL cannot generate
+     * mipmaps of compressed textures.
+     *
+     * @param rgba The width * height * 4 bytes of the image.
+     * @param width The width of the image.
+     * @param height The height of the image.
+     * @param format The compressed format, BC1 or BC3.
+     * @param image The image receiving every mipmap level.
+     */
+    void encodeMipmaps(const GLubyte* rgba, const GLsizei width, const GLsizei height, const kdr::Compression::Format format, kdr::Compression::CompressedImage& image);
+
+    /**
+     * @brief Loads a PNG file as a compressed image, encoding it only if the cache is stale.
+     *
+     * Cached files record the size, modification time, and hash of their source. A cached
+     * file is used if the size and time still match, or else if the hash of the source still
+     * matches. Otherwise the PNG is decoded and encoded again and the cached file replaced.
+     * This function does not call OpenGL and can run on any thread.
+     *
+     * @param pngPath The path to the PNG file.
+     * @param format The compressed format, BC1 or BC3.
+     * @param cacheDirectory The directory the compressed files are cached in.
+     * @param image The image receiving every mipmap level.
+     * @return True if the image is loaded, false otherwise.
+     */
+    bool loadPng(const std::string& pngPath, const kdr::Compression::Format format, const std::string& cacheDirectory, kdr::Compression::CompressedImage& image);
+  }
+}
+
+#endif // KDR_COMPRESSION_HPP
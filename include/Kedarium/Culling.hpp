@@ -0,0 +1,107 @@
+#ifndef KDR_CULLING_HPP
+#define KDR_CULLING_HPP
+
+#include <cstddef>
+
+#include "Space.hpp"
+
+namespace kdr
+{
+  /**
+   * @namespace Culling
+   * @brief Contains classes and functions for skipping objects that cannot be seen.
+   *
+   * This namespace provides the view frustum and batched visibility tests for bounding
+   * spheres and axis-aligned bounding boxes.
+   */
+  namespace Culling
+  {
+    /**
+     * @class Frustum
+     * @brief Represents the six clipping planes of a camera's view volume.
+     *
+     * The planes are stored as (a, b, c, d) with unit normals pointing inside, so a point p
+     * is inside a plane when a * p.x + b * p.y + c * p.z + d >= 0.
+     */
+    class Frustum
+    {
+      public:
+        /**
+         * @brief Constructs a frustum that contains everything.
+         */
+        Frustum();
+        /**
+         * @brief Extracts the frustum planes from a camera matrix.
+         *
+         * This constructor uses the Gribb-Hartmann method on a projection * view matrix
+         * laid out for glUniformMatrix4fv(..., GL_FALSE, ...), producing world-space planes.
+         *
+         * @param matrix The combined projection and view matrix.
+         */
+        Frustum(const kdr::Space::Mat4& matrix);
+
+        /**
+         * @brief Gets the planes of the frustum.
+         *
+         * The planes are ordered left, right, bottom, top, near, far.
+         *
+         * @return A pointer to the 24 floats of the planes.
+         */
+        const float* getPlanes() const
+        { return &this->planes[0][0]; }
+
+        /**
+         * @brief Checks whether a bounding sphere is at least partially inside the frustum.
+         *
+         * @param center The center of the sphere.
+         * @param radius The radius of the sphere.
+         * @return True if the sphere may be visible, false if it is completely outside.
+         */
+        bool intersectsSphere(const kdr::Space::Vec3& center, const float radius) const;
+        /**
+         * @brief Checks whether an axis-aligned bounding box is at least partially inside the frustum.
+         *
+         * @param min The minimum corner of the box.
+         * @param max The maximum corner of the box.
+         * @return True if the box may be visible, false if it is completely outside.
+         */
+        bool intersectsBox(const kdr::Space::Vec3& min, const kdr::Space::Vec3& max) const;
+
+      private:
+        float planes[6][4];
+    };
+
+    /**
+     * @brief Tests structure-of-arrays bounding spheres against a frustum.
+     *
+     * The spheres are tested 8 (AVX) or 4 (SSE) at a time.
+     *
+     * @param frustum The frustum to test against.
+     * @param xs The x components of the sphere centers.
+     * @param ys The y components of the sphere centers.
+     * @param zs The z components of the sphere centers.
+     * @param radii The sphere radii.
+     * @param count The number of spheres.
+     * @param results The bytes receiving 1 for every visible sphere and 0 otherwise.
+     */
+    void testSpheres(const kdr::Culling::Frustum& frustum, const float* xs, const float* ys, const float* zs, const float* radii, const size_t count, unsigned char* results);
+    /**
+     * @brief Tests structure-of-arrays axis-aligned bounding boxes against a frustum.
+     *
+     * The boxes are tested 8 (AVX) or 4 (SSE) at a time.
+     *
+     * @param frustum The frustum to test against.
+     * @param minXs The x components of the minimum corners.
+     * @param minYs The y components of the minimum corners.
+     * @param minZs The z components of the minimum corners.
+     * @param maxXs The x components of the maximum corners.
+     * @param maxYs The y components of the maximum corners.
+     * @param maxZs The z components of the maximum corners.
+     * @param count The number of boxes.
+     * @param results The bytes receiving 1 for every visible box and 0 otherwise.
+     */
+    void testBoxes(const kdr::Culling::Frustum& frustum, const float* minXs, const float* minYs, const float* minZs, const float* maxXs, const float* maxYs, const float* maxZs, const size_t count, unsigned char* results);
+  }
+}
+
+#endif // KDR_CULLING_HPP
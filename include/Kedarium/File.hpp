@@ -28,6 +28,16 @@ namespace kdr
      * @return The contents of the file as a string. An empty string if the file cannot be opened or read.
      */
     std::string getContents(const std::string& path);
+    /**
+     * @brief Builds a unique path to write a file to before renaming it into place.
+     *
+     * The name combines a per-process random token, the calling thread, and a counter, so
+     * threads and processes writing the same file at once never share a temporary file.
+     *
+     * @param path The path of the file being written.
+     * @return The path of a temporary file next to it.
+     */
+    std::string getTemporaryPath(const std::string& path);
   };
 }
 
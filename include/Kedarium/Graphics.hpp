@@ -2,10 +2,22 @@
 #define KDR_GRAPHICS_HPP
 
 #include <GL/glew.h>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
+#include "Compression.hpp"
 #include "File.hpp"
 #include "Image.hpp"
+#include "Space.hpp"
+#include "State.hpp"
 
 namespace kdr
 {
@@ -22,17 +34,17 @@ namespace kdr
      * @brief Sets the OpenGL polygon mode to point mode.
      */
     inline void usePointMode()
-    { glPolygonMode(GL_FRONT_AND_BACK, GL_POINT); }
+    { kdr::State::getCache().setPolygonMode(GL_POINT); }
     /**
      * @brief Sets the OpenGL polygon mode to line mode.
      */
     inline void useLineMode()
-    { glPolygonMode(GL_FRONT_AND_BACK, GL_LINE); }
+    { kdr::State::getCache().setPolygonMode(GL_LINE); }
     /**
      * @brief Sets the OpenGL polygon mode to fill mode.
      */
     inline void useFillMode()
-    { glPolygonMode(GL_FRONT_AND_BACK, GL_FILL); }
+    { kdr::State::getCache().setPolygonMode(GL_FILL); }
 
     /**
      * @brief Sets the size of points when rendering in point mode.
@@ -49,292 +61,1785 @@ namespace kdr
     inline void setLineWidth(const float width)
     { glLineWidth(width); }
 
+    /**
+     * @struct ShaderVariable
+     * @brief Describes an active uniform or vertex attribute of a linked shader program.
+     */
+    struct ShaderVariable
+    {
+      std::string name;
+      GLint location;
+      GLenum type;
+      GLint size;
+    };
+
+    /**
+     * @brief The number of bytes of the shadow copy kept for every uniform (enough for a mat4).
+     */
+    constexpr size_t UNIFORM_SHADOW_SIZE {64};
+
+    /**
+     * @brief The name of the std140 uniform block holding the camera matrices.
+     */
+    inline const std::string CAMERA_BLOCK_NAME {"Camera"};
+    /**
+     * @brief The uniform buffer binding point of the camera block, shared by every shader.
+     */
+    constexpr GLuint CAMERA_BLOCK_BINDING {0};
+
+    /**
+     * @brief The directory linked program binaries are cached in by default.
+     */
+    constexpr const char* DEFAULT_PROGRAM_CACHE_DIRECTORY {".kdrcache/programs"};
+
+    /**
+     * @brief Gets the directory linked program binaries are cached in.
+     *
+     * @return The cache directory, or an empty string if program binaries are not cached.
+     */
+    const std::string& getProgramCacheDirectory();
+    /**
+     * @brief Sets the directory linked program binaries are cached in.
+     *
+     * Only shaders constructed afterwards are affected.
+     *
+     * @param directory The cache directory, or an empty string to always compile from source.
+     */
+    void setProgramCacheDirectory(const std::string& directory);
+
+    /**
+     * @brief The compiler thread count that lets the driver choose, see glMaxShaderCompilerThreadsKHR.
+     */
+    constexpr GLuint DEFAULT_SHADER_COMPILER_THREAD_COUNT {0xffffffff};
+
+    /**
+     * @brief The first attribute location of the per-instance model matrix (one per column).
+     */
+    constexpr GLuint INSTANCE_MODEL_LOCATION {3};
+    /**
+     * @brief The attribute location of the per-instance color.
+     */
+    constexpr GLuint INSTANCE_COLOR_LOCATION {7};
+    /**
+     * @brief The attribute location of the per-instance texture rectangle.
+     */
+    constexpr GLuint INSTANCE_TEXTURE_RECT_LOCATION {8};
+    /**
+     * @brief The attribute location of the per-instance texture array layer.
+     */
+    constexpr GLuint INSTANCE_TEXTURE_LAYER_LOCATION {9};
+    /**
+     * @brief The gap (in pixels) around every image in a texture atlas, filled with its edge pixels.
+     */
+    constexpr GLsizei ATLAS_PADDING {1};
+
+    /**
+     * @struct TextureRegion
+     * @brief Selects the part of a texture array or atlas an instance samples.
+     *
+     * The texture coordinates of a mesh are mapped to (u, v) + texCoord * (width, height)
+     * in the given layer. The default covers a whole texture in layer 0, so meshes look the
+     * same as with a plain texture. The layout matches the per-instance attributes read at
+     * kdr::Graphics::INSTANCE_TEXTURE_RECT_LOCATION and INSTANCE_TEXTURE_LAYER_LOCATION.
+     */
+    struct TextureRegion
+    {
+      GLfloat u {0.f};
+      GLfloat v {0.f};
+      GLfloat width {1.f};
+      GLfloat height {1.f};
+      GLfloat layer {0.f};
+    };
+
+    /**
+     * @struct DrawElementsIndirectCommand
+     * @brief Mirrors the command layout read by glMultiDrawElementsIndirect.
+     */
+    struct DrawElementsIndirectCommand
+    {
+      GLuint count;
+      GLuint instanceCount;
+      GLuint firstIndex;
+      GLint baseVertex;
+      GLuint baseInstance;
+    };
+
+    class ShaderCompiler;
+
     /**
      * @class Shader
      * @brief Represents a shader program for use in graphics rendering.
      *
      * The Shader class encapsulates the functionality for creating, managing, and using
      * shader programs in OpenGL graphics rendering.
+     *
+     * All active uniforms and attributes are queried once after linking. Uniforms are then set
+     * through integer handles from getUniformHandle(), and a shadow copy of every value skips
+     * glUniform calls that would not change anything. A setter that changes a value makes the
+     * program current first, so the value never lands in another program.
+     *
+     * A uniform block named kdr::Graphics::CAMERA_BLOCK_NAME is linked to
+     * kdr::Graphics::CAMERA_BLOCK_BINDING automatically, so every program reads the camera
+     * buffer the window uploads once per frame.
+     *
+     * Linked programs are cached on disk with glGetProgramBinary when the driver supports it.
+     * The cache is keyed by a hash of the sources, the defines, and the OpenGL vendor,
+     * renderer, and version, so editing a shader or updating the driver compiles it again.
+     *
+     * Shaders constructed with a kdr::Graphics::ShaderCompiler return as soon as their
+     * compilation is issued and become ready over the following frames. A shader that is not
+     * ready yet has no uniforms or attributes, and Use() waits for it to finish.
      */
     class Shader
     {
       public: 
         /**
-         * @brief Constructs a Shader object by loading and compiling shader source code.
+         * @brief Constructs a Shader object by loading and compiling shader source code.
+         *
+         * This constructor loads and compiles the vertex and fragment shaders specified
+         * by the provided file paths. It links the shaders into a program, and the program ID
+         * can be retrieved using the getID() method. A cached program binary is used instead
+         * if one matches, and the sources are compiled if the driver rejects it.
+         *
+         * @param vertexPath   The file path to the vertex shader source code.
+         * @param fragmentPath The file path to the fragment shader source code.
+         * @param defines      The macros defined in both shaders, as "NAME" or "NAME VALUE".
+         */
+        Shader(const std::string& vertexPath, const std::string& fragmentPath, const std::vector<std::string>& defines = {});
+        /**
+         * @brief Constructs a Shader object whose compilation finishes in the background.
+         *
+         * This constructor issues the compilation and linking of the shaders without waiting
+         * for them, and hands the program to the compiler, which checks on it every
+         * ShaderCompiler::Update(). A matching cached program binary makes the shader ready
+         * immediately. The shader must not outlive the compiler while it is pending.
+         *
+         * @param compiler     The compiler finishing the program.
+         * @param vertexPath   The file path to the vertex shader source code.
+         * @param fragmentPath The file path to the fragment shader source code.
+         * @param defines      The macros defined in both shaders, as "NAME" or "NAME VALUE".
+         */
+        Shader(kdr::Graphics::ShaderCompiler& compiler, const std::string& vertexPath, const std::string& fragmentPath, const std::vector<std::string>& defines = {});
+        /**
+         * @brief Destroys the Shader object.
+         *
+         * The destructor cleans up the OpenGL resources associated with the shader program.
+         */
+        ~Shader();
+
+        /**
+         * @brief Shader objects own their OpenGL program and are tracked by address in a
+         * kdr::Graphics::ShaderCompiler, so they can't be copied.
+         */
+        Shader(const Shader&) = delete;
+        Shader& operator=(const Shader&) = delete;
+
+        /**
+         * @brief Gets the OpenGL ID of the shader program.
+         *
+         * @return The OpenGL ID of the shader program.
+         */
+        GLuint getID() const
+        { return this->ID; }
+        /**
+         * @brief Checks whether the program was loaded from the program binary cache.
+         *
+         * @return True if a cached binary was used, false if the sources were compiled.
+         */
+        bool getIsFromCache() const
+        { return this->isFromCache; }
+        /**
+         * @brief Checks whether the program has finished compiling and linking.
+         *
+         * @return True if the program is ready (linked or failed), false if it is still compiling.
+         */
+        bool getIsReady() const
+        { return this->isReady; }
+
+        /**
+         * @brief Sets this shader as the currently active shader in the OpenGL context.
+         *
+         * A shader that is still compiling is finished first, which blocks until the driver is done.
+         */
+        void Use()
+        {
+          if (!this->isReady)
+          {
+            this->Finish();
+          }
+          kdr::State::getCache().useProgram(this->ID);
+        }
+        /**
+         * @brief Waits for the program to finish compiling and linking.
+         *
+         * Does nothing if the shader is already ready.
+         */
+        void Finish();
+        /**
+         * @brief Deletes the shader program, releasing associated OpenGL resources.
+         *
+         * Deleting a shader twice, including through the destructor, is harmless.
+         */
+        void Delete();
+
+        /**
+         * @brief Gets the active uniforms found when the program was linked.
+         *
+         * @return The active uniforms, indexed by their handles.
+         */
+        const std::vector<kdr::Graphics::ShaderVariable>& getUniforms() const
+        { return this->uniforms; }
+        /**
+         * @brief Gets the active vertex attributes found when the program was linked.
+         *
+         * @return The active vertex attributes.
+         */
+        const std::vector<kdr::Graphics::ShaderVariable>& getAttributes() const
+        { return this->attributes; }
+        /**
+         * @brief Gets the handle of an active uniform.
+         *
+         * Look the handle up once and keep it, since the setters taking a handle involve no string work.
+         *
+         * @param name The name of the uniform. Arrays are named without the "[0]" suffix.
+         * @return The handle of the uniform, or -1 if the program has no such active uniform.
+         */
+        GLint getUniformHandle(const std::string& name) const;
+        /**
+         * @brief Gets the location of an active vertex attribute.
+         *
+         * @param name The name of the attribute.
+         * @return The location of the attribute, or -1 if the program has no such active attribute.
+         */
+        GLint getAttributeLocation(const std::string& name) const;
+
+        /**
+         * @brief Sets an int or sampler uniform.
+         *
+         * @param handle The handle of the uniform. Ignored if -1.
+         * @param value The new value.
+         */
+        void setUniform(const GLint handle, const int value)
+        {
+          if (this->_updateShadow(handle, &value, sizeof(value)))
+          {
+            glUniform1i(this->uniforms[handle].location, value);
+          }
+        }
+        /**
+         * @brief Sets an unsigned int uniform.
+         *
+         * @param handle The handle of the uniform. Ignored if -1.
+         * @param value The new value.
+         */
+        void setUniform(const GLint handle, const unsigned int value)
+        {
+          if (this->_updateShadow(handle, &value, sizeof(value)))
+          {
+            glUniform1ui(this->uniforms[handle].location, value);
+          }
+        }
+        /**
+         * @brief Sets a float uniform.
+         *
+         * @param handle The handle of the uniform. Ignored if -1.
+         * @param value The new value.
+         */
+        void setUniform(const GLint handle, const float value)
+        {
+          if (this->_updateShadow(handle, &value, sizeof(value)))
+          {
+            glUniform1f(this->uniforms[handle].location, value);
+          }
+        }
+        /**
+         * @brief Sets a vec2 uniform.
+         *
+         * @param handle The handle of the uniform. Ignored if -1.
+         * @param value The new value.
+         */
+        void setUniform(const GLint handle, const kdr::Space::Vec2& value)
+        {
+          if (this->_updateShadow(handle, &value, sizeof(value)))
+          {
+            glUniform2f(this->uniforms[handle].location, value.x, value.y);
+          }
+        }
+        /**
+         * @brief Sets a vec3 uniform.
+         *
+         * @param handle The handle of the uniform. Ignored if -1.
+         * @param value The new value.
+         */
+        void setUniform(const GLint handle, const kdr::Space::Vec3& value)
+        {
+          if (this->_updateShadow(handle, &value, sizeof(value)))
+          {
+            glUniform3f(this->uniforms[handle].location, value.x, value.y, value.z);
+          }
+        }
+        /**
+         * @brief Sets a vec4 uniform.
+         *
+         * @param handle The handle of the uniform. Ignored if -1.
+         * @param value The new value.
+         */
+        void setUniform(const GLint handle, const kdr::Space::Vec4& value)
+        {
+          if (this->_updateShadow(handle, &value, sizeof(value)))
+          {
+            glUniform4fv(this->uniforms[handle].location, 1, kdr::Space::valuePointer(value));
+          }
+        }
+        /**
+         * @brief Sets a mat4 uniform.
+         *
+         * @param handle The handle of the uniform. Ignored if -1.
+         * @param value The new value.
+         */
+        void setUniform(const GLint handle, const kdr::Space::Mat4& value)
+        {
+          if (this->_updateShadow(handle, &value, sizeof(value)))
+          {
+            glUniformMatrix4fv(this->uniforms[handle].location, 1, GL_FALSE, kdr::Space::valuePointer(value));
+          }
+        }
+        /**
+         * @brief Sets a mat4x3 uniform from an affine matrix.
+         *
+         * @param handle The handle of the uniform. Ignored if -1.
+         * @param value The new value.
+         */
+        void setUniform(const GLint handle, const kdr::Space::Affine3x4& value)
+        {
+          if (this->_updateShadow(handle, &value, sizeof(value)))
+          {
+            glUniformMatrix4x3fv(this->uniforms[handle].location, 1, GL_TRUE, kdr::Space::valuePointer(value));
+          }
+        }
+        /**
+         * @brief Sets a uniform by name.
+         *
+         * Convenient for values set rarely. Prefer the handle overloads in per-draw code.
+         *
+         * @param name The name of the uniform.
+         * @param value The new value.
+         */
+        template <typename T>
+        void setUniform(const std::string& name, const T& value)
+        { this->setUniform(this->getUniformHandle(name), value); }
+
+      private:
+        GLuint ID;
+        bool isFromCache {false};
+        bool isReady {false};
+
+        kdr::Graphics::ShaderCompiler* compiler {NULL};
+        GLuint vertexShader {0};
+        GLuint fragmentShader {0};
+        std::string cachePath;
+        uint64_t cacheKey {0};
+
+        std::vector<kdr::Graphics::ShaderVariable> uniforms;
+        std::vector<kdr::Graphics::ShaderVariable> attributes;
+        std::unordered_map<std::string, GLint> uniformHandles;
+
+        std::vector<unsigned char> shadowValues;
+        std::vector<unsigned char> shadowFlags;
+
+        /**
+         * @brief Loads the program from the binary cache, or issues its compilation without waiting for it.
+         *
+         * @param vertexPath The file path to the vertex shader source code.
+         * @param fragmentPath The file path to the fragment shader source code.
+         * @param defines The macros defined in both shaders.
+         */
+        void _submit(const std::string& vertexPath, const std::string& fragmentPath, const std::vector<std::string>& defines);
+        /**
+         * @brief Issues the compilation of the shader sources and the linking of the program.
+         *
+         * @param vertexSource The source code of the vertex shader.
+         * @param fragmentSource The source code of the fragment shader.
+         */
+        void _compile(const std::string& vertexSource, const std::string& fragmentSource);
+        /**
+         * @brief Checks whether the driver has finished compiling and linking without waiting for it.
+         *
+         * @return True if querying the results will not block, false otherwise.
+         */
+        bool _isCompleted() const;
+        /**
+         * @brief Collects the results of the compilation and makes the shader ready.
+         *
+         * Reports errors, caches the linked binary, links the camera block, and reflects the
+         * program. Blocks if the driver is still compiling.
+         */
+        void _complete();
+        /**
+         * @brief Releases the shader objects of a pending compilation.
+         */
+        void _releaseShaders();
+        /**
+         * @brief Loads a cached program binary into the program.
+         *
+         * @param cachePath The path of the cached binary.
+         * @param key The hash the cached binary must have been stored with.
+         * @return True if the driver accepts the binary, false otherwise.
+         */
+        bool _loadBinary(const std::string& cachePath, const uint64_t key);
+        /**
+         * @brief Stores the linked program as a binary in the cache.
+         *
+         * @param cachePath The path of the cached binary.
+         * @param key The hash the binary is stored with.
+         */
+        void _saveBinary(const std::string& cachePath, const uint64_t key) const;
+        /**
+         * @brief Queries the active uniforms and attributes of the linked program.
+         */
+        void _reflect();
+        /**
+         * @brief Compares a new uniform value with its shadow copy and stores it.
+         *
+         * Arrays are never shadowed, since only their first element would be compared. A changed
+         * value makes the program current, since glUniform writes to the program in use and the
+         * shadow copy would otherwise skip the value for good.
+         *
+         * @param handle The handle of the uniform.
+         * @param data Pointer to the new value.
+         * @param size The size of the new value in bytes.
+         * @return True if the value has to be uploaded, false if the handle is -1 or the value is unchanged.
+         */
+        bool _updateShadow(const GLint handle, const void* data, const size_t size)
+        {
+          if (handle < 0)
+          {
+            return false;
+          }
+          unsigned char* shadow = &this->shadowValues[handle * kdr::Graphics::UNIFORM_SHADOW_SIZE];
+          if (this->shadowFlags[handle] && std::memcmp(shadow, data, size) == 0)
+          {
+            return false;
+          }
+          std::memcpy(shadow, data, size);
+          this->shadowFlags[handle] = this->uniforms[handle].size == 1;
+          kdr::State::getCache().useProgram(this->ID);
+          return true;
+        }
+
+        friend class ShaderCompiler;
+    };
+
+    /**
+     * @class ShaderCompiler
+     * @brief Finishes shader programs in the background, so many can compile at once.
+     *
+     * Every shader handed to the compiler has its compilation issued right away, and Update()
+     * collects the ones the driver is done with. With GL_KHR_parallel_shader_compile (or
+     * GL_ARB_parallel_shader_compile) the driver compiles on its own threads and Update()
+     * only takes finished programs, polled through GL_COMPLETION_STATUS_KHR. Without it,
+     * Update() finishes one program per call, so a loading screen keeps rendering in between.
+     */
+    class ShaderCompiler
+    {
+      public:
+        /**
+         * @brief Constructs a ShaderCompiler object.
+         *
+         * @param threadCount The number of compiler threads the driver may use, if it supports parallel compilation.
+         */
+        explicit ShaderCompiler(const GLuint threadCount = kdr::Graphics::DEFAULT_SHADER_COMPILER_THREAD_COUNT);
+        /**
+         * @brief Destroys the ShaderCompiler object, finishing every pending shader.
+         */
+        ~ShaderCompiler();
+
+        ShaderCompiler(const ShaderCompiler&) = delete;
+        ShaderCompiler& operator=(const ShaderCompiler&) = delete;
+
+        /**
+         * @brief Makes the shaders the driver has finished ready.
+         *
+         * Call once per frame from the thread owning the OpenGL context.
+         */
+        void Update();
+        /**
+         * @brief Waits for every pending shader to finish.
+         */
+        void Finish();
+
+        /**
+         * @brief Gets the number of shaders that are not ready yet.
+         *
+         * @return The number of pending shaders.
+         */
+        size_t getPendingCount() const
+        { return this->pendingShaders.size(); }
+        /**
+         * @brief Checks whether the driver compiles in parallel and can be polled.
+         *
+         * @return True if GL_KHR_parallel_shader_compile or GL_ARB_parallel_shader_compile is used, false otherwise.
+         */
+        bool getIsParallel() const
+        { return this->isParallel; }
+
+      private:
+        bool isParallel {false};
+        std::vector<kdr::Graphics::Shader*> pendingShaders;
+
+        /**
+         * @brief Starts tracking a shader whose compilation has been issued.
+         *
+         * @param shader The pending shader.
+         */
+        void _add(kdr::Graphics::Shader& shader);
+        /**
+         * @brief Stops tracking a shader.
+         *
+         * @param shader The shader to forget.
+         */
+        void _remove(kdr::Graphics::Shader& shader);
+
+        friend class Shader;
+    };
+
+    /**
+     * @class Pipeline
+     * @brief Represents an immutable bundle of a shader program and the fixed-function state it draws with.
+     *
+     * Binding a pipeline goes through the state cache, so switching between pipelines only
+     * touches the state that actually differs.
+     */
+    class Pipeline
+    {
+      public:
+        /**
+         * @brief Constructs a Pipeline object.
+         *
+         * @param shader The shader program, which must outlive the pipeline.
+         * @param renderState The depth, cull, blend, and polygon mode state.
+         */
+        Pipeline(kdr::Graphics::Shader& shader, const kdr::State::RenderState& renderState)
+        : shader(&shader), renderState(renderState)
+        {}
+
+        /**
+         * @brief Gets the shader program of the pipeline.
+         *
+         * @return The shader program.
+         */
+        kdr::Graphics::Shader& getShader() const
+        { return *this->shader; }
+        /**
+         * @brief Gets the fixed-function state of the pipeline.
+         *
+         * @return The render state.
+         */
+        const kdr::State::RenderState& getRenderState() const
+        { return this->renderState; }
+
+        /**
+         * @brief Makes the pipeline's program and state current.
+         */
+        void Bind() const
+        {
+          this->shader->Use();
+          kdr::State::getCache().apply(this->renderState);
+        }
+
+      private:
+        kdr::Graphics::Shader* const shader;
+        const kdr::State::RenderState renderState;
+    };
+
+    /**
+     * @brief The number of floats per vertex in the source format solids are defined in.
+     *
+     * Source vertices hold a position (3 floats), a color (3 floats), and texture
+     * coordinates (2 floats), and are packed into a kdr::Graphics::VertexFormat for the GPU.
+     */
+    constexpr size_t VERTEX_FLOAT_COUNT {8};
+    /**
+     * @brief The source index marking a primitive restart in EBOs created with primitive restart.
+     */
+    constexpr GLuint PRIMITIVE_RESTART_INDEX {0xffffffff};
+
+    /**
+     * @brief Storage formats for vertex positions.
+     */
+    enum class PositionFormat
+    {
+      Float,   // 3 floats, 12 bytes
+      Half,    // 3 half floats padded to 8 bytes
+      Snorm16, // 3 normalized shorts padded to 8 bytes; positions must lie within [-1, 1]
+    };
+
+    /**
+     * @brief Storage formats for vertex colors.
+     */
+    enum class ColorFormat
+    {
+      None,  // Left out; the shader reads opaque white
+      Float, // 3 floats, 12 bytes
+      RGBA8, // 4 normalized unsigned bytes, 4 bytes
+    };
+
+    /**
+     * @brief Storage formats for vertex texture coordinates.
+     */
+    enum class TexCoordFormat
+    {
+      None,    // Left out; the shader reads (0, 0)
+      Float,   // 2 floats, 8 bytes
+      Unorm16, // 2 normalized unsigned shorts, 4 bytes; coordinates must lie within [0, 1]
+    };
+
+    /**
+     * @struct VertexFormat
+     * @brief Selects how each vertex attribute is stored on the GPU.
+     *
+     * The default packs a vertex into 16 bytes instead of the 32 bytes of the source format.
+     */
+    struct VertexFormat
+    {
+      kdr::Graphics::PositionFormat position {kdr::Graphics::PositionFormat::Half};
+      kdr::Graphics::ColorFormat color {kdr::Graphics::ColorFormat::RGBA8};
+      kdr::Graphics::TexCoordFormat texCoord {kdr::Graphics::TexCoordFormat::Unorm16};
+    };
+
+    /**
+     * @struct VertexAttribute
+     * @brief Describes one attribute of an interleaved vertex.
+     */
+    struct VertexAttribute
+    {
+      GLuint location;
+      GLint size;
+      GLenum type;
+      bool normalized;
+      GLsizeiptr offset;
+    };
+
+    /**
+     * @struct VertexLayout
+     * @brief Describes the attributes and stride of an interleaved vertex, from which a VAO is set up.
+     */
+    struct VertexLayout
+    {
+      std::vector<kdr::Graphics::VertexAttribute> attributes;
+      GLsizei stride {0};
+    };
+
+    /**
+     * @brief Gets the layout of a vertex format.
+     *
+     * Positions, colors, and texture coordinates use the attribute locations 0, 1, and 2.
+     * Attributes left out of the format are left out of the layout.
+     *
+     * @param format The vertex format.
+     * @return The layout of the vertex format.
+     */
+    kdr::Graphics::VertexLayout getVertexLayout(const kdr::Graphics::VertexFormat& format);
+    /**
+     * @brief Packs source vertices into a vertex format.
+     *
+     * @param vertices The source vertices, kdr::Graphics::VERTEX_FLOAT_COUNT floats each.
+     * @param vertexCount The number of vertices.
+     * @param format The vertex format to pack into.
+     * @return The packed vertices, laid out as described by getVertexLayout(format).
+     */
+    std::vector<GLubyte> packVertices(const GLfloat* vertices, const size_t vertexCount, const kdr::Graphics::VertexFormat& format);
+
+    /**
+     * @class VBO
+     * @brief Represents a Vertex Buffer Object (VBO) for storing vertex data in OpenGL.
+     *
+     * The VBO class encapsulates the functionality for creating, managing, and using
+     * OpenGL Vertex Buffer Objects (VBOs) to store vertex data for rendering.
+     */
+    class VBO
+    {
+      public:
+        /**
+         * @brief Constructs a VBO object and initializes it with vertex data.
+         *
+         * This constructor creates a VBO and initializes it with the specified vertex data.
+         * The size parameter indicates the size (in bytes) of the vertex data.
+         *
+         * @param vertices Pointer to the vertex data, in any vertex format.
+         * @param size     The size (in bytes) of the vertex data.
+         */
+        VBO(const void* vertices, GLsizeiptr size);
+        /**
+         * @brief Destroys the VBO object, releasing associated OpenGL resources.
+         *
+         * The destructor cleans up the OpenGL resources associated with the VBO.
+         */
+        ~VBO()
+        { glDeleteBuffers(1, &this->ID); }
+
+        /**
+         * @brief Binds the VBO to the OpenGL context.
+         *
+         * This function binds the VBO to the OpenGL context, making it the current
+         * GL_ARRAY_BUFFER. Subsequent OpenGL operations will affect this VBO.
+         */
+        void Bind() const
+        { glBindBuffer(GL_ARRAY_BUFFER, this->ID); }
+        /**
+         * @brief Unbinds the VBO from the OpenGL context.
+         *
+         * This function unbinds the VBO from the OpenGL context, making it no longer
+         * the current GL_ARRAY_BUFFER. Subsequent OpenGL operations will not affect this VBO.
+         */
+        void Unbind() const
+        { glBindBuffer(GL_ARRAY_BUFFER, 0); }
+        /**
+         * @brief Deletes the VBO, releasing associated OpenGL resources.
+         *
+         * This function deletes the VBO, releasing the OpenGL buffer object.
+         */
+        void Delete() const
+        { glDeleteBuffers(1, &this->ID); }
+        /**
+         * @brief Replaces the contents of the VBO.
+         *
+         * This function reallocates the buffer storage, so the driver can hand out fresh memory
+         * instead of waiting for draws that still read the old contents.
+         *
+         * @param data  Pointer to the new data.
+         * @param size  The size (in bytes) of the new data.
+         * @param usage The expected usage pattern (e.g., GL_STREAM_DRAW).
+         */
+        void SetData(const void* data, GLsizeiptr size, GLenum usage) const;
+
+      private:
+        GLuint ID;
+    };
+
+    /**
+     * @class EBO
+     * @brief Represents an Element Buffer Object (EBO) for storing element (index) data in OpenGL.
+     *
+     * The EBO class encapsulates the functionality for creating, managing, and using
+     * OpenGL Element Buffer Objects (EBOs) to store element (index) data for rendering.
+     *
+     * The indices are stored in the narrowest type that holds the largest index, so draws must
+     * use getType() and getCount() instead of assuming GL_UNSIGNED_INT.
+     */
+    class EBO
+    {
+      public:
+        /**
+         * @brief Constructs an EBO object and initializes it with element data.
+         *
+         * This constructor creates an EBO and initializes it with the specified element data.
+         * The size parameter indicates the size (in bytes) of the element data.
+         *
+         * With primitive restart, indices equal to kdr::Graphics::PRIMITIVE_RESTART_INDEX mark
+         * the restarts and are stored as the largest value of the chosen type.
+         *
+         * @param indices An array of GLuint representing the element (index) data.
+         * @param size    The size (in bytes) of the element data.
+         * @param primitiveRestart Whether the indices contain primitive restart markers.
+         */
+        EBO(const GLuint indices[], GLsizeiptr size, bool primitiveRestart = false);
+        /**
+         * @brief Destroys the EBO object, releasing associated OpenGL resources.
+         *
+         * The destructor cleans up the OpenGL resources associated with the EBO.
+         */
+        ~EBO()
+        { glDeleteBuffers(1, &this->ID); }
+
+        /**
+         * @brief Binds the EBO to the OpenGL context.
+         *
+         * This function binds the EBO to the OpenGL context, making it the current
+         * GL_ELEMENT_ARRAY_BUFFER. Subsequent OpenGL operations will affect this EBO.
+         */
+        void Bind() const
+        { glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->ID); }
+        /**
+         * @brief Unbinds the EBO from the OpenGL context.
+         *
+         * This function unbinds the EBO from the OpenGL context, making it no longer
+         * the current GL_ELEMENT_ARRAY_BUFFER. Subsequent OpenGL operations will not affect this EBO.
+         */
+        void Unbind() const
+        { glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); }
+        /**
+         * @brief Deletes the EBO, releasing associated OpenGL resources.
+         *
+         * This function deletes the EBO, releasing the OpenGL buffer object.
+         */
+        void Delete() const
+        { glDeleteBuffers(1, &this->ID); }
+
+        /**
+         * @brief Gets the type the indices are stored in.
+         *
+         * @return GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, or GL_UNSIGNED_INT.
+         */
+        GLenum getType() const
+        { return this->type; }
+        /**
+         * @brief Gets the number of indices.
+         *
+         * @return The number of indices, including primitive restart markers.
+         */
+        GLsizei getCount() const
+        { return this->count; }
+
+        /**
+         * @brief Gets the size of an index type.
+         *
+         * @param type GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, or GL_UNSIGNED_INT.
+         * @return The size (in bytes) of one index.
+         */
+        static GLsizeiptr getIndexSize(const GLenum type)
+        { return type == GL_UNSIGNED_BYTE ? 1 : (type == GL_UNSIGNED_SHORT ? 2 : 4); }
+        /**
+         * @brief Gets the primitive restart index of an index type.
+         *
+         * @param type GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, or GL_UNSIGNED_INT.
+         * @return The largest value of the type, which marks a restart.
+         */
+        static GLuint getRestartIndex(const GLenum type)
+        { return type == GL_UNSIGNED_BYTE ? 0xff : (type == GL_UNSIGNED_SHORT ? 0xffff : 0xffffffff); }
+
+      private:
+        GLuint ID;
+        GLenum type {GL_UNSIGNED_INT};
+        GLsizei count {0};
+    };
+
+    /**
+     * @class UBO
+     * @brief Represents a Uniform Buffer Object (UBO) for sharing uniform data between shaders in OpenGL.
+     *
+     * The UBO class encapsulates the functionality for creating, updating, and binding
+     * OpenGL Uniform Buffer Objects (UBOs) to indexed binding points.
+     */
+    class UBO
+    {
+      public:
+        /**
+         * @brief Constructs a UBO object and allocates its storage.
+         *
+         * @param size The size (in bytes) of the buffer.
+         */
+        UBO(GLsizeiptr size);
+        /**
+         * @brief Destroys the UBO object, releasing associated OpenGL resources.
+         */
+        ~UBO()
+        { glDeleteBuffers(1, &this->ID); }
+
+        /**
+         * @brief Binds the UBO to the OpenGL context as the current GL_UNIFORM_BUFFER.
+         */
+        void Bind() const
+        { glBindBuffer(GL_UNIFORM_BUFFER, this->ID); }
+        /**
+         * @brief Unbinds the UBO from the OpenGL context.
+         */
+        void Unbind() const
+        { glBindBuffer(GL_UNIFORM_BUFFER, 0); }
+        /**
+         * @brief Binds the UBO to an indexed uniform buffer binding point.
+         *
+         * @param binding The binding point the uniform blocks read from.
+         */
+        void BindBase(const GLuint binding) const
+        { glBindBufferBase(GL_UNIFORM_BUFFER, binding, this->ID); }
+        /**
+         * @brief Updates a range of the buffer.
+         *
+         * @param offset The offset (in bytes) of the range.
+         * @param size The size (in bytes) of the range.
+         * @param data Pointer to the new data.
+         */
+        void SetData(GLintptr offset, GLsizeiptr size, const void* data) const;
+        /**
+         * @brief Deletes the UBO, releasing associated OpenGL resources.
+         */
+        void Delete() const
+        { glDeleteBuffers(1, &this->ID); }
+
+      private:
+        GLuint ID;
+    };
+
+    /**
+     * @class StreamBuffer
+     * @brief Represents a ring buffer for data that is rewritten every frame.
+     *
+     * The buffer is split into one region per frame in flight. Data is appended to the region
+     * of the current frame, and NextFrame() fences it and moves on to the next region, waiting
+     * only if the GPU is still reading that region. With GL_ARB_buffer_storage the buffer is
+     * persistently mapped and written with memcpy; otherwise, or if the mapping fails, the buffer
+     * gets mutable storage, writes go through glBufferSubData and the storage is orphaned whenever
+     * the ring wraps around.
+     */
+    class StreamBuffer
+    {
+      public:
+        /**
+         * @brief Constructs a StreamBuffer object and allocates its storage.
+         *
+         * @param target The buffer target (e.g., GL_ARRAY_BUFFER).
+         * @param regionSize The size (in bytes) available to each frame.
+         * @param regionCount The number of frames that may be in flight at once.
+         */
+        StreamBuffer(GLenum target, GLsizeiptr regionSize, GLuint regionCount = 3);
+        /**
+         * @brief Destroys the StreamBuffer object, releasing associated OpenGL resources.
+         */
+        ~StreamBuffer();
+        StreamBuffer(const StreamBuffer&) = delete;
+        StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+        /**
+         * @brief Gets the OpenGL ID of the buffer.
+         *
+         * @return The OpenGL ID of the buffer.
+         */
+        GLuint getID() const
+        { return this->ID; }
+        /**
+         * @brief Checks whether the buffer is persistently mapped.
+         *
+         * @return True if GL_ARB_buffer_storage is used, false if the orphaning fallback is.
+         */
+        bool getIsPersistent() const
+        { return this->mapped != NULL; }
+        /**
+         * @brief Gets the number of bytes still free in the region of the current frame.
+         *
+         * @return The number of free bytes, ignoring alignment.
+         */
+        GLsizeiptr getAvailable() const
+        { return this->regionEnd - this->head; }
+
+        /**
+         * @brief Binds the buffer to its target.
+         */
+        void Bind() const
+        { glBindBuffer(this->target, this->ID); }
+        /**
+         * @brief Unbinds the buffer from its target.
+         */
+        void Unbind() const
+        { glBindBuffer(this->target, 0); }
+        /**
+         * @brief Binds a range of the buffer to an indexed binding point.
+         *
+         * @param binding The binding point (e.g., of a uniform block).
+         * @param offset The offset returned by Allocate() or Write().
+         * @param size The size (in bytes) of the range.
+         */
+        void BindRange(GLuint binding, GLintptr offset, GLsizeiptr size) const
+        { glBindBufferRange(this->target, binding, this->ID, offset, size); }
+
+        /**
+         * @brief Reserves space in the region of the current frame.
+         *
+         * @param size The size (in bytes) to reserve.
+         * @param alignment The alignment (in bytes) of the returned offset, a power of two.
+         * @return The offset of the reserved space, or -1 if the region is full.
+         */
+        GLintptr Allocate(GLsizeiptr size, GLsizeiptr alignment = 16);
+        /**
+         * @brief Copies data into space reserved with Allocate().
+         *
+         * @param offset The offset returned by Allocate().
+         * @param data Pointer to the data.
+         * @param size The size (in bytes) of the data.
+         */
+        void Upload(GLintptr offset, const void* data, GLsizeiptr size) const;
+        /**
+         * @brief Reserves space in the region of the current frame and copies data into it.
+         *
+         * @param data Pointer to the data.
+         * @param size The size (in bytes) of the data.
+         * @param alignment The alignment (in bytes) of the returned offset, a power of two.
+         * @return The offset of the data, or -1 if the region is full.
+         */
+        GLintptr Write(const void* data, GLsizeiptr size, GLsizeiptr alignment = 16);
+        /**
+         * @brief Ends the current frame and moves on to the next region.
+         *
+         * Call this once per frame after the draws reading the buffer have been issued.
+         */
+        void NextFrame();
+
+      private:
+        GLuint ID;
+        GLenum target;
+        GLsizeiptr regionSize;
+        GLuint regionCount;
+        GLuint region {0};
+        GLintptr head {0};
+        GLintptr regionEnd {0};
+        GLubyte* mapped {NULL};
+        std::vector<GLsync> fences;
+    };
+
+    /**
+     * @class VAO
+     * @brief Represents a Vertex Array Object (VAO) for encapsulating vertex attribute configuration in OpenGL.
+     *
+     * The VAO class encapsulates the functionality for creating, managing, and using
+     * OpenGL Vertex Array Objects (VAOs) to define the configuration of vertex attributes
+     * for rendering with Vertex Buffer Objects (VBOs).
+     */
+    class VAO
+    {
+      public:
+        /**
+         * @brief Constructs a VAO and generates its OpenGL ID.
+         *
+         * This constructor generates an OpenGL Vertex Array Object (VAO) ID.
+         */
+        VAO()
+        { glGenVertexArrays(1, &this->ID); }
+        /**
+         * @brief Destroys the VAO object, releasing associated OpenGL resources.
+         *
+         * The destructor cleans up the OpenGL resources associated with the VAO.
+         */
+        ~VAO()
+        {
+          kdr::State::getCache().releaseVertexArray(this->ID);
+          glDeleteVertexArrays(1, &this->ID);
+        }
+
+        /**
+         * @brief Binds the VAO to the OpenGL context.
+         *
+         * This function binds the VAO to the OpenGL context, making it the current
+         * Vertex Array Object. Subsequent OpenGL operations will affect this VAO.
+         */
+        void Bind() const
+        { kdr::State::getCache().bindVertexArray(this->ID); }
+        /**
+         * @brief Unbinds the VAO from the OpenGL context.
+         *
+         * This function unbinds the VAO from the OpenGL context, making it no longer
+         * the current Vertex Array Object. Subsequent OpenGL operations will not affect this VAO.
+         */
+        void Unbind() const
+        { kdr::State::getCache().bindVertexArray(0); }
+        /**
+         * @brief Deletes the VAO, releasing associated OpenGL resources.
+         *
+         * This function deletes the VAO, releasing the OpenGL buffer object.
+         */
+        void Delete() const
+        {
+          kdr::State::getCache().releaseVertexArray(this->ID);
+          glDeleteVertexArrays(1, &this->ID);
+        }
+        /**
+         * @brief Links a VBO's attribute to the VAO's layout configuration.
+         *
+         * This function associates a VBO's attribute with the layout configuration of the VAO.
+         *
+         * @param VBO     The VBO containing the attribute data.
+         * @param layout  The layout index for the attribute.
+         * @param size    The number of components per attribute (e.g., 3 for a vec3).
+         * @param type    The data type of the attribute.
+         * @param stride  The stride between consecutive attributes in the VBO.
+         * @param offset  The offset of the attribute in the VBO.
+         */
+        void LinkAttrib(const kdr::Graphics::VBO& VBO, GLuint layout, GLuint size, GLenum type, GLsizeiptr stride, const void* offset) const;
+        /**
+         * @brief Links all attributes of a vertex layout to the VAO's layout configuration.
+         *
+         * The VAO must be bound. Attributes with locations 0 to 2 that the layout leaves out are
+         * disabled, and the color attribute then reads opaque white.
+         *
+         * @param VBO     The VBO containing the vertices.
+         * @param layout  The layout of the vertices.
+         */
+        void LinkLayout(const kdr::Graphics::VBO& VBO, const kdr::Graphics::VertexLayout& layout) const;
+        /**
+         * @brief Links a VBO's attribute to the VAO as a per-instance attribute.
+         *
+         * This function works like LinkAttrib(), but the attribute advances once per instance
+         * instead of once per vertex. The VAO must be bound.
+         *
+         * @param VBO     The VBO containing the attribute data.
+         * @param layout  The layout index for the attribute.
+         * @param size    The number of components per attribute (e.g., 4 for a vec4).
+         * @param type    The data type of the attribute.
+         * @param stride  The stride between consecutive instances in the VBO.
+         * @param offset  The offset of the attribute in the VBO.
+         */
+        void LinkInstanceAttrib(const kdr::Graphics::VBO& VBO, GLuint layout, GLuint size, GLenum type, GLsizeiptr stride, const void* offset) const;
+        /**
+         * @brief Links a stream buffer's attribute to the VAO as a per-instance attribute.
+         *
+         * @param buffer  The stream buffer containing the attribute data.
+         * @param layout  The layout index for the attribute.
+         * @param size    The number of components per attribute (e.g., 4 for a vec4).
+         * @param type    The data type of the attribute.
+         * @param stride  The stride between consecutive instances in the buffer.
+         * @param offset  The offset of the attribute in the buffer, as returned by Write().
+         */
+        void LinkInstanceAttrib(const kdr::Graphics::StreamBuffer& buffer, GLuint layout, GLuint size, GLenum type, GLsizeiptr stride, GLintptr offset) const;
+
+      private:
+        GLuint ID;
+    };
+
+    /**
+     * @struct TextureSampling
+     * @brief Holds how a texture is filtered and wrapped when sampled.
+     */
+    struct TextureSampling
+    {
+      GLenum minFilter {GL_NEAREST};
+      GLenum magFilter {GL_NEAREST};
+      GLenum wrapS {GL_REPEAT};
+      GLenum wrapT {GL_REPEAT};
+    };
+
+    class TextureLoader;
+
+    /**
+     * @brief Represents a texture in a graphics application.
+     *
+     * This class provides functionality to load and manage textures in OpenGL.
+     */
+    class Texture
+    {
+      public:
+        /**
+         * @brief Constructs a Texture object from a PNG file.
+         *
+         * The file is decoded and uploaded before the constructor returns.
+         *
+         * @param pngPath The path to the PNG file.
+         * @param type The target of the texture (e.g., GL_TEXTURE_2D).
+         * @param pixelFormat The pixel format of the texture.
+         * @param pixelType The data type of the texture.
+         */
+        Texture(const std::string& pngPath, GLenum type, GLenum slot, GLenum pixelType);
+        /**
+         * @brief Constructs an empty Texture object to be filled by a kdr::Graphics::TextureLoader.
+         *
+         * The texture is not ready until the loader has uploaded its image.
+         *
+         * @param type The target of the texture (e.g., GL_TEXTURE_2D).
+         * @param sampling The filtering and wrapping applied once the storage is allocated.
+         */
+        explicit Texture(GLenum type, const kdr::Graphics::TextureSampling& sampling = kdr::Graphics::TextureSampling());
+        /**
+         * @brief Constructs a Texture object from 8-bit RGBA pixels in memory.
+         *
+         * @param type The target of the texture (e.g., GL_TEXTURE_2D).
+         * @param width The width of the image.
+         * @param height The height of the image.
+         * @param pixels The width * height * 4 bytes of the image, bottom row first.
+         * @param sampling The filtering and wrapping of the texture.
+         */
+        Texture(GLenum type, GLsizei width, GLsizei height, const GLubyte* pixels, const kdr::Graphics::TextureSampling& sampling = kdr::Graphics::TextureSampling());
+        /**
+         * @brief Destructor for the Texture class.
+         *
+         * Releases OpenGL resources associated with the texture.
+         */
+        ~Texture()
+        { this->Delete(); }
+
+        /**
+         * @brief Texture objects own their OpenGL name, so copies would delete it twice.
+         */
+        Texture(const Texture&) = delete;
+        Texture& operator=(const Texture&) = delete;
+
+        /**
+         * @brief Sets the texture unit for a shader uniform.
+         *
+         * @param shader The shader program.
+         * @param uniform The handle of the sampler uniform in the shader.
+         * @param unit The texture unit to set.
+         */
+        void TextureUnit(kdr::Graphics::Shader& shader, const GLint uniform, const GLuint unit) const
+        { shader.setUniform(uniform, static_cast<int>(unit)); }
+        /**
+         * @brief Binds the texture to its designated texture target.
+         */
+        void Bind() const
+        { kdr::State::getCache().bindTexture(this->type, this->ID); };
+        /**
+         * @brief Unbinds the texture.
+         */
+        void Unbind() const
+        { kdr::State::getCache().bindTexture(this->type, 0); };
+        /**
+         * @brief Deletes the texture, releasing associated OpenGL resources.
          *
-         * This constructor loads and compiles the vertex and fragment shaders specified
-         * by the provided file paths. It links the shaders into a program, and the program ID
-         * can be retrieved using the getID() method.
+         * Deleting a texture twice, including through the destructor, is harmless.
+         */
+        void Delete()
+        {
+          if (this->ID == 0)
+          {
+            return;
+          }
+          kdr::State::getCache().releaseTexture(this->ID);
+          glDeleteTextures(1, &this->ID);
+          this->ID = 0;
+          this->isReady = false;
+        }
+
+        /**
+         * @brief Checks whether the image of the texture has been uploaded.
          *
-         * @param vertexPath   The file path to the vertex shader source code.
-         * @param fragmentPath The file path to the fragment shader source code.
+         * @return True if the texture can be sampled, false while it is still loading or if loading failed.
          */
-        Shader(const std::string& vertexPath, const std::string& fragmentPath);
+        bool getIsReady() const
+        { return this->isReady; }
         /**
-         * @brief Destroys the Shader object.
+         * @brief Checks whether a kdr::Graphics::TextureLoader gave up on the image of the texture.
          *
-         * The destructor cleans up the OpenGL resources associated with the shader program.
+         * @return True if the image could not be decoded or uploaded, false otherwise.
          */
-        ~Shader();
-
+        bool getIsFailed() const
+        { return this->isFailed; }
         /**
-         * @brief Gets the OpenGL ID of the shader program.
+         * @brief Gets the width of the texture.
          *
-         * @return The OpenGL ID of the shader program.
+         * @return The width of the image, or 0 if its size is not known yet.
          */
-        GLuint getID() const
-        { return this->ID; }
-
+        GLsizei getWidth() const
+        { return this->width; }
         /**
-         * @brief Sets this shader as the currently active shader in the OpenGL context.
+         * @brief Gets the height of the texture.
+         *
+         * @return The height of the image, or 0 if its size is not known yet.
          */
-        void Use()
-        { glUseProgram(this->ID); }
+        GLsizei getHeight() const
+        { return this->height; }
         /**
-         * @brief Deletes the shader program, releasing associated OpenGL resources.
+         * @brief Gets the approximate GPU memory used by the texture.
+         *
+         * @return The size (in bytes) of the image and its mipmap chain in its internal format.
          */
-        void Delete()
-        { glDeleteProgram(this->ID); }
+        size_t getMemorySize() const;
+        /**
+         * @brief Gets the format the texture is stored in on the GPU.
+         *
+         * @return The internal format (e.g., GL_RGBA8 or GL_COMPRESSED_RGBA_S3TC_DXT5_EXT).
+         */
+        GLenum getInternalFormat() const
+        { return this->internalFormat; }
 
       private:
-        GLuint ID;
+        GLuint ID {0};
+        GLenum type;
+        kdr::Graphics::TextureSampling sampling;
+        GLenum internalFormat {GL_RGBA8};
+        GLsizei width {0};
+        GLsizei height {0};
+        bool isReady {false};
+        bool isFailed {false};
+
+        /**
+         * @brief Allocates immutable storage with a full mipmap chain.
+         *
+         * The sampling parameters are applied as well. The texture is left bound to the active
+         * texture unit.
+         *
+         * @param width The width of the image.
+         * @param height The height of the image.
+         * @param internalFormat The format of the storage (e.g., GL_RGBA8).
+         */
+        void _allocate(const GLsizei width, const GLsizei height, const GLenum internalFormat = GL_RGBA8);
+
+        friend class kdr::Graphics::TextureLoader;
     };
 
     /**
-     * @class VBO
-     * @brief Represents a Vertex Buffer Object (VBO) for storing vertex data in OpenGL.
+     * @class TextureArray
+     * @brief Holds same-sized images as the layers of one GL_TEXTURE_2D_ARRAY.
      *
-     * The VBO class encapsulates the functionality for creating, managing, and using
-     * OpenGL Vertex Buffer Objects (VBOs) to store vertex data for rendering.
+     * Instances select their layer through kdr::Graphics::TextureRegion, so meshes with
+     * different materials can be drawn together without rebinding textures. Shaders sample it
+     * with a sampler2DArray, like resources/Shaders/array.frag.
      */
-    class VBO
+    class TextureArray
     {
       public:
         /**
-         * @brief Constructs a VBO object and initializes it with vertex data.
+         * @brief Constructs a TextureArray object from PNG files.
          *
-         * This constructor creates a VBO and initializes it with the specified vertex data.
-         * The size parameter indicates the size (in bytes) of the vertex data.
+         * The first file decides the size of every layer. Files of another size are reported
+         * and their layers left empty. The files are decoded and uploaded before the
+         * constructor returns.
          *
-         * @param vertices An array of GLfloat representing the vertex data.
-         * @param size     The size (in bytes) of the vertex data.
+         * @param pngPaths The paths to the PNG files, one per layer.
+         * @param sampling The filtering and wrapping of the texture array.
          */
-        VBO(GLfloat vertices[], GLsizeiptr size);
+        TextureArray(const std::vector<std::string>& pngPaths, const kdr::Graphics::TextureSampling& sampling = kdr::Graphics::TextureSampling());
         /**
-         * @brief Destroys the VBO object, releasing associated OpenGL resources.
+         * @brief Destructor for the TextureArray class.
          *
-         * The destructor cleans up the OpenGL resources associated with the VBO.
+         * Releases OpenGL resources associated with the texture array.
          */
-        ~VBO()
-        { glDeleteBuffers(1, &this->ID); }
+        ~TextureArray()
+        { this->Delete(); }
+
+        TextureArray(const TextureArray&) = delete;
+        TextureArray& operator=(const TextureArray&) = delete;
 
         /**
-         * @brief Binds the VBO to the OpenGL context.
+         * @brief Sets the texture unit for a shader uniform.
          *
-         * This function binds the VBO to the OpenGL context, making it the current
-         * GL_ARRAY_BUFFER. Subsequent OpenGL operations will affect this VBO.
+         * @param shader The shader program.
+         * @param uniform The handle of the sampler uniform in the shader.
+         * @param unit The texture unit to set.
+         */
+        void TextureUnit(kdr::Graphics::Shader& shader, const GLint uniform, const GLuint unit) const
+        { shader.setUniform(uniform, static_cast<int>(unit)); }
+        /**
+         * @brief Binds the texture array.
          */
         void Bind() const
-        { glBindBuffer(GL_ARRAY_BUFFER, this->ID); }
+        { kdr::State::getCache().bindTexture(GL_TEXTURE_2D_ARRAY, this->ID); }
         /**
-         * @brief Unbinds the VBO from the OpenGL context.
-         *
-         * This function unbinds the VBO from the OpenGL context, making it no longer
-         * the current GL_ARRAY_BUFFER. Subsequent OpenGL operations will not affect this VBO.
+         * @brief Unbinds the texture array.
          */
         void Unbind() const
-        { glBindBuffer(GL_ARRAY_BUFFER, 0); }
+        { kdr::State::getCache().bindTexture(GL_TEXTURE_2D_ARRAY, 0); }
         /**
-         * @brief Deletes the VBO, releasing associated OpenGL resources.
+         * @brief Deletes the texture array, releasing associated OpenGL resources.
+         */
+        void Delete()
+        {
+          if (this->ID == 0)
+          {
+            return;
+          }
+          kdr::State::getCache().releaseTexture(this->ID);
+          glDeleteTextures(1, &this->ID);
+          this->ID = 0;
+        }
+
+        /**
+         * @brief Gets the region covering a whole layer.
          *
-         * This function deletes the VBO, releasing the OpenGL buffer object.
+         * @param layer The index of the layer.
+         * @return The texture region selecting the layer.
          */
-        void Delete() const
-        { glDeleteBuffers(1, &this->ID); }
+        kdr::Graphics::TextureRegion getRegion(const GLsizei layer) const
+        { return {0.f, 0.f, 1.f, 1.f, static_cast<GLfloat>(layer)}; }
+        /**
+         * @brief Gets the number of layers.
+         *
+         * @return The number of layers.
+         */
+        GLsizei getLayerCount() const
+        { return this->layerCount; }
+        /**
+         * @brief Gets the width of every layer.
+         *
+         * @return The width of the layers.
+         */
+        GLsizei getWidth() const
+        { return this->width; }
+        /**
+         * @brief Gets the height of every layer.
+         *
+         * @return The height of the layers.
+         */
+        GLsizei getHeight() const
+        { return this->height; }
 
       private:
-        GLuint ID;
+        GLuint ID {0};
+        GLsizei layerCount {0};
+        GLsizei width {0};
+        GLsizei height {0};
     };
 
     /**
-     * @class EBO
-     * @brief Represents an Element Buffer Object (EBO) for storing element (index) data in OpenGL.
+     * @class TextureAtlas
+     * @brief Packs images of any size into one texture.
      *
-     * The EBO class encapsulates the functionality for creating, managing, and using
-     * OpenGL Element Buffer Objects (EBOs) to store element (index) data for rendering.
+     * The images are packed onto shelves, tallest first, each surrounded by
+     * kdr::Graphics::ATLAS_PADDING pixels copied from its edges so filtering does not bleed
+     * into its neighbors. Instances select their image through the kdr::Graphics::TextureRegion
+     * returned by getRegion(), and the atlas is sampled like any texture.
      */
-    class EBO
+    class TextureAtlas
     {
       public:
         /**
-         * @brief Constructs an EBO object and initializes it with element data.
+         * @brief Constructs a TextureAtlas object from PNG files.
          *
-         * This constructor creates an EBO and initializes it with the specified element data.
-         * The size parameter indicates the size (in bytes) of the element data.
+         * The files are decoded, packed, and uploaded before the constructor returns. Images
+         * that fail to load or do not fit are reported and get an empty region.
          *
-         * @param indices An array of GLuint representing the element (index) data.
-         * @param size    The size (in bytes) of the element data.
+         * @param pngPaths The paths to the PNG files.
+         * @param maxSize The largest width and height of the atlas.
+         * @param sampling The filtering and wrapping of the atlas.
          */
-        EBO(GLuint indices[], GLsizeiptr size);
+        TextureAtlas(const std::vector<std::string>& pngPaths, const GLsizei maxSize = 4096, const kdr::Graphics::TextureSampling& sampling = kdr::Graphics::TextureSampling());
         /**
-         * @brief Destroys the EBO object, releasing associated OpenGL resources.
+         * @brief Destructor for the TextureAtlas class.
          *
-         * The destructor cleans up the OpenGL resources associated with the EBO.
+         * Releases the texture of the atlas.
          */
-        ~EBO()
-        { glDeleteBuffers(1, &this->ID); }
+        ~TextureAtlas()
+        { delete this->texture; }
+
+        TextureAtlas(const TextureAtlas&) = delete;
+        TextureAtlas& operator=(const TextureAtlas&) = delete;
 
         /**
-         * @brief Binds the EBO to the OpenGL context.
+         * @brief Gets the texture holding the packed images.
          *
-         * This function binds the EBO to the OpenGL context, making it the current
-         * GL_ELEMENT_ARRAY_BUFFER. Subsequent OpenGL operations will affect this EBO.
+         * @return The texture of the atlas.
          */
-        void Bind() const
-        { glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->ID); }
+        const kdr::Graphics::Texture& getTexture() const
+        { return *this->texture; }
         /**
-         * @brief Unbinds the EBO from the OpenGL context.
+         * @brief Gets the region of an image in the atlas.
          *
-         * This function unbinds the EBO from the OpenGL context, making it no longer
-         * the current GL_ELEMENT_ARRAY_BUFFER. Subsequent OpenGL operations will not affect this EBO.
+         * @param index The index of the image in the paths given to the constructor.
+         * @return The texture region selecting the image.
          */
-        void Unbind() const
-        { glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); }
+        const kdr::Graphics::TextureRegion& getRegion(const size_t index) const
+        { return this->regions[index]; }
         /**
-         * @brief Deletes the EBO, releasing associated OpenGL resources.
+         * @brief Gets the number of images in the atlas.
          *
-         * This function deletes the EBO, releasing the OpenGL buffer object.
+         * @return The number of regions.
          */
-        void Delete() const
-        { glDeleteBuffers(1, &this->ID); }
+        size_t getRegionCount() const
+        { return this->regions.size(); }
 
       private:
-        GLuint ID;
+        kdr::Graphics::Texture* texture {NULL};
+        std::vector<kdr::Graphics::TextureRegion> regions;
     };
 
     /**
-     * @class VAO
-     * @brief Represents a Vertex Array Object (VAO) for encapsulating vertex attribute configuration in OpenGL.
+     * @class TextureLoader
+     * @brief Loads PNG textures in the background through pixel buffer objects.
      *
-     * The VAO class encapsulates the functionality for creating, managing, and using
-     * OpenGL Vertex Array Objects (VAOs) to define the configuration of vertex attributes
-     * for rendering with Vertex Buffer Objects (VBOs).
+     * Load() only queues a file. Update() runs on the OpenGL thread once per frame and moves
+     * every texture through its steps. First the PNG header is read and immutable storage and a
+     * mapped pixel buffer object are created. A worker thread then decodes the image straight
+     * into the mapped buffer. Finally the buffer is unmapped and glTexSubImage2D copies it into
+     * the texture on the GPU. Decoding never blocks the OpenGL thread, and the number of
+     * mapped buffers is capped so that queuing hundreds of textures does not map hundreds of images.
+     *
+     * Compressed textures skip the pixel buffer. The worker loads the mipmap chain from the
+     * compressed texture cache, encoding it first if needed, and the blocks are uploaded
+     * directly, since they are a fraction of the size of the image.
+     *
+     * Textures must outlive their load, or have it cancelled with Cancel() first. Until
+     * Texture::getIsReady() returns true, render with a placeholder, as kdr::Window::bindTexture() does.
      */
-    class VAO
+    class TextureLoader
     {
       public:
         /**
-         * @brief Constructs a VAO and generates its OpenGL ID.
+         * @brief Constructs a TextureLoader object and starts its worker threads.
          *
-         * This constructor generates an OpenGL Vertex Array Object (VAO) ID.
+         * @param threadCount The number of worker threads decoding images.
+         * @param maxUploadsInFlight The maximum number of textures with a mapped pixel buffer at a time.
          */
-        VAO()
-        { glGenVertexArrays(1, &this->ID); }
+        explicit TextureLoader(const unsigned int threadCount = 2, const size_t maxUploadsInFlight = 8);
         /**
-         * @brief Destroys the VAO object, releasing associated OpenGL resources.
+         * @brief Destructor for the TextureLoader class.
          *
-         * The destructor cleans up the OpenGL resources associated with the VAO.
+         * Stops the worker threads and deletes the pixel buffers of unfinished loads, whose
+         * textures stay not ready.
          */
-        ~VAO()
-        { glDeleteVertexArrays(1, &this->ID); }
+        ~TextureLoader();
+
+        TextureLoader(const TextureLoader&) = delete;
+        TextureLoader& operator=(const TextureLoader&) = delete;
 
         /**
-         * @brief Binds the VAO to the OpenGL context.
+         * @brief Queues a PNG file to be loaded into a texture.
          *
-         * This function binds the VAO to the OpenGL context, making it the current
-         * Vertex Array Object. Subsequent OpenGL operations will affect this VAO.
+         * @param texture The texture receiving the image, typically constructed with Texture(GLenum).
+         * @param pngPath The path to the PNG file.
+         * @param format The compressed format, which falls back to uncompressed if unsupported.
          */
-        void Bind() const
-        { glBindVertexArray(this->ID); }
+        void Load(kdr::Graphics::Texture& texture, const std::string& pngPath, const kdr::Compression::Format format = kdr::Compression::Format::None);
         /**
-         * @brief Unbinds the VAO from the OpenGL context.
+         * @brief Cancels the loads of a texture, so it can be deleted before they finish.
          *
-         * This function unbinds the VAO from the OpenGL context, making it no longer
-         * the current Vertex Array Object. Subsequent OpenGL operations will not affect this VAO.
+         * Queued loads are dropped. Loads already decoding run to completion, but their image
+         * is discarded instead of being uploaded.
+         *
+         * @param texture The texture whose loads are cancelled.
          */
-        void Unbind() const
-        { glBindVertexArray(0); }
+        void Cancel(const kdr::Graphics::Texture& texture);
         /**
-         * @brief Deletes the VAO, releasing associated OpenGL resources.
+         * @brief Uploads decoded images and starts queued loads.
          *
-         * This function deletes the VAO, releasing the OpenGL buffer object.
+         * This function must be called on the OpenGL thread, once per frame.
          */
-        void Delete() const
-        { glDeleteVertexArrays(1, &this->ID); }
+        void Update();
+
         /**
-         * @brief Links a VBO's attribute to the VAO's layout configuration.
+         * @brief Gets the number of textures that are still loading.
          *
-         * This function associates a VBO's attribute with the layout configuration of the VAO.
+         * @return The number of queued and in-flight loads.
+         */
+        size_t getPendingCount() const
+        { return this->queuedJobs.size() + this->activeJobs.size(); }
+        /**
+         * @brief Gets the number of loads that have finished, successfully or not.
          *
-         * @param VBO     The VBO containing the attribute data.
-         * @param layout  The layout index for the attribute.
-         * @param size    The number of components per attribute (e.g., 3 for a vec3).
-         * @param type    The data type of the attribute.
-         * @param stride  The stride between consecutive attributes in the VBO.
-         * @param offset  The offset of the attribute in the VBO.
+         * @return The number of loads finished since the loader was constructed.
          */
-        void LinkAttrib(const kdr::Graphics::VBO& VBO, GLuint layout, GLuint size, GLenum type, GLsizeiptr stride, const void* offset) const;
+        size_t getFinishedCount() const
+        { return this->finishedCount; }
+        /**
+         * @brief Gets the directory compressed textures are cached in.
+         *
+         * @return The path of the cache directory.
+         */
+        const std::string& getCacheDirectory() const
+        { return this->cacheDirectory; }
+        /**
+         * @brief Sets the directory compressed textures are cached in.
+         *
+         * Only affects loads queued afterwards.
+         *
+         * @param cacheDirectory The path of the cache directory, created when first written to.
+         */
+        void setCacheDirectory(const std::string& cacheDirectory)
+        { this->cacheDirectory = cacheDirectory; }
 
       private:
-        GLuint ID;
+        struct Job
+        {
+          kdr::Graphics::Texture* texture {NULL};
+          std::string path;
+          kdr::Compression::Format format {kdr::Compression::Format::None};
+          std::string cacheDirectory;
+          kdr::Compression::CompressedImage compressedImage;
+          GLuint PBO {0};
+          GLubyte* pixels {NULL};
+          GLsizei width {0};
+          GLsizei height {0};
+          bool isDecoded {false};
+          bool hasSucceeded {false};
+        };
+
+        size_t maxUploadsInFlight;
+        std::string cacheDirectory {kdr::Compression::DEFAULT_CACHE_DIRECTORY};
+        std::deque<std::unique_ptr<Job>> queuedJobs;
+        std::vector<std::unique_ptr<Job>> activeJobs;
+        size_t finishedCount {0};
+
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<Job*> decodeQueue;
+        bool isStopping {false};
+
+        /**
+         * @brief Allocates the texture and maps a pixel buffer for an uncompressed job.
+         *
+         * Compressed jobs are sized by their cached file, so they go to the workers as they are.
+         *
+         * @param job The job to start.
+         * @return True if the job can be handed to the workers, false if it failed.
+         */
+        bool _start(Job& job);
+        /**
+         * @brief Copies the image of a decoded job into the texture.
+         *
+         * @param job The decoded job.
+         */
+        void _finish(Job& job);
+        /**
+         * @brief Decodes queued jobs until the loader stops. Runs on the worker threads.
+         */
+        void _work();
     };
 
     /**
-     * @brief Represents a texture in a graphics application.
+     * @class TextureCache
+     * @brief Shares textures loaded from the same file with the same sampling.
      *
-     * This class provides functionality to load and manage textures in OpenGL.
+     * Textures are keyed by path, sampling parameters, and format and reference counted, so a file
+     * referenced by thousands of objects is decoded and uploaded once. A texture whose last
+     * reference is released stays resident for later acquires. Unused textures are only evicted,
+     * least recently released first, when the resident textures exceed the memory budget.
+     * Textures are loaded through a kdr::Graphics::TextureLoader, so a freshly acquired texture
+     * is not ready yet.
      */
-    class Texture
+    class TextureCache
     {
       public:
         /**
-         * @brief Constructs a Texture object from a PNG file.
+         * @brief Constructs a TextureCache object.
+         *
+         * @param loader The loader new textures are queued on. Must outlive the cache.
+         * @param memoryBudget The size (in bytes) of GPU memory unused textures are evicted to stay under.
+         */
+        TextureCache(kdr::Graphics::TextureLoader& loader, const size_t memoryBudget);
+        /**
+         * @brief Destructor for the TextureCache class.
+         *
+         * Deletes every texture, whether or not it is still referenced, cancelling the loads of
+         * those that are still loading.
+         */
+        ~TextureCache();
+
+        TextureCache(const TextureCache&) = delete;
+        TextureCache& operator=(const TextureCache&) = delete;
+
+        /**
+         * @brief Acquires a reference to a texture, loading it on first use.
          *
          * @param pngPath The path to the PNG file.
-         * @param type The target of the texture (e.g., GL_TEXTURE_2D).
-         * @param pixelFormat The pixel format of the texture.
-         * @param pixelType The data type of the texture.
+         * @param sampling The filtering and wrapping of the texture.
+         * @param format The compressed format of the texture.
+         * @return The handle of the texture.
          */
-        Texture(const std::string& pngPath, GLenum type, GLenum slot, GLenum pixelType);
+        size_t acquire(
+          const std::string& pngPath,
+          const kdr::Graphics::TextureSampling& sampling = kdr::Graphics::TextureSampling(),
+          const kdr::Compression::Format format = kdr::Compression::Format::None
+        );
         /**
-         * @brief Destructor for the Texture class.
+         * @brief Releases a reference to a texture.
          *
-         * Releases OpenGL resources associated with the texture.
+         * The texture stays resident until the memory budget forces it out. Releasing a texture
+         * without references is reported and ignored.
+         *
+         * @param handle The handle returned by acquire().
          */
-        ~Texture()
-        { glDeleteTextures(1, &this->ID); }
+        void release(const size_t handle);
+        /**
+         * @brief Re-checks the memory budget once loads have finished.
+         *
+         * Textures only count their memory once the loader knows their size, so a finished load can
+         * push the cache over budget. This function must be called after TextureLoader::Update().
+         */
+        void Update();
 
         /**
-         * @brief Sets the texture unit for a shader uniform.
+         * @brief Gets a texture.
          *
-         * @param shaderID The ID of the shader program.
-         * @param uniform The name of the uniform variable in the shader.
-         * @param unit The texture unit to set.
+         * @param handle The handle returned by acquire().
+         * @return The texture.
          */
-        void TextureUnit(const GLuint shaderID, const std::string& uniform, GLuint unit) const
-        {
-          GLuint texUnitLoc = glGetUniformLocation(shaderID, uniform.c_str());
-          glUniform1i(texUnitLoc, unit);
-        }
+        const kdr::Graphics::Texture& getTexture(const size_t handle) const
+        { return *this->textures[handle]; }
         /**
-         * @brief Binds the texture to its designated texture target.
+         * @brief Gets the number of references to a texture.
+         *
+         * @param handle The handle returned by acquire().
+         * @return The number of users sharing the texture.
          */
-        void Bind() const
-        { glBindTexture(this->type, this->ID); };
+        size_t getReferenceCount(const size_t handle) const
+        { return this->referenceCounts[handle]; }
         /**
-         * @brief Unbinds the texture.
+         * @brief Gets the number of resident textures, including unused ones.
+         *
+         * @return The number of textures in the cache.
          */
-        void Unbind() const
-        { glBindTexture(this->type, 0); };
+        size_t getTextureCount() const
+        { return this->handles.size(); }
         /**
-         * @brief Deletes the texture, releasing associated OpenGL resources.
+         * @brief Gets the approximate GPU memory used by the resident textures.
+         *
+         * @return The size (in bytes) of all textures in the cache.
          */
-        void Delete() const
-        { glDeleteTextures(1, &this->ID); }
+        size_t getMemoryUsage() const;
+        /**
+         * @brief Gets the memory budget.
+         *
+         * @return The size (in bytes) unused textures are evicted to stay under.
+         */
+        size_t getMemoryBudget() const
+        { return this->memoryBudget; }
+        /**
+         * @brief Sets the memory budget, evicting unused textures if it is exceeded.
+         *
+         * @param memoryBudget The new size (in bytes) unused textures are evicted to stay under.
+         */
+        void setMemoryBudget(const size_t memoryBudget);
+
+        /**
+         * @brief Gets the number of acquires served by a resident texture.
+         *
+         * @return The number of hits since the last resetCounters() call.
+         */
+        size_t getHitCount() const
+        { return this->hitCount; }
+        /**
+         * @brief Gets the number of acquires that had to load a texture.
+         *
+         * @return The number of misses since the last resetCounters() call.
+         */
+        size_t getMissCount() const
+        { return this->missCount; }
+        /**
+         * @brief Gets the number of unused textures evicted to stay under the memory budget.
+         *
+         * @return The number of evictions since the last resetCounters() call.
+         */
+        size_t getEvictionCount() const
+        { return this->evictionCount; }
+        /**
+         * @brief Resets the hit, miss, and eviction counters.
+         */
+        void resetCounters()
+        {
+          this->hitCount = 0;
+          this->missCount = 0;
+          this->evictionCount = 0;
+        }
 
       private:
-        GLuint ID;
-        GLenum type;
+        kdr::Graphics::TextureLoader& loader;
+        size_t memoryBudget;
+
+        std::unordered_map<std::string, size_t> handles;
+        std::vector<kdr::Graphics::Texture*> textures;
+        std::vector<size_t> referenceCounts;
+        std::vector<std::string> keys;
+        std::vector<size_t> releaseTimes;
+        std::vector<size_t> freeHandles;
+        size_t releaseClock {0};
+        size_t finishedCount {0};
+
+        size_t hitCount {0};
+        size_t missCount {0};
+        size_t evictionCount {0};
+
+        /**
+         * @brief Evicts unused textures, least recently released first, until the budget is met.
+         *
+         * Textures that are still loading are skipped, since the loader writes into them. Textures
+         * whose load failed are evicted like ready ones.
+         */
+        void _evict();
+        /**
+         * @brief Builds the key of a texture.
+         *
+         * @param pngPath The path to the PNG file.
+         * @param sampling The filtering and wrapping of the texture.
+         * @param format The compressed format of the texture.
+         * @return The key identifying the texture in the cache.
+         */
+        static std::string _makeKey(const std::string& pngPath, const kdr::Graphics::TextureSampling& sampling, const kdr::Compression::Format format);
     };
   }
 }
@@ -8,6 +8,7 @@
 #include <png.h>
 #include <iostream>
 #include <string>
+#include <vector>
 
 namespace kdr
 {
@@ -30,6 +31,30 @@ namespace kdr
      * @return True if the image is successfully loaded, false otherwise.
      */
     bool loadFromPng(const std::string& path, GLubyte** data, int& imgWidth, int& imgHeight, bool& hasAlpha);
+    /**
+     * @brief Reads the size of a PNG file without decoding the image.
+     *
+     * @param path The path to the PNG file.
+     * @param imgWidth Reference to store the width of the image.
+     * @param imgHeight Reference to store the height of the image.
+     * @return True if the header is successfully read, false otherwise.
+     */
+    bool readPngSize(const std::string& path, int& imgWidth, int& imgHeight);
+    /**
+     * @brief Decodes a PNG file as 8-bit RGBA into a caller-provided buffer.
+     *
+     * Every format is expanded to four channels, with opaque alpha where the file has none,
+     * and the rows are stored bottom-up like loadFromPng(). Nothing is allocated per image,
+     * so the buffer can be memory mapped from OpenGL. This function does not call OpenGL and
+     * can run on any thread.
+     *
+     * @param path The path to the PNG file.
+     * @param data The buffer receiving imgWidth * imgHeight * 4 bytes.
+     * @param imgWidth The expected width of the image.
+     * @param imgHeight The expected height of the image.
+     * @return True if the image is successfully decoded and has the expected size, false otherwise.
+     */
+    bool loadRgbaFromPng(const std::string& path, GLubyte* data, const int imgWidth, const int imgHeight);
   }
 }
 
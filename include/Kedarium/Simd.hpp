@@ -0,0 +1,923 @@
+#ifndef KDR_SIMD_HPP
+#define KDR_SIMD_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#if defined(KDR_ENABLE_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+  #define KDR_SIMD_SSE
+  #include <immintrin.h>
+  #if defined(__AVX__)
+    #define KDR_SIMD_AVX
+  #endif
+#endif
+
+// The constexpr math picks its compile-time path through this check. A fallback that guessed
+// would either break constant evaluation or silently change runtime results, so there is none.
+#if defined(__cpp_lib_is_constant_evaluated)
+  #define KDR_IS_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#elif defined(__has_builtin)
+  #if __has_builtin(__builtin_is_constant_evaluated)
+    #define KDR_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+  #endif
+#endif
+#if !defined(KDR_IS_CONSTANT_EVALUATED) && ((defined(__GNUC__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925))
+  #define KDR_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+#if !defined(KDR_IS_CONSTANT_EVALUATED)
+  #error "Kedarium needs std::is_constant_evaluated() or __builtin_is_constant_evaluated()."
+#endif
+
+namespace kdr
+{
+  /**
+   * @namespace Simd
+   * @brief Contains the vectorized kernels behind the Space math.
+   *
+   * The kernels work on plain float arrays laid out like kdr::Space::Mat4 (four contiguous columns
+   * of four floats) and kdr::Space::Vec3 (three contiguous floats). The instruction set is picked
+   * at build time: AVX when compiled with -mavx, SSE on any x86-64 target, and a scalar fallback
+   * when KDR_ENABLE_SIMD is not defined.
+   *
+   * The vector paths perform the same multiplications and additions in the same order as the
+   * scalar fallback, so their results are identical to it. The only documented differences are the
+   * sign of an exact zero, since the vector accumulation does not start from +0, and inverseMat4(),
+   * whose SSE path factors the matrix differently and may differ in the last bits.
+   * tests/SimdTest.cpp checks every kernel against the scalar fallback.
+   */
+  namespace Simd
+  {
+    // Polynomial sincos constants: PI/2 split for Cody-Waite reduction, then the Cephes minimax coefficients
+    constexpr float SINCOS_TWO_OVER_PI  {0.636619772367581343f};
+    constexpr float SINCOS_HALF_PI_A    {1.5703125f};
+    constexpr float SINCOS_HALF_PI_B    {4.837512969970703125e-4f};
+    constexpr float SINCOS_HALF_PI_C    {7.54978995489188216e-8f};
+    constexpr float SINCOS_SINE_C0      {-1.9515295891e-4f};
+    constexpr float SINCOS_SINE_C1      {8.3321608736e-3f};
+    constexpr float SINCOS_SINE_C2      {-1.6666654611e-1f};
+    constexpr float SINCOS_COSINE_C0    {2.443315711809948e-5f};
+    constexpr float SINCOS_COSINE_C1    {-1.388731625493765e-3f};
+    constexpr float SINCOS_COSINE_C2    {4.166664568298827e-2f};
+    constexpr float SINCOS_MAX_RADIANS  {8192.f};
+    constexpr float SINCOS_MAX_ERROR    {2e-7f};
+
+    /**
+     * @brief Gets the name of the instruction set the kernels were compiled for.
+     *
+     * @return "AVX", "SSE" or "Scalar".
+     */
+    inline const char* getInstructionSet()
+    {
+    #if defined(KDR_SIMD_AVX)
+      return "AVX";
+    #elif defined(KDR_SIMD_SSE)
+      return "SSE";
+    #else
+      return "Scalar";
+    #endif
+    }
+
+  #if defined(KDR_SIMD_SSE)
+    /**
+     * @brief Loads three contiguous floats into the lower lanes of a vector register.
+     *
+     * @param data Pointer to the three floats.
+     * @return The register with the last lane set to 0.
+     */
+    inline __m128 load3(const float* data)
+    { return _mm_setr_ps(data[0], data[1], data[2], 0.f); }
+    /**
+     * @brief Stores the lower three lanes of a vector register.
+     *
+     * @param data Pointer to the destination floats.
+     * @param vec The register to store.
+     */
+    inline void store3(float* data, const __m128 vec)
+    {
+      alignas(16) float lanes[4];
+      _mm_store_ps(lanes, vec);
+      data[0] = lanes[0];
+      data[1] = lanes[1];
+      data[2] = lanes[2];
+    }
+    /**
+     * @brief Permutes the lanes of a vector register.
+     *
+     * The mask is a template parameter, since the shuffle needs it as an immediate even in
+     * unoptimized builds.
+     *
+     * @tparam Mask The _MM_SHUFFLE mask picking the source lane of every lane.
+     * @param vec The register to permute.
+     * @return The permuted register.
+     */
+    template <int Mask>
+    inline __m128 swizzle(const __m128 vec)
+    { return _mm_castsi128_ps(_mm_shuffle_epi32(_mm_castps_si128(vec), Mask)); }
+  #endif
+
+    /**
+     * @brief Multiplies two column-major 4x4 matrices.
+     *
+     * Computes the same product as kdr::Space::Mat4::operator*, where every column of the result
+     * is the left matrix applied to the matching column of the right matrix.
+     *
+     * @param lhs Pointer to the 16 floats of the left matrix.
+     * @param rhs Pointer to the 16 floats of the right matrix.
+     * @param result Pointer to the 16 floats receiving the product. Must not alias the inputs.
+     */
+    inline void multiplyMat4(const float* lhs, const float* rhs, float* result)
+    {
+    #if defined(KDR_SIMD_AVX)
+      const __m256 col0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(lhs + 0));
+      const __m256 col1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(lhs + 4));
+      const __m256 col2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(lhs + 8));
+      const __m256 col3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(lhs + 12));
+      for (int i = 0; i < 4; i += 2)
+      {
+        const __m256 factors = _mm256_loadu_ps(rhs + i * 4);
+        __m256 sum = _mm256_mul_ps(_mm256_permute_ps(factors, 0x00), col0);
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_permute_ps(factors, 0x55), col1));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_permute_ps(factors, 0xAA), col2));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_permute_ps(factors, 0xFF), col3));
+        _mm256_storeu_ps(result + i * 4, sum);
+      }
+    #elif defined(KDR_SIMD_SSE)
+      const __m128 col0 = _mm_loadu_ps(lhs + 0);
+      const __m128 col1 = _mm_loadu_ps(lhs + 4);
+      const __m128 col2 = _mm_loadu_ps(lhs + 8);
+      const __m128 col3 = _mm_loadu_ps(lhs + 12);
+      for (int i = 0; i < 4; i++)
+      {
+        __m128 sum = _mm_mul_ps(_mm_set1_ps(rhs[i * 4 + 0]), col0);
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(rhs[i * 4 + 1]), col1));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(rhs[i * 4 + 2]), col2));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(rhs[i * 4 + 3]), col3));
+        _mm_storeu_ps(result + i * 4, sum);
+      }
+    #else
+      for (int i = 0; i < 4; i++)
+      {
+        for (int j = 0; j < 4; j++)
+        {
+          float sum {0.f};
+          for (int k = 0; k < 4; k++)
+          {
+            sum += rhs[i * 4 + k] * lhs[k * 4 + j];
+          }
+          result[i * 4 + j] = sum;
+        }
+      }
+    #endif
+    }
+
+    /**
+     * @brief Multiplies one shared column-major 4x4 matrix by an array of matrices.
+     *
+     * Equivalent to calling multiplyMat4(lhs, rhs + i * 16, result + i * 16) for every matrix,
+     * but the columns of the shared matrix are only loaded once.
+     *
+     * @param lhs Pointer to the 16 floats of the shared left matrix.
+     * @param rhs Pointer to the packed right matrices (16 floats each).
+     * @param result Pointer to the packed matrices receiving the products.
+     * @param count The number of matrices.
+     */
+    inline void multiplyMat4Shared(const float* lhs, const float* rhs, float* result, const size_t count)
+    {
+    #if defined(KDR_SIMD_AVX)
+      const __m256 col0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(lhs + 0));
+      const __m256 col1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(lhs + 4));
+      const __m256 col2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(lhs + 8));
+      const __m256 col3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(lhs + 12));
+      for (size_t i = 0; i < count * 4; i += 2)
+      {
+        const __m256 factors = _mm256_loadu_ps(rhs + i * 4);
+        __m256 sum = _mm256_mul_ps(_mm256_permute_ps(factors, 0x00), col0);
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_permute_ps(factors, 0x55), col1));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_permute_ps(factors, 0xAA), col2));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_permute_ps(factors, 0xFF), col3));
+        _mm256_storeu_ps(result + i * 4, sum);
+      }
+    #elif defined(KDR_SIMD_SSE)
+      const __m128 col0 = _mm_loadu_ps(lhs + 0);
+      const __m128 col1 = _mm_loadu_ps(lhs + 4);
+      const __m128 col2 = _mm_loadu_ps(lhs + 8);
+      const __m128 col3 = _mm_loadu_ps(lhs + 12);
+      for (size_t i = 0; i < count * 4; i++)
+      {
+        __m128 sum = _mm_mul_ps(_mm_set1_ps(rhs[i * 4 + 0]), col0);
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(rhs[i * 4 + 1]), col1));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(rhs[i * 4 + 2]), col2));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(rhs[i * 4 + 3]), col3));
+        _mm_storeu_ps(result + i * 4, sum);
+      }
+    #else
+      for (size_t i = 0; i < count; i++)
+      {
+        multiplyMat4(lhs, rhs + i * 16, result + i * 16);
+      }
+    #endif
+    }
+
+    /**
+     * @brief Transforms structure-of-arrays points by a column-major 4x4 matrix.
+     *
+     * Every point is treated as (x, y, z, 1) and the resulting w component is discarded.
+     * The points are processed 8 (AVX) or 4 (SSE) at a time, with the same operation order
+     * as transformVec4.
+     *
+     * @param mat Pointer to the 16 floats of the matrix.
+     * @param xs Pointer to the x components of the points.
+     * @param ys Pointer to the y components of the points.
+     * @param zs Pointer to the z components of the points.
+     * @param outXs Pointer to the x components receiving the transformed points.
+     * @param outYs Pointer to the y components receiving the transformed points.
+     * @param outZs Pointer to the z components receiving the transformed points.
+     * @param count The number of points.
+     */
+    inline void transformPoints(const float* mat, const float* xs, const float* ys, const float* zs, float* outXs, float* outYs, float* outZs, const size_t count)
+    {
+      size_t i {0};
+    #if defined(KDR_SIMD_AVX)
+      for (; i + 8 <= count; i += 8)
+      {
+        const __m256 x = _mm256_loadu_ps(xs + i);
+        const __m256 y = _mm256_loadu_ps(ys + i);
+        const __m256 z = _mm256_loadu_ps(zs + i);
+        float* outs[3] {outXs, outYs, outZs};
+        for (int j = 0; j < 3; j++)
+        {
+          __m256 sum = _mm256_mul_ps(_mm256_set1_ps(mat[0 + j]), x);
+          sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(mat[4 + j]), y));
+          sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(mat[8 + j]), z));
+          sum = _mm256_add_ps(sum, _mm256_set1_ps(mat[12 + j]));
+          _mm256_storeu_ps(outs[j] + i, sum);
+        }
+      }
+    #endif
+    #if defined(KDR_SIMD_SSE)
+      for (; i + 4 <= count; i += 4)
+      {
+        const __m128 x = _mm_loadu_ps(xs + i);
+        const __m128 y = _mm_loadu_ps(ys + i);
+        const __m128 z = _mm_loadu_ps(zs + i);
+        float* outs[3] {outXs, outYs, outZs};
+        for (int j = 0; j < 3; j++)
+        {
+          __m128 sum = _mm_mul_ps(_mm_set1_ps(mat[0 + j]), x);
+          sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(mat[4 + j]), y));
+          sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(mat[8 + j]), z));
+          sum = _mm_add_ps(sum, _mm_set1_ps(mat[12 + j]));
+          _mm_storeu_ps(outs[j] + i, sum);
+        }
+      }
+    #endif
+      for (; i < count; i++)
+      {
+        const float x = xs[i];
+        const float y = ys[i];
+        const float z = zs[i];
+        outXs[i] = mat[0] * x + mat[4] * y + mat[8] * z + mat[12];
+        outYs[i] = mat[1] * x + mat[5] * y + mat[9] * z + mat[13];
+        outZs[i] = mat[2] * x + mat[6] * y + mat[10] * z + mat[14];
+      }
+    }
+
+    /**
+     * @brief Multiplies a column-major 4x4 matrix by a 4D column vector.
+     *
+     * @param mat Pointer to the 16 floats of the matrix.
+     * @param vec Pointer to the 4 floats of the vector.
+     * @param result Pointer to the 4 floats receiving the product. Must not alias the inputs.
+     */
+    inline void transformVec4(const float* mat, const float* vec, float* result)
+    {
+    #if defined(KDR_SIMD_SSE)
+      __m128 sum = _mm_mul_ps(_mm_loadu_ps(mat + 0), _mm_set1_ps(vec[0]));
+      sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(mat + 4), _mm_set1_ps(vec[1])));
+      sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(mat + 8), _mm_set1_ps(vec[2])));
+      sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(mat + 12), _mm_set1_ps(vec[3])));
+      _mm_storeu_ps(result, sum);
+    #else
+      for (int j = 0; j < 4; j++)
+      {
+        float sum {0.f};
+        for (int k = 0; k < 4; k++)
+        {
+          sum += mat[k * 4 + j] * vec[k];
+        }
+        result[j] = sum;
+      }
+    #endif
+    }
+
+    /**
+     * @brief Calculates the dot product of two 3D vectors.
+     *
+     * @param vecA Pointer to the 3 floats of the first vector.
+     * @param vecB Pointer to the 3 floats of the second vector.
+     * @return The dot product, summed as x + y + z.
+     */
+    inline float dot3(const float* vecA, const float* vecB)
+    {
+    #if defined(KDR_SIMD_SSE)
+      const __m128 products = _mm_mul_ps(load3(vecA), load3(vecB));
+      __m128 sum = _mm_add_ss(products, _mm_shuffle_ps(products, products, _MM_SHUFFLE(1, 1, 1, 1)));
+      sum = _mm_add_ss(sum, _mm_shuffle_ps(products, products, _MM_SHUFFLE(2, 2, 2, 2)));
+      return _mm_cvtss_f32(sum);
+    #else
+      return vecA[0] * vecB[0] + vecA[1] * vecB[1] + vecA[2] * vecB[2];
+    #endif
+    }
+
+    /**
+     * @brief Calculates the cross product of two 3D vectors.
+     *
+     * @param vecA Pointer to the 3 floats of the first vector.
+     * @param vecB Pointer to the 3 floats of the second vector.
+     * @param result Pointer to the 3 floats receiving the cross product.
+     */
+    inline void cross3(const float* vecA, const float* vecB, float* result)
+    {
+    #if defined(KDR_SIMD_SSE)
+      const __m128 a = load3(vecA);
+      const __m128 b = load3(vecB);
+      const __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+      const __m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+      const __m128 aZXY = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+      const __m128 bZXY = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2));
+      store3(result, _mm_sub_ps(_mm_mul_ps(aYZX, bZXY), _mm_mul_ps(aZXY, bYZX)));
+    #else
+      const float x = vecA[1] * vecB[2] - vecA[2] * vecB[1];
+      const float y = vecA[2] * vecB[0] - vecA[0] * vecB[2];
+      const float z = vecA[0] * vecB[1] - vecA[1] * vecB[0];
+      result[0] = x;
+      result[1] = y;
+      result[2] = z;
+    #endif
+    }
+
+    /**
+     * @brief Normalizes a 3D vector.
+     *
+     * @param vec Pointer to the 3 floats of the vector.
+     * @param result Pointer to the 3 floats receiving the normalized vector.
+     */
+    inline void normalize3(const float* vec, float* result)
+    {
+    #if defined(KDR_SIMD_SSE)
+      const __m128 length = _mm_sqrt_ss(_mm_set_ss(dot3(vec, vec)));
+      store3(result, _mm_div_ps(load3(vec), _mm_shuffle_ps(length, length, 0x00)));
+    #else
+      const float length = sqrtf(dot3(vec, vec));
+      result[0] = vec[0] / length;
+      result[1] = vec[1] / length;
+      result[2] = vec[2] / length;
+    #endif
+    }
+
+    /**
+     * @brief Composes two row-major 3x4 affine matrices.
+     *
+     * Each matrix stores three rows of four floats, with the translation in the last column and
+     * an implicit (0, 0, 0, 1) last row.
+     *
+     * @param lhs Pointer to the 12 floats of the left matrix.
+     * @param rhs Pointer to the 12 floats of the right matrix.
+     * @param result Pointer to the 12 floats receiving the product. Must not alias the inputs.
+     */
+    inline void multiplyAffine(const float* lhs, const float* rhs, float* result)
+    {
+    #if defined(KDR_SIMD_SSE)
+      const __m128 row0 = _mm_loadu_ps(rhs + 0);
+      const __m128 row1 = _mm_loadu_ps(rhs + 4);
+      const __m128 row2 = _mm_loadu_ps(rhs + 8);
+      const __m128 lastLane = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+      for (int r = 0; r < 3; r++)
+      {
+        const __m128 factors = _mm_loadu_ps(lhs + r * 4);
+        __m128 sum = _mm_mul_ps(_mm_shuffle_ps(factors, factors, 0x00), row0);
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(factors, factors, 0x55), row1));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(factors, factors, 0xAA), row2));
+        sum = _mm_add_ps(sum, _mm_and_ps(factors, lastLane));
+        _mm_storeu_ps(result + r * 4, sum);
+      }
+    #else
+      for (int r = 0; r < 3; r++)
+      {
+        for (int c = 0; c < 4; c++)
+        {
+          float sum = lhs[r * 4 + 0] * rhs[0 * 4 + c] + lhs[r * 4 + 1] * rhs[1 * 4 + c] + lhs[r * 4 + 2] * rhs[2 * 4 + c];
+          result[r * 4 + c] = c == 3 ? sum + lhs[r * 4 + 3] : sum;
+        }
+      }
+    #endif
+    }
+
+    /**
+     * @brief Transforms a 3D point or direction by a row-major 3x4 affine matrix.
+     *
+     * @param mat Pointer to the 12 floats of the matrix.
+     * @param vec Pointer to the 3 floats of the point or direction.
+     * @param w 1 to transform a point (applying the translation), 0 to transform a direction.
+     * @param result Pointer to the 3 floats receiving the transformed vector.
+     */
+    inline void transformAffine(const float* mat, const float* vec, const float w, float* result)
+    {
+    #if defined(KDR_SIMD_SSE)
+      const __m128 factors = _mm_setr_ps(vec[0], vec[1], vec[2], w);
+      __m128 products0 = _mm_mul_ps(_mm_loadu_ps(mat + 0), factors);
+      __m128 products1 = _mm_mul_ps(_mm_loadu_ps(mat + 4), factors);
+      __m128 products2 = _mm_mul_ps(_mm_loadu_ps(mat + 8), factors);
+      __m128 products3 = _mm_setzero_ps();
+      _MM_TRANSPOSE4_PS(products0, products1, products2, products3);
+      store3(result, _mm_add_ps(_mm_add_ps(_mm_add_ps(products0, products1), products2), products3));
+    #else
+      float transformed[3] {};
+      for (int r = 0; r < 3; r++)
+      {
+        transformed[r] = mat[r * 4 + 0] * vec[0] + mat[r * 4 + 1] * vec[1] + mat[r * 4 + 2] * vec[2] + mat[r * 4 + 3] * w;
+      }
+      result[0] = transformed[0];
+      result[1] = transformed[1];
+      result[2] = transformed[2];
+    #endif
+    }
+
+    /**
+     * @brief Inverts a row-major 3x4 affine matrix.
+     *
+     * Uses the closed form inv([A | t]) = [inv(A) | -inv(A) * t], where the inverse of the 3x3
+     * part is built from the cross products of its rows.
+     *
+     * @param mat Pointer to the 12 floats of the matrix. Must be invertible.
+     * @param result Pointer to the 12 floats receiving the inverse.
+     */
+    inline void inverseAffine(const float* mat, float* result)
+    {
+    #if defined(KDR_SIMD_SSE)
+      const __m128 firstLanes = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+      const __m128 row0 = _mm_loadu_ps(mat + 0);
+      const __m128 row1 = _mm_loadu_ps(mat + 4);
+      const __m128 row2 = _mm_loadu_ps(mat + 8);
+      const __m128 a0 = _mm_and_ps(row0, firstLanes);
+      const __m128 a1 = _mm_and_ps(row1, firstLanes);
+      const __m128 a2 = _mm_and_ps(row2, firstLanes);
+
+      const auto cross = [](const __m128 a, const __m128 b) {
+        const __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+        const __m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+        const __m128 aZXY = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+        const __m128 bZXY = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2));
+        return _mm_sub_ps(_mm_mul_ps(aYZX, bZXY), _mm_mul_ps(aZXY, bYZX));
+      };
+      __m128 col0 = cross(a1, a2);
+      __m128 col1 = cross(a2, a0);
+      __m128 col2 = cross(a0, a1);
+
+      const __m128 products = _mm_mul_ps(a0, col0);
+      __m128 det = _mm_add_ss(products, _mm_shuffle_ps(products, products, _MM_SHUFFLE(1, 1, 1, 1)));
+      det = _mm_add_ss(det, _mm_shuffle_ps(products, products, _MM_SHUFFLE(2, 2, 2, 2)));
+      const __m128 invDet = _mm_div_ps(_mm_set1_ps(1.f), _mm_shuffle_ps(det, det, 0x00));
+      col0 = _mm_mul_ps(col0, invDet);
+      col1 = _mm_mul_ps(col1, invDet);
+      col2 = _mm_mul_ps(col2, invDet);
+
+      __m128 translation = _mm_mul_ps(col0, _mm_shuffle_ps(row0, row0, 0xFF));
+      translation = _mm_add_ps(translation, _mm_mul_ps(col1, _mm_shuffle_ps(row1, row1, 0xFF)));
+      translation = _mm_add_ps(translation, _mm_mul_ps(col2, _mm_shuffle_ps(row2, row2, 0xFF)));
+      translation = _mm_sub_ps(_mm_setzero_ps(), translation);
+
+      _MM_TRANSPOSE4_PS(col0, col1, col2, translation);
+      _mm_storeu_ps(result + 0, col0);
+      _mm_storeu_ps(result + 4, col1);
+      _mm_storeu_ps(result + 8, col2);
+    #else
+      const float* a0 = mat + 0;
+      const float* a1 = mat + 4;
+      const float* a2 = mat + 8;
+      float cols[3][3] {};
+      cross3(a1, a2, cols[0]);
+      cross3(a2, a0, cols[1]);
+      cross3(a0, a1, cols[2]);
+
+      const float invDet = 1.f / dot3(a0, cols[0]);
+      float inverted[12] {};
+      for (int r = 0; r < 3; r++)
+      {
+        for (int c = 0; c < 3; c++)
+        {
+          inverted[r * 4 + c] = cols[c][r] * invDet;
+        }
+      }
+      for (int r = 0; r < 3; r++)
+      {
+        inverted[r * 4 + 3] = -(inverted[r * 4 + 0] * mat[3] + inverted[r * 4 + 1] * mat[7] + inverted[r * 4 + 2] * mat[11]);
+      }
+      for (int i = 0; i < 12; i++)
+      {
+        result[i] = inverted[i];
+      }
+    #endif
+    }
+
+    /**
+     * @brief Inverts a column-major 4x4 matrix.
+     *
+     * Uses the cofactor expansion; the SSE path computes it through 2x2 block determinants.
+     *
+     * @param mat Pointer to the 16 floats of the matrix. Must be invertible.
+     * @param result Pointer to the 16 floats receiving the inverse.
+     */
+    inline void inverseMat4(const float* mat, float* result)
+    {
+    #if defined(KDR_SIMD_SSE)
+      // 2x2 row-major block products: A * B, A# * B and A * B#, where # is the adjugate.
+      const auto multiply2 = [](const __m128 a, const __m128 b) {
+        return _mm_add_ps(
+          _mm_mul_ps(a, swizzle<_MM_SHUFFLE(3, 0, 3, 0)>(b)),
+          _mm_mul_ps(swizzle<_MM_SHUFFLE(2, 3, 0, 1)>(a), swizzle<_MM_SHUFFLE(1, 2, 1, 2)>(b))
+        );
+      };
+      const auto adjMultiply2 = [](const __m128 a, const __m128 b) {
+        return _mm_sub_ps(
+          _mm_mul_ps(swizzle<_MM_SHUFFLE(0, 0, 3, 3)>(a), b),
+          _mm_mul_ps(swizzle<_MM_SHUFFLE(2, 2, 1, 1)>(a), swizzle<_MM_SHUFFLE(1, 0, 3, 2)>(b))
+        );
+      };
+      const auto multiplyAdj2 = [](const __m128 a, const __m128 b) {
+        return _mm_sub_ps(
+          _mm_mul_ps(a, swizzle<_MM_SHUFFLE(0, 3, 0, 3)>(b)),
+          _mm_mul_ps(swizzle<_MM_SHUFFLE(2, 3, 0, 1)>(a), swizzle<_MM_SHUFFLE(1, 2, 1, 2)>(b))
+        );
+      };
+
+      const __m128 col0 = _mm_loadu_ps(mat + 0);
+      const __m128 col1 = _mm_loadu_ps(mat + 4);
+      const __m128 col2 = _mm_loadu_ps(mat + 8);
+      const __m128 col3 = _mm_loadu_ps(mat + 12);
+
+      const __m128 a = _mm_movelh_ps(col0, col1);
+      const __m128 b = _mm_movehl_ps(col1, col0);
+      const __m128 c = _mm_movelh_ps(col2, col3);
+      const __m128 d = _mm_movehl_ps(col3, col2);
+
+      const __m128 detSub = _mm_sub_ps(
+        _mm_mul_ps(_mm_shuffle_ps(col0, col2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(col1, col3, _MM_SHUFFLE(3, 1, 3, 1))),
+        _mm_mul_ps(_mm_shuffle_ps(col0, col2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(col1, col3, _MM_SHUFFLE(2, 0, 2, 0)))
+      );
+      const __m128 detA = swizzle<0x00>(detSub);
+      const __m128 detB = swizzle<0x55>(detSub);
+      const __m128 detC = swizzle<0xAA>(detSub);
+      const __m128 detD = swizzle<0xFF>(detSub);
+
+      const __m128 dc = adjMultiply2(d, c);
+      const __m128 ab = adjMultiply2(a, b);
+      __m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), multiply2(b, dc));
+      __m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), multiply2(c, ab));
+      __m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), multiplyAdj2(d, ab));
+      __m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), multiplyAdj2(a, dc));
+
+      __m128 trace = _mm_mul_ps(ab, swizzle<_MM_SHUFFLE(3, 1, 2, 0)>(dc));
+      trace = _mm_add_ps(trace, swizzle<_MM_SHUFFLE(2, 3, 0, 1)>(trace));
+      trace = _mm_add_ps(trace, swizzle<_MM_SHUFFLE(1, 0, 3, 2)>(trace));
+      const __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+
+      const __m128 invDet = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), det);
+      x = _mm_mul_ps(x, invDet);
+      y = _mm_mul_ps(y, invDet);
+      z = _mm_mul_ps(z, invDet);
+      w = _mm_mul_ps(w, invDet);
+
+      _mm_storeu_ps(result + 0, _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+      _mm_storeu_ps(result + 4, _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+      _mm_storeu_ps(result + 8, _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+      _mm_storeu_ps(result + 12, _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+    #else
+      const float* m = mat;
+      float inv[16] {};
+      inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+      inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+      inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+      inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+      inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+      inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+      inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+      inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+      inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+      inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+      inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+      inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+      inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+      inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+      inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+      inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+      const float invDet = 1.f / (m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12]);
+      for (int i = 0; i < 16; i++)
+      {
+        result[i] = inv[i] * invDet;
+      }
+    #endif
+    }
+
+    /**
+     * @brief Tests structure-of-arrays bounding spheres against six frustum planes.
+     *
+     * A sphere is visible unless it lies completely behind one of the planes. The spheres are
+     * tested 8 (AVX) or 4 (SSE) at a time.
+     *
+     * @param planes Pointer to the 24 floats of the planes, each stored as (a, b, c, d) with a unit normal pointing inside.
+     * @param xs Pointer to the x components of the sphere centers.
+     * @param ys Pointer to the y components of the sphere centers.
+     * @param zs Pointer to the z components of the sphere centers.
+     * @param radii Pointer to the sphere radii.
+     * @param count The number of spheres.
+     * @param results Pointer to the bytes receiving 1 for every visible sphere and 0 otherwise.
+     */
+    inline void cullSpheres(const float* planes, const float* xs, const float* ys, const float* zs, const float* radii, const size_t count, unsigned char* results)
+    {
+      size_t i {0};
+    #if defined(KDR_SIMD_AVX)
+      for (; i + 8 <= count; i += 8)
+      {
+        const __m256 x = _mm256_loadu_ps(xs + i);
+        const __m256 y = _mm256_loadu_ps(ys + i);
+        const __m256 z = _mm256_loadu_ps(zs + i);
+        const __m256 negativeRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(radii + i));
+        __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int p = 0; p < 6; p++)
+        {
+          __m256 distance = _mm256_mul_ps(_mm256_set1_ps(planes[p * 4 + 0]), x);
+          distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes[p * 4 + 1]), y));
+          distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes[p * 4 + 2]), z));
+          distance = _mm256_add_ps(distance, _mm256_set1_ps(planes[p * 4 + 3]));
+          visible = _mm256_and_ps(visible, _mm256_cmp_ps(distance, negativeRadius, _CMP_GE_OQ));
+        }
+        const int mask = _mm256_movemask_ps(visible);
+        for (int lane = 0; lane < 8; lane++)
+        {
+          results[i + lane] = (mask >> lane) & 1;
+        }
+      }
+    #endif
+    #if defined(KDR_SIMD_SSE)
+      for (; i + 4 <= count; i += 4)
+      {
+        const __m128 x = _mm_loadu_ps(xs + i);
+        const __m128 y = _mm_loadu_ps(ys + i);
+        const __m128 z = _mm_loadu_ps(zs + i);
+        const __m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radii + i));
+        __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < 6; p++)
+        {
+          __m128 distance = _mm_mul_ps(_mm_set1_ps(planes[p * 4 + 0]), x);
+          distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes[p * 4 + 1]), y));
+          distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes[p * 4 + 2]), z));
+          distance = _mm_add_ps(distance, _mm_set1_ps(planes[p * 4 + 3]));
+          visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, negativeRadius));
+        }
+        const int mask = _mm_movemask_ps(visible);
+        for (int lane = 0; lane < 4; lane++)
+        {
+          results[i + lane] = (mask >> lane) & 1;
+        }
+      }
+    #endif
+      for (; i < count; i++)
+      {
+        bool visible {true};
+        for (int p = 0; p < 6 && visible; p++)
+        {
+          const float distance = planes[p * 4 + 0] * xs[i] + planes[p * 4 + 1] * ys[i] + planes[p * 4 + 2] * zs[i] + planes[p * 4 + 3];
+          visible = distance >= -radii[i];
+        }
+        results[i] = visible;
+      }
+    }
+
+    /**
+     * @brief Tests structure-of-arrays axis-aligned bounding boxes against six frustum planes.
+     *
+     * A box is visible unless its corner furthest along a plane normal lies behind that plane.
+     * The boxes are tested 8 (AVX) or 4 (SSE) at a time.
+     *
+     * @param planes Pointer to the 24 floats of the planes, each stored as (a, b, c, d) with a normal pointing inside.
+     * @param mins Pointers to the x, y, and z components of the minimum corners.
+     * @param maxs Pointers to the x, y, and z components of the maximum corners.
+     * @param count The number of boxes.
+     * @param results Pointer to the bytes receiving 1 for every visible box and 0 otherwise.
+     */
+    inline void cullBoxes(const float* planes, const float* const mins[3], const float* const maxs[3], const size_t count, unsigned char* results)
+    {
+      // The furthest corner along each plane normal picks max or min per axis, the same for every box
+      const float* corners[6][3] {};
+      for (int p = 0; p < 6; p++)
+      {
+        for (int axis = 0; axis < 3; axis++)
+        {
+          corners[p][axis] = planes[p * 4 + axis] >= 0.f ? maxs[axis] : mins[axis];
+        }
+      }
+
+      size_t i {0};
+    #if defined(KDR_SIMD_AVX)
+      for (; i + 8 <= count; i += 8)
+      {
+        __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int p = 0; p < 6; p++)
+        {
+          __m256 distance = _mm256_mul_ps(_mm256_set1_ps(planes[p * 4 + 0]), _mm256_loadu_ps(corners[p][0] + i));
+          distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes[p * 4 + 1]), _mm256_loadu_ps(corners[p][1] + i)));
+          distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes[p * 4 + 2]), _mm256_loadu_ps(corners[p][2] + i)));
+          distance = _mm256_add_ps(distance, _mm256_set1_ps(planes[p * 4 + 3]));
+          visible = _mm256_and_ps(visible, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GE_OQ));
+        }
+        const int mask = _mm256_movemask_ps(visible);
+        for (int lane = 0; lane < 8; lane++)
+        {
+          results[i + lane] = (mask >> lane) & 1;
+        }
+      }
+    #endif
+    #if defined(KDR_SIMD_SSE)
+      for (; i + 4 <= count; i += 4)
+      {
+        __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < 6; p++)
+        {
+          __m128 distance = _mm_mul_ps(_mm_set1_ps(planes[p * 4 + 0]), _mm_loadu_ps(corners[p][0] + i));
+          distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes[p * 4 + 1]), _mm_loadu_ps(corners[p][1] + i)));
+          distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes[p * 4 + 2]), _mm_loadu_ps(corners[p][2] + i)));
+          distance = _mm_add_ps(distance, _mm_set1_ps(planes[p * 4 + 3]));
+          visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+        }
+        const int mask = _mm_movemask_ps(visible);
+        for (int lane = 0; lane < 4; lane++)
+        {
+          results[i + lane] = (mask >> lane) & 1;
+        }
+      }
+    #endif
+      for (; i < count; i++)
+      {
+        bool visible {true};
+        for (int p = 0; p < 6 && visible; p++)
+        {
+          const float distance = planes[p * 4 + 0] * corners[p][0][i] + planes[p * 4 + 1] * corners[p][1][i] + planes[p * 4 + 2] * corners[p][2][i] + planes[p * 4 + 3];
+          visible = distance >= 0.f;
+        }
+        results[i] = visible;
+      }
+    }
+
+    /**
+     * @brief Computes the sine and cosine of an angle with a polynomial approximation.
+     *
+     * The angle is reduced to [-PI/4, PI/4] around the nearest multiple of PI/2 (Cody-Waite,
+     * three constants), where minimax polynomials of degree 7 (sine) and 8 (cosine) are evaluated.
+     * The absolute error stays below kdr::Simd::SINCOS_MAX_ERROR for |radians| <= SINCOS_MAX_RADIANS.
+     * Larger and non-finite angles would overflow the quadrant, so they go to std::sin and std::cos.
+     *
+     * @param radians The angle in radians.
+     * @param sine Reference to store the sine of the angle.
+     * @param cosine Reference to store the cosine of the angle.
+     */
+    constexpr void sinCosPolynomial(const float radians, float& sine, float& cosine)
+    {
+      // Also true for NaN
+      if (!(radians >= -kdr::Simd::SINCOS_MAX_RADIANS && radians <= kdr::Simd::SINCOS_MAX_RADIANS))
+      {
+        sine = std::sin(radians);
+        cosine = std::cos(radians);
+        return;
+      }
+      const int quadrant = static_cast<int>(radians * kdr::Simd::SINCOS_TWO_OVER_PI + (radians < 0.f ? -0.5f : 0.5f));
+      const float k = static_cast<float>(quadrant);
+      float reduced = radians - k * kdr::Simd::SINCOS_HALF_PI_A;
+      reduced = reduced - k * kdr::Simd::SINCOS_HALF_PI_B;
+      reduced = reduced - k * kdr::Simd::SINCOS_HALF_PI_C;
+      const float squared = reduced * reduced;
+
+      const float sinePolynomial = ((kdr::Simd::SINCOS_SINE_C0 * squared + kdr::Simd::SINCOS_SINE_C1) * squared + kdr::Simd::SINCOS_SINE_C2) * squared * reduced + reduced;
+      const float cosinePolynomial = ((kdr::Simd::SINCOS_COSINE_C0 * squared + kdr::Simd::SINCOS_COSINE_C1) * squared + kdr::Simd::SINCOS_COSINE_C2) * squared * squared - 0.5f * squared + 1.f;
+
+      // Quadrant 0: (s, c), 1: (c, -s), 2: (-s, -c), 3: (-c, s)
+      const bool isSwapped = (quadrant & 1) != 0;
+      const float sineBase = isSwapped ? cosinePolynomial : sinePolynomial;
+      const float cosineBase = isSwapped ? sinePolynomial : cosinePolynomial;
+      sine = (quadrant & 2) != 0 ? -sineBase : sineBase;
+      cosine = ((quadrant + 1) & 2) != 0 ? -cosineBase : cosineBase;
+    }
+
+    /**
+     * @brief Computes the sines and cosines of an array of angles with a polynomial approximation.
+     *
+     * The angles are processed 8 (AVX) or 4 (SSE) at a time with the same operations as
+     * kdr::Simd::sinCosPolynomial, so every path returns identical results. Lanes outside
+     * [-SINCOS_MAX_RADIANS, SINCOS_MAX_RADIANS] or not finite are recomputed one by one.
+     *
+     * @param radians Pointer to the angles in radians.
+     * @param sines Pointer to the floats receiving the sines.
+     * @param cosines Pointer to the floats receiving the cosines.
+     * @param count The number of angles.
+     */
+    inline void sinCos(const float* radians, float* sines, float* cosines, const size_t count)
+    {
+      size_t i {0};
+    #if defined(KDR_SIMD_AVX)
+      for (; i + 8 <= count; i += 8)
+      {
+        const __m256 angle = _mm256_loadu_ps(radians + i);
+        const __m256 signMask = _mm256_set1_ps(-0.f);
+        const __m256 half = _mm256_or_ps(_mm256_set1_ps(0.5f), _mm256_and_ps(angle, signMask));
+        const __m256 k = _mm256_round_ps(
+          _mm256_add_ps(_mm256_mul_ps(angle, _mm256_set1_ps(kdr::Simd::SINCOS_TWO_OVER_PI)), half),
+          _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC
+        );
+        __m256 reduced = _mm256_sub_ps(angle, _mm256_mul_ps(k, _mm256_set1_ps(kdr::Simd::SINCOS_HALF_PI_A)));
+        reduced = _mm256_sub_ps(reduced, _mm256_mul_ps(k, _mm256_set1_ps(kdr::Simd::SINCOS_HALF_PI_B)));
+        reduced = _mm256_sub_ps(reduced, _mm256_mul_ps(k, _mm256_set1_ps(kdr::Simd::SINCOS_HALF_PI_C)));
+        const __m256 squared = _mm256_mul_ps(reduced, reduced);
+
+        __m256 sinePolynomial = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(kdr::Simd::SINCOS_SINE_C0), squared), _mm256_set1_ps(kdr::Simd::SINCOS_SINE_C1));
+        sinePolynomial = _mm256_add_ps(_mm256_mul_ps(sinePolynomial, squared), _mm256_set1_ps(kdr::Simd::SINCOS_SINE_C2));
+        sinePolynomial = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(sinePolynomial, squared), reduced), reduced);
+        __m256 cosinePolynomial = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(kdr::Simd::SINCOS_COSINE_C0), squared), _mm256_set1_ps(kdr::Simd::SINCOS_COSINE_C1));
+        cosinePolynomial = _mm256_add_ps(_mm256_mul_ps(cosinePolynomial, squared), _mm256_set1_ps(kdr::Simd::SINCOS_COSINE_C2));
+        cosinePolynomial = _mm256_sub_ps(_mm256_mul_ps(_mm256_mul_ps(cosinePolynomial, squared), squared), _mm256_mul_ps(_mm256_set1_ps(0.5f), squared));
+        cosinePolynomial = _mm256_add_ps(cosinePolynomial, _mm256_set1_ps(1.f));
+
+        // AVX has no 256-bit integer ops, so the quadrant bits are derived from k modulo 4 in floats
+        const __m256 quadrant = _mm256_sub_ps(k, _mm256_mul_ps(_mm256_set1_ps(4.f), _mm256_floor_ps(_mm256_mul_ps(k, _mm256_set1_ps(0.25f)))));
+        const __m256 isOne = _mm256_cmp_ps(quadrant, _mm256_set1_ps(1.f), _CMP_EQ_OQ);
+        const __m256 isTwo = _mm256_cmp_ps(quadrant, _mm256_set1_ps(2.f), _CMP_EQ_OQ);
+        const __m256 isThree = _mm256_cmp_ps(quadrant, _mm256_set1_ps(3.f), _CMP_EQ_OQ);
+        const __m256 isSwapped = _mm256_or_ps(isOne, isThree);
+        const __m256 sineBase = _mm256_blendv_ps(sinePolynomial, cosinePolynomial, isSwapped);
+        const __m256 cosineBase = _mm256_blendv_ps(cosinePolynomial, sinePolynomial, isSwapped);
+        _mm256_storeu_ps(sines + i, _mm256_xor_ps(sineBase, _mm256_and_ps(_mm256_or_ps(isTwo, isThree), signMask)));
+        _mm256_storeu_ps(cosines + i, _mm256_xor_ps(cosineBase, _mm256_and_ps(_mm256_or_ps(isOne, isTwo), signMask)));
+
+        const __m256 isInRange = _mm256_cmp_ps(_mm256_andnot_ps(signMask, angle), _mm256_set1_ps(kdr::Simd::SINCOS_MAX_RADIANS), _CMP_LE_OQ);
+        const int outOfRange = ~_mm256_movemask_ps(isInRange) & 0xff;
+        for (int lane = 0; lane < 8; lane++)
+        {
+          if ((outOfRange >> lane) & 1)
+          {
+            kdr::Simd::sinCosPolynomial(radians[i + lane], sines[i + lane], cosines[i + lane]);
+          }
+        }
+      }
+    #endif
+    #if defined(KDR_SIMD_SSE)
+      for (; i + 4 <= count; i += 4)
+      {
+        const __m128 angle = _mm_loadu_ps(radians + i);
+        const __m128 signMask = _mm_set1_ps(-0.f);
+        const __m128 half = _mm_or_ps(_mm_set1_ps(0.5f), _mm_and_ps(angle, signMask));
+        const __m128i quadrant = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(angle, _mm_set1_ps(kdr::Simd::SINCOS_TWO_OVER_PI)), half));
+        const __m128 k = _mm_cvtepi32_ps(quadrant);
+        __m128 reduced = _mm_sub_ps(angle, _mm_mul_ps(k, _mm_set1_ps(kdr::Simd::SINCOS_HALF_PI_A)));
+        reduced = _mm_sub_ps(reduced, _mm_mul_ps(k, _mm_set1_ps(kdr::Simd::SINCOS_HALF_PI_B)));
+        reduced = _mm_sub_ps(reduced, _mm_mul_ps(k, _mm_set1_ps(kdr::Simd::SINCOS_HALF_PI_C)));
+        const __m128 squared = _mm_mul_ps(reduced, reduced);
+
+        __m128 sinePolynomial = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(kdr::Simd::SINCOS_SINE_C0), squared), _mm_set1_ps(kdr::Simd::SINCOS_SINE_C1));
+        sinePolynomial = _mm_add_ps(_mm_mul_ps(sinePolynomial, squared), _mm_set1_ps(kdr::Simd::SINCOS_SINE_C2));
+        sinePolynomial = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sinePolynomial, squared), reduced), reduced);
+        __m128 cosinePolynomial = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(kdr::Simd::SINCOS_COSINE_C0), squared), _mm_set1_ps(kdr::Simd::SINCOS_COSINE_C1));
+        cosinePolynomial = _mm_add_ps(_mm_mul_ps(cosinePolynomial, squared), _mm_set1_ps(kdr::Simd::SINCOS_COSINE_C2));
+        cosinePolynomial = _mm_sub_ps(_mm_mul_ps(_mm_mul_ps(cosinePolynomial, squared), squared), _mm_mul_ps(_mm_set1_ps(0.5f), squared));
+        cosinePolynomial = _mm_add_ps(cosinePolynomial, _mm_set1_ps(1.f));
+
+        // Bit 0 of the quadrant swaps sine and cosine, bit 1 (shifted into the sign bit) negates the sine
+        const __m128 isSwapped = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+        const __m128 sineBase = _mm_or_ps(_mm_and_ps(isSwapped, cosinePolynomial), _mm_andnot_ps(isSwapped, sinePolynomial));
+        const __m128 cosineBase = _mm_or_ps(_mm_and_ps(isSwapped, sinePolynomial), _mm_andnot_ps(isSwapped, cosinePolynomial));
+        const __m128 sineSign = _mm_and_ps(_mm_castsi128_ps(_mm_slli_epi32(quadrant, 30)), signMask);
+        const __m128 cosineSign = _mm_and_ps(_mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(quadrant, _mm_set1_epi32(1)), 30)), signMask);
+        _mm_storeu_ps(sines + i, _mm_xor_ps(sineBase, sineSign));
+        _mm_storeu_ps(cosines + i, _mm_xor_ps(cosineBase, cosineSign));
+
+        // _mm_cvttps_epi32 turns huge and non-finite angles into INT_MIN, so those lanes are redone
+        const __m128 isInRange = _mm_cmple_ps(_mm_andnot_ps(signMask, angle), _mm_set1_ps(kdr::Simd::SINCOS_MAX_RADIANS));
+        const int outOfRange = ~_mm_movemask_ps(isInRange) & 0xf;
+        for (int lane = 0; lane < 4; lane++)
+        {
+          if ((outOfRange >> lane) & 1)
+          {
+            kdr::Simd::sinCosPolynomial(radians[i + lane], sines[i + lane], cosines[i + lane]);
+          }
+        }
+      }
+    #endif
+      for (; i < count; i++)
+      {
+        kdr::Simd::sinCosPolynomial(radians[i], sines[i], cosines[i]);
+      }
+    }
+  }
+}
+
+#endif // KDR_SIMD_HPP
@@ -1,7 +1,13 @@
 #ifndef KDR_SOLIDS_HPP
 #define KDR_SOLIDS_HPP
 
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "Space.hpp"
+#include "Bounds.hpp"
 #include "Graphics.hpp"
 
 namespace kdr
@@ -14,6 +20,331 @@ namespace kdr
    */
   namespace Solids
   {
+    class Solid;
+
+    /**
+     * @class BoundsTable
+     * @brief Stores the world-space bounds of solid objects as structure-of-arrays.
+     *
+     * Every solid object owns a stable handle into the table. Entries are kept densely packed,
+     * so culling and spatial queries can run over plain float arrays without touching the
+     * solid objects. Transform changes only queue the entry, and flush() recomputes the
+     * queued entries in one go.
+     */
+    class BoundsTable
+    {
+      public:
+        /**
+         * @brief Adds an entry for a solid object.
+         *
+         * @param owner The solid object whose bounds are stored.
+         * @return The handle of the new entry.
+         */
+        size_t add(const kdr::Solids::Solid* owner);
+        /**
+         * @brief Removes an entry, moving the last entry into its place.
+         *
+         * @param handle The handle of the entry to remove.
+         */
+        void remove(const size_t handle);
+        /**
+         * @brief Queues an entry to have its world-space bounds recomputed.
+         *
+         * @param handle The handle of the entry.
+         */
+        void markDirty(const size_t handle);
+        /**
+         * @brief Recomputes the world-space bounds of every queued entry.
+         */
+        void flush();
+
+        /**
+         * @brief Gets the number of entries.
+         *
+         * @return The number of entries, which is also the length of every array.
+         */
+        size_t getCount() const
+        { return this->owners.size(); }
+        /**
+         * @brief Gets the array index of an entry.
+         *
+         * @param handle The handle of the entry.
+         * @return The index of the entry in the arrays.
+         */
+        size_t getIndex(const size_t handle) const
+        { return this->indices[handle]; }
+        /**
+         * @brief Gets the solid object stored at an array index.
+         *
+         * @param index The index of the entry.
+         * @return The solid object owning the entry.
+         */
+        const kdr::Solids::Solid* getOwner(const size_t index) const
+        { return this->owners[index]; }
+
+        /**
+         * @brief Gets the x components of the bounding sphere centers.
+         *
+         * @return A pointer to getCount() floats.
+         */
+        const float* getCenterXs() const
+        { return this->centerXs.data(); }
+        /**
+         * @brief Gets the y components of the bounding sphere centers.
+         *
+         * @return A pointer to getCount() floats.
+         */
+        const float* getCenterYs() const
+        { return this->centerYs.data(); }
+        /**
+         * @brief Gets the z components of the bounding sphere centers.
+         *
+         * @return A pointer to getCount() floats.
+         */
+        const float* getCenterZs() const
+        { return this->centerZs.data(); }
+        /**
+         * @brief Gets the bounding sphere radii.
+         *
+         * @return A pointer to getCount() floats.
+         */
+        const float* getRadii() const
+        { return this->radii.data(); }
+        /**
+         * @brief Gets the x components of the bounding box minimum corners.
+         *
+         * @return A pointer to getCount() floats.
+         */
+        const float* getMinXs() const
+        { return this->minXs.data(); }
+        /**
+         * @brief Gets the y components of the bounding box minimum corners.
+         *
+         * @return A pointer to getCount() floats.
+         */
+        const float* getMinYs() const
+        { return this->minYs.data(); }
+        /**
+         * @brief Gets the z components of the bounding box minimum corners.
+         *
+         * @return A pointer to getCount() floats.
+         */
+        const float* getMinZs() const
+        { return this->minZs.data(); }
+        /**
+         * @brief Gets the x components of the bounding box maximum corners.
+         *
+         * @return A pointer to getCount() floats.
+         */
+        const float* getMaxXs() const
+        { return this->maxXs.data(); }
+        /**
+         * @brief Gets the y components of the bounding box maximum corners.
+         *
+         * @return A pointer to getCount() floats.
+         */
+        const float* getMaxYs() const
+        { return this->maxYs.data(); }
+        /**
+         * @brief Gets the z components of the bounding box maximum corners.
+         *
+         * @return A pointer to getCount() floats.
+         */
+        const float* getMaxZs() const
+        { return this->maxZs.data(); }
+
+      private:
+        std::vector<const kdr::Solids::Solid*> owners;
+        std::vector<size_t> handles;
+        std::vector<size_t> indices;
+        std::vector<size_t> freeHandles;
+        std::vector<size_t> dirtyHandles;
+        std::vector<unsigned char> dirtyFlags;
+
+        std::vector<float> centerXs;
+        std::vector<float> centerYs;
+        std::vector<float> centerZs;
+        std::vector<float> radii;
+        std::vector<float> minXs;
+        std::vector<float> minYs;
+        std::vector<float> minZs;
+        std::vector<float> maxXs;
+        std::vector<float> maxYs;
+        std::vector<float> maxZs;
+    };
+
+    /**
+     * @brief Gets the bounds table shared by all solid objects.
+     *
+     * @return The shared bounds table.
+     */
+    kdr::Solids::BoundsTable& getBoundsTable();
+
+    /**
+     * @struct Mesh
+     * @brief Holds the GPU geometry of a shape.
+     *
+     * The index type and count come from the EBO, so draws use them instead of assuming
+     * 32-bit indices.
+     */
+    struct Mesh
+    {
+      kdr::Graphics::VAO* VAO {NULL};
+      kdr::Graphics::VBO* VBO {NULL};
+      kdr::Graphics::EBO* EBO {NULL};
+      GLsizei indexCount {0};
+      GLenum indexType {GL_UNSIGNED_INT};
+      GLenum mode {GL_TRIANGLES};
+      bool hasPrimitiveRestart {false};
+      GLuint firstIndex {0};
+      GLint baseVertex {0};
+
+      /**
+       * @brief Binds the VAO and sets primitive restart for drawing the mesh.
+       */
+      void Bind() const
+      {
+        this->VAO->Bind();
+        kdr::State::getCache().setPrimitiveRestart(this->hasPrimitiveRestart, kdr::Graphics::EBO::getRestartIndex(this->indexType));
+      }
+      /**
+       * @brief Checks whether the mesh can be drawn from the shared pool.
+       *
+       * The pool is drawn as one list of triangles without primitive restart, since the restart
+       * index depends on the index type of the pool.
+       *
+       * @return True if the mesh is part of the pool, false otherwise.
+       */
+      bool isPooled() const
+      { return this->mode == GL_TRIANGLES && !this->hasPrimitiveRestart; }
+    };
+
+    /**
+     * @class MeshRegistry
+     * @brief Shares GPU geometry between solid objects of the same shape.
+     *
+     * Meshes are keyed by name and reference counted. Solid objects acquire the canonical
+     * unit mesh of their shape and scale it through the model matrix, so GPU memory and
+     * construction time grow with the number of distinct shapes rather than solid objects.
+     *
+     * Besides its own buffers, every mesh also has a range in a shared pool holding all meshes
+     * in one vertex and one index buffer, so a mix of shapes can be drawn in one submission.
+     */
+    class MeshRegistry
+    {
+      public:
+        /**
+         * @brief Acquires a reference to a mesh, uploading it on first use.
+         *
+         * The vertices and indices are only read when no mesh with the key exists yet.
+         *
+         * @param key The name identifying the geometry.
+         * @param vertices The array of vertices (position, color, and texture coordinates).
+         * @param verticesSize The size (in bytes) of the vertices array.
+         * @param indices The array of indices defining the order of vertices for rendering.
+         * @param indicesSize The size (in bytes) of the indices array.
+         * @param mode The primitive type the indices describe (e.g., GL_TRIANGLE_STRIP).
+         * @param primitiveRestart Whether indices equal to kdr::Graphics::PRIMITIVE_RESTART_INDEX restart the primitive.
+         * @return The handle of the mesh.
+         */
+        size_t acquire(const std::string& key, GLfloat vertices[], GLsizeiptr verticesSize, GLuint indices[], GLsizeiptr indicesSize, const GLenum mode = GL_TRIANGLES, const bool primitiveRestart = false);
+        /**
+         * @brief Releases a reference to a mesh, deleting the geometry with the last one.
+         *
+         * @param handle The handle returned by acquire().
+         */
+        void release(const size_t handle);
+
+        /**
+         * @brief Gets a mesh.
+         *
+         * @param handle The handle returned by acquire().
+         * @return The mesh.
+         */
+        const kdr::Solids::Mesh& getMesh(const size_t handle) const
+        { return this->meshes[handle]; }
+        /**
+         * @brief Gets the number of references to a mesh.
+         *
+         * @param handle The handle returned by acquire().
+         * @return The number of solid objects sharing the mesh.
+         */
+        size_t getReferenceCount(const size_t handle) const
+        { return this->referenceCounts[handle]; }
+        /**
+         * @brief Gets the number of meshes currently uploaded.
+         *
+         * @return The number of distinct meshes with at least one reference.
+         */
+        size_t getMeshCount() const
+        { return this->handles.size(); }
+        /**
+         * @brief Gets the pool holding the geometry of all meshes.
+         *
+         * The pool is rebuilt here if meshes were added or removed since the last call, which
+         * also updates the firstIndex and baseVertex of every mesh. Meshes that are not
+         * isPooled() are left out and have to be drawn from their own buffers.
+         *
+         * @return The pooled geometry, whose indexCount covers all meshes.
+         */
+        const kdr::Solids::Mesh& getPool();
+        /**
+         * @brief Gets the vertex format meshes are stored in on the GPU.
+         *
+         * @return The vertex format.
+         */
+        const kdr::Graphics::VertexFormat& getVertexFormat() const
+        { return this->vertexFormat; }
+
+        /**
+         * @brief Sets the vertex format meshes are stored in on the GPU.
+         *
+         * Meshes that are already uploaded are uploaded again in the new format.
+         *
+         * @param vertexFormat The new vertex format.
+         */
+        void setVertexFormat(const kdr::Graphics::VertexFormat& vertexFormat);
+
+      private:
+        std::unordered_map<std::string, size_t> handles;
+        std::vector<kdr::Solids::Mesh> meshes;
+        std::vector<size_t> referenceCounts;
+        std::vector<std::string> keys;
+        std::vector<size_t> freeHandles;
+        std::vector<std::vector<GLfloat>> vertexData;
+        std::vector<std::vector<GLuint>> indexData;
+
+        kdr::Solids::Mesh pool;
+        bool isPoolDirty {true};
+        kdr::Graphics::VertexFormat vertexFormat;
+
+        /**
+         * @brief Uploads geometry into a new VAO, VBO, and EBO in the current vertex format.
+         *
+         * @param mesh The mesh receiving the buffers.
+         * @param vertices The array of source vertices (position, color, and texture coordinates).
+         * @param verticesSize The size (in bytes) of the vertices array.
+         * @param indices The array of indices.
+         * @param indicesSize The size (in bytes) of the indices array.
+         * @param mode The primitive type the indices describe.
+         * @param primitiveRestart Whether the indices contain primitive restart markers.
+         */
+        void _upload(kdr::Solids::Mesh& mesh, const GLfloat* vertices, GLsizeiptr verticesSize, const GLuint* indices, GLsizeiptr indicesSize, const GLenum mode, const bool primitiveRestart) const;
+        /**
+         * @brief Deletes the VAO, VBO, and EBO of a mesh.
+         *
+         * @param mesh The mesh whose buffers are deleted.
+         */
+        static void _destroy(kdr::Solids::Mesh& mesh);
+    };
+
+    /**
+     * @brief Gets the mesh registry shared by all solid objects.
+     *
+     * @return The shared mesh registry.
+     */
+    kdr::Solids::MeshRegistry& getMeshRegistry();
+
     /**
      * @brief Base class for solid objects in a 3D space.
      */
@@ -27,133 +358,248 @@ namespace kdr
          */
         Solid(const kdr::Space::Vec3& position)
         : position(position)
-        {
-          this->translate(position);
-        }
+        { this->boundsHandle = kdr::Solids::getBoundsTable().add(this); }
         /**
          * @brief Destructor for the Solid class.
          *
-         * Deletes associated OpenGL resources (VAO, VBO, EBO).
+         * Releases the shared mesh and the bounds table entry.
          */
         virtual ~Solid()
         {
-          this->VAO->Delete();
-          this->VBO->Delete();
-          this->EBO->Delete();
+          kdr::Solids::getBoundsTable().remove(this->boundsHandle);
+          if (this->hasMesh)
+          {
+            kdr::Solids::getMeshRegistry().release(this->meshHandle);
+          }
         }
 
         /**
-         * @brief Applies the combined model and rotation matrices to the specified shader.
+         * @brief Solid objects own their bounds entry and mesh reference, so copies would release them twice.
+         */
+        Solid(const Solid&) = delete;
+        Solid& operator=(const Solid&) = delete;
+
+        /**
+         * @brief Gets the position of the solid object.
+         *
+         * @return The position of the solid object in 3D space.
+         */
+        const kdr::Space::Vec3& getPosition() const
+        { return this->position; }
+        /**
+         * @brief Gets the rotation of the solid object.
          *
-         * This function sets the value of the "model" uniform variable in the specified shader
-         * using the solid object's internal model and rotation matrices.
+         * @return The unit quaternion representing the rotation of the solid object.
+         */
+        const kdr::Space::Quat& getRotation() const
+        { return this->rotation; }
+        /**
+         * @brief Gets the scale of the solid object.
+         *
+         * @return The scale of the solid object along the x, y, and z axes.
+         */
+        const kdr::Space::Vec3& getScale() const
+        { return this->scale; }
+        /**
+         * @brief Gets the dimensions the shared unit mesh is stretched to.
+         *
+         * @return The size of the shape along the x, y, and z axes before scaling.
+         */
+        const kdr::Space::Vec3& getDimensions() const
+        { return this->dimensions; }
+        /**
+         * @brief Gets the handle of the solid object's shared mesh.
+         *
+         * @return The handle of the mesh in kdr::Solids::getMeshRegistry().
+         */
+        size_t getMeshHandle() const
+        { return this->meshHandle; }
+        /**
+         * @brief Gets the handle of the solid object's entry in the bounds table.
          *
-         * @param shaderID The ID of the shader program.
+         * @return The handle of the entry in kdr::Solids::getBoundsTable().
          */
-        void applyModelMatrix(const GLuint shaderID) const
+        size_t getBoundsHandle() const
+        { return this->boundsHandle; }
+        /**
+         * @brief Gets the part of the bound texture array or atlas the solid object samples.
+         *
+         * @return The texture region, which covers a whole texture by default.
+         */
+        const kdr::Graphics::TextureRegion& getTextureRegion() const
+        { return this->textureRegion; }
+        /**
+         * @brief Sets the part of the bound texture array or atlas the solid object samples.
+         *
+         * Only instanced and indirect rendering read the region.
+         *
+         * @param textureRegion The texture region, e.g. from TextureArray::getRegion() or TextureAtlas::getRegion().
+         */
+        void setTextureRegion(const kdr::Graphics::TextureRegion& textureRegion)
+        { this->textureRegion = textureRegion; }
+        /**
+         * @brief Gets the bounding box of the solid object in local space.
+         *
+         * @return The axis-aligned bounding box of the vertices.
+         */
+        const kdr::Bounds::Box& getLocalBox() const
+        { return this->localBox; }
+        /**
+         * @brief Gets the bounding sphere of the solid object in local space.
+         *
+         * @return The bounding sphere of the vertices.
+         */
+        const kdr::Bounds::Sphere& getLocalSphere() const
+        { return this->localSphere; }
+        /**
+         * @brief Gets the bounding box of the solid object in world space.
+         *
+         * @return The axis-aligned box enclosing the transformed local bounding box.
+         */
+        kdr::Bounds::Box getWorldBox() const
+        { return kdr::Bounds::transform(this->getTransformMatrix(), this->localBox); }
+        /**
+         * @brief Gets the bounding sphere of the solid object in world space.
+         *
+         * @return The sphere enclosing the transformed local bounding sphere.
+         */
+        kdr::Bounds::Sphere getWorldSphere() const
+        { return kdr::Bounds::transform(this->getTransformMatrix(), this->localSphere); }
+        /**
+         * @brief Gets the transform matrix of the solid object.
+         *
+         * The matrix is built from the position, rotation, and scale and maps local space,
+         * where the shape already has its dimensions, to world space.
+         *
+         * @return The transform matrix of the solid object.
+         */
+        const kdr::Space::Mat4& getTransformMatrix() const
         {
-          GLuint location = glGetUniformLocation(shaderID, "model");
-          glUniformMatrix4fv(location, 1, GL_FALSE, kdr::Space::valuePointer(this->model * this->rotation));
+          this->_updateMatrices();
+          return this->transform;
+        }
+        /**
+         * @brief Gets the model matrix of the solid object.
+         *
+         * The model matrix is the transform matrix with the dimensions applied first, so it maps
+         * the shared unit mesh to world space. Both matrices are rebuilt only when the position,
+         * rotation, scale, or dimensions have changed since the last call.
+         *
+         * @return The model matrix of the solid object.
+         */
+        const kdr::Space::Mat4& getModelMatrix() const
+        {
+          this->_updateMatrices();
+          return this->model;
         }
 
         /**
-         * @brief Translates the solid object by the specified 3D vector.
+         * @brief Sets the position of the solid object.
          *
-         * This function updates the model matrix of the solid object by applying a translation
-         * based on the provided 3D vector.
+         * @param position The new position of the solid object in 3D space.
+         */
+        void setPosition(const kdr::Space::Vec3& position)
+        {
+          this->position = position;
+          this->isModelDirty = true;
+          kdr::Solids::getBoundsTable().markDirty(this->boundsHandle);
+        }
+        /**
+         * @brief Sets the rotation of the solid object.
          *
-         * @param vec The translation vector specifying the amount to move along each axis.
+         * @param rotation The unit quaternion representing the new rotation.
          */
-        void translate(const kdr::Space::Vec3& vec)
+        void setRotation(const kdr::Space::Quat& rotation)
         {
-          this->model = kdr::Space::translate(this->model, vec);
+          this->rotation = rotation;
+          this->isModelDirty = true;
+          kdr::Solids::getBoundsTable().markDirty(this->boundsHandle);
         }
         /**
-         * @brief Translates the solid object along the X-axis by the specified amount.
+         * @brief Sets the scale of the solid object.
+         *
+         * @param scale The new scale along the x, y, and z axes.
+         */
+        void setScale(const kdr::Space::Vec3& scale)
+        {
+          this->scale = scale;
+          this->isModelDirty = true;
+          kdr::Solids::getBoundsTable().markDirty(this->boundsHandle);
+        }
+
+        /**
+         * @brief Applies the model matrix to the specified shader.
          *
-         * This function updates the model matrix of the solid object by applying a translation
-         * along the X-axis based on the provided amount.
+         * This function sets the model matrix uniform of the specified shader to the solid
+         * object's model matrix. The upload is skipped if the shader already holds that matrix.
+         *
+         * @param shader The shader program.
+         * @param uniform The handle of the model matrix uniform.
+         */
+        void applyModelMatrix(kdr::Graphics::Shader& shader, const GLint uniform) const
+        { shader.setUniform(uniform, this->getModelMatrix()); }
+
+        /**
+         * @brief Translates the solid object by the specified 3D vector.
+         *
+         * @param vec The translation vector specifying the amount to move along each axis.
+         */
+        void translate(const kdr::Space::Vec3& vec)
+        { this->setPosition(this->position + vec); }
+        /**
+         * @brief Translates the solid object along the X-axis by the specified amount.
          *
          * @param amount The amount to move along the X-axis.
          */
         void translateX(const float amount)
-        {
-          this->model = kdr::Space::translate(this->model, {amount, 0.f, 0.f});
-        }
+        { this->translate({amount, 0.f, 0.f}); }
         /**
          * @brief Translates the solid object along the Y-axis by the specified amount.
          *
-         * This function updates the model matrix of the solid object by applying a translation
-         * along the Y-axis based on the provided amount.
-         *
          * @param amount The amount to move along the Y-axis.
          */
         void translateY(const float amount)
-        {
-          this->model = kdr::Space::translate(this->model, {0.f, amount, 0.f});
-        }
+        { this->translate({0.f, amount, 0.f}); }
         /**
          * @brief Translates the solid object along the Z-axis by the specified amount.
          *
-         * This function updates the model matrix of the solid object by applying a translation
-         * along the Z-axis based on the provided amount.
-         *
          * @param amount The amount to move along the Z-axis.
          */
         void translateZ(const float amount)
-        {
-          this->model = kdr::Space::translate(this->model, {0.f, 0.f, amount});
-        }
+        { this->translate({0.f, 0.f, amount}); }
 
         /**
          * @brief Rotates the solid object around a specified axis by a given angle.
          *
-         * This function performs a rotation transformation on the solid object's rotation matrix
-         * using the specified rotation axis and angle.
+         * This function composes the solid object's rotation quaternion with the rotation
+         * around the specified axis, keeping the result normalized.
          *
          * @param axis The axis of rotation.
          * @param degrees The angle of rotation in degrees.
          */
         void rotate(const kdr::Space::Vec3& axis, const float degrees)
-        {
-          this->rotation = kdr::Space::rotate(this->rotation, axis, degrees);
-        }
+        { this->setRotation(kdr::Space::normalize(this->rotation * kdr::Space::angleAxis(axis, degrees))); }
         /**
          * @brief Rotates the solid object around the X-axis by a given angle.
          *
-         * This function performs a rotation transformation on the solid object's rotation matrix
-         * around the X-axis by the specified angle.
-         *
          * @param degrees The angle of rotation in degrees.
          */
         void rotateX(const float degrees)
-        {
-          this->rotation = kdr::Space::rotate(this->rotation, {1.f, 0.f, 0.f}, degrees);
-        }
+        { this->rotate({1.f, 0.f, 0.f}, degrees); }
         /**
          * @brief Rotates the solid object around the Y-axis by a given angle.
          *
-         * This function performs a rotation transformation on the solid object's rotation matrix
-         * around the Y-axis by the specified angle.
-         *
          * @param degrees The angle of rotation in degrees.
          */
         void rotateY(const float degrees)
-        {
-          this->rotation = kdr::Space::rotate(this->rotation, {0.f, 1.f, 0.f}, degrees);
-        }
+        { this->rotate({0.f, 1.f, 0.f}, degrees); }
         /**
          * @brief Rotates the solid object around the Z-axis by a given angle.
          *
-         * This function performs a rotation transformation on the solid object's rotation matrix
-         * around the Z-axis by the specified angle.
-         *
          * @param degrees The angle of rotation in degrees.
          */
         void rotateZ(const float degrees)
-        {
-          this->rotation = kdr::Space::rotate(this->rotation, {0.f, 0.f, 1.f}, degrees);
-        }
+        { this->rotate({0.f, 0.f, 1.f}, degrees); }
 
         /**
          * @brief Pure virtual function to render the solid object.
@@ -163,27 +609,81 @@ namespace kdr
         virtual void render() = 0;
 
       protected:
-        kdr::Graphics::VAO* VAO {NULL};
-        kdr::Graphics::VBO* VBO {NULL};
-        kdr::Graphics::EBO* EBO {NULL};
-
         /**
-         * @brief Initializes OpenGL-related members of the solid object.
+         * @brief Initializes the shared mesh of the solid object.
          *
-         * This function initializes the Vertex Array Object (VAO), Vertex Buffer Object (VBO),
-         * and Element Buffer Object (EBO) for rendering the solid object.
+         * This function acquires the mesh with the given key from the mesh registry, uploading
+         * the unit geometry only if no other solid object uses it yet.
          *
-         * @param vertices The array of vertices defining the geometry of the solid.
+         * @param key The name identifying the unit geometry.
+         * @param vertices The array of vertices defining the unit geometry of the solid.
          * @param verticesSize The size (in bytes) of the vertices array.
          * @param indices The array of indices defining the order of vertices for rendering.
          * @param indicesSize The size (in bytes) of the indices array.
+         * @param dimensions The size the unit geometry is stretched to along each axis.
+         */
+        void initializeMesh(const std::string& key, GLfloat vertices[], GLsizeiptr verticesSize, GLuint indices[], GLsizeiptr indicesSize, const kdr::Space::Vec3& dimensions);
+        /**
+         * @brief Draws the shared mesh of the solid object.
          */
-        void initializeMembers(GLfloat vertices[], GLsizeiptr verticesSize, GLuint indices[], GLsizeiptr indicesSize);
+        void renderMesh() const
+        {
+          const kdr::Solids::Mesh& mesh = kdr::Solids::getMeshRegistry().getMesh(this->meshHandle);
+          mesh.Bind();
+          glDrawElements(mesh.mode, mesh.indexCount, mesh.indexType, NULL);
+        }
+        /**
+         * @brief Sets the local-space bounds of the solid object.
+         *
+         * Derived classes call this function from their constructors with the exact bounds of the
+         * shape at its dimensions, which the transform matrix maps to world space.
+         *
+         * @param box The axis-aligned bounding box of the vertices.
+         * @param sphere The bounding sphere of the vertices.
+         */
+        void setLocalBounds(const kdr::Bounds::Box& box, const kdr::Bounds::Sphere& sphere)
+        {
+          this->localBox = box;
+          this->localSphere = sphere;
+          kdr::Solids::getBoundsTable().markDirty(this->boundsHandle);
+        }
 
       private:
         kdr::Space::Vec3 position {0.f};
-        kdr::Space::Mat4 model {1.f};
-        kdr::Space::Mat4 rotation {1.f};
+        kdr::Space::Quat rotation {};
+        kdr::Space::Vec3 scale    {1.f};
+        kdr::Space::Vec3 dimensions {1.f};
+
+        mutable kdr::Space::Mat4 transform {1.f};
+        mutable kdr::Space::Mat4 model {1.f};
+        mutable bool isModelDirty {true};
+
+        kdr::Bounds::Box    localBox    {};
+        kdr::Bounds::Sphere localSphere {};
+        size_t boundsHandle {0};
+        size_t meshHandle {0};
+        bool hasMesh {false};
+        kdr::Graphics::TextureRegion textureRegion {};
+
+        /**
+         * @brief Rebuilds the transform and model matrices if they are out of date.
+         */
+        void _updateMatrices() const
+        {
+          if (!this->isModelDirty)
+          {
+            return;
+          }
+          this->transform = kdr::Space::compose(this->position, this->rotation, this->scale);
+          this->model = this->transform;
+          for (int r = 0; r < 3; r++)
+          {
+            this->model[0][r] *= this->dimensions.x;
+            this->model[1][r] *= this->dimensions.y;
+            this->model[2][r] *= this->dimensions.z;
+          }
+          this->isModelDirty = false;
+        }
     };
 
     /**
@@ -1,7 +1,12 @@
 #ifndef KDR_SPACE_HPP
 #define KDR_SPACE_HPP
 
+#include <atomic>
 #include <cmath>
+#include <cstddef>
+#include <limits>
+
+#include "Simd.hpp"
 
 namespace kdr
 {
@@ -14,7 +19,7 @@ namespace kdr
     /**
      * @brief The mathematical constant representing the ratio of a circle's circumference to its diameter.
      */
-    inline const float PI = 3.141593f;
+    inline constexpr float PI = 3.141593f;
 
     /**
      * @brief Converts degrees to radians.
@@ -24,9 +29,204 @@ namespace kdr
      * @param degrees The angle in degrees to be converted.
      * @return The angle in radians.
      */
-    inline float radians(const float degrees)
+    constexpr float radians(const float degrees)
     { return degrees * kdr::Space::PI / 180.f; }
 
+    /**
+     * @brief Computes the square root of a value with Newton's method.
+     *
+     * Iterates in double precision until convergence, so the rounded result matches sqrtf.
+     * Used by kdr::Space::sqrt during constant evaluation.
+     *
+     * @param value The non-negative value.
+     * @return The square root of the value.
+     */
+    constexpr double _sqrtNewton(const double value)
+    {
+      if (value == 0.0 || value != value) return value;
+      if (value < 0.0) return std::numeric_limits<double>::quiet_NaN();
+
+      double estimate = value > 1.0 ? value : 1.0;
+      double next = 0.5 * (estimate + value / estimate);
+      while (next < estimate)
+      {
+        estimate = next;
+        next = 0.5 * (estimate + value / estimate);
+      }
+      return estimate;
+    }
+    /**
+     * @brief Computes the sine and cosine of an angle with Taylor series.
+     *
+     * The angle is first reduced to [-PI, PI] in double precision, where 24 terms of each series
+     * are enough to reach double precision. Used by the trigonometric helpers during constant evaluation.
+     *
+     * @param radians The angle in radians.
+     * @param sine Reference to store the sine of the angle.
+     * @param cosine Reference to store the cosine of the angle.
+     */
+    constexpr void _sinCosTaylor(const double radians, double& sine, double& cosine)
+    {
+      constexpr double twoPi = 6.283185307179586476925286766559;
+      const double turns = radians / twoPi;
+      const double wholeTurns = static_cast<double>(static_cast<long long>(turns < 0.0 ? turns - 0.5 : turns + 0.5));
+      const double reduced = radians - wholeTurns * twoPi;
+      const double squared = reduced * reduced;
+
+      double sineTerm = reduced;
+      double cosineTerm = 1.0;
+      sine = 0.0;
+      cosine = 0.0;
+      for (int n = 0; n < 24; n++)
+      {
+        sine += sineTerm;
+        cosine += cosineTerm;
+        sineTerm *= -squared / ((2 * n + 2) * (2 * n + 3));
+        cosineTerm *= -squared / ((2 * n + 1) * (2 * n + 2));
+      }
+    }
+
+    /**
+     * @brief Computes the square root of a value.
+     *
+     * Evaluates with Newton's method in constant expressions and with sqrtf at runtime.
+     *
+     * @param value The non-negative value.
+     * @return The square root of the value.
+     */
+    constexpr float sqrt(const float value)
+    {
+      if (KDR_IS_CONSTANT_EVALUATED())
+      {
+        return static_cast<float>(kdr::Space::_sqrtNewton(value));
+      }
+      return sqrtf(value);
+    }
+    /**
+     * @brief Computes the sine of an angle.
+     *
+     * Evaluates with a Taylor series in constant expressions and with std::sin at runtime.
+     * Both agree to within 1 ulp.
+     *
+     * @param radians The angle in radians.
+     * @return The sine of the angle.
+     */
+    constexpr float sin(const float radians)
+    {
+      if (KDR_IS_CONSTANT_EVALUATED())
+      {
+        double sine {0.0};
+        double cosine {0.0};
+        kdr::Space::_sinCosTaylor(radians, sine, cosine);
+        return static_cast<float>(sine);
+      }
+      return std::sin(radians);
+    }
+    /**
+     * @brief Computes the cosine of an angle.
+     *
+     * Evaluates with a Taylor series in constant expressions and with std::cos at runtime.
+     * Both agree to within 1 ulp.
+     *
+     * @param radians The angle in radians.
+     * @return The cosine of the angle.
+     */
+    constexpr float cos(const float radians)
+    {
+      if (KDR_IS_CONSTANT_EVALUATED())
+      {
+        double sine {0.0};
+        double cosine {0.0};
+        kdr::Space::_sinCosTaylor(radians, sine, cosine);
+        return static_cast<float>(cosine);
+      }
+      return std::cos(radians);
+    }
+    /**
+     * @brief Computes the tangent of an angle.
+     *
+     * Evaluates with Taylor series in constant expressions and with std::tan at runtime.
+     * Both agree to within 1 ulp.
+     *
+     * @param radians The angle in radians.
+     * @return The tangent of the angle.
+     */
+    constexpr float tan(const float radians)
+    {
+      if (KDR_IS_CONSTANT_EVALUATED())
+      {
+        double sine {0.0};
+        double cosine {0.0};
+        kdr::Space::_sinCosTaylor(radians, sine, cosine);
+        return static_cast<float>(sine / cosine);
+      }
+      return std::tan(radians);
+    }
+
+    /**
+     * @brief Selects how the sine and cosine of angles are computed at runtime.
+     */
+    enum class TrigMode
+    {
+      Exact, ///< std::sin and std::cos, correctly rounded or within 1 ulp.
+      Fast,  ///< The vectorizable polynomial, within kdr::Simd::SINCOS_MAX_ERROR for |radians| <= 8192.
+    };
+
+    /**
+     * @brief The trigonometry mode used by the batched trigonometry at runtime.
+     *
+     * Changed through kdr::Space::setTrigMode. Atomic so the batch workers can read it while another
+     * thread switches modes; it carries no other data, so relaxed ordering is enough.
+     */
+    inline std::atomic<kdr::Space::TrigMode> _trigMode {kdr::Space::TrigMode::Exact};
+
+    /**
+     * @brief Gets the trigonometry mode used at runtime.
+     *
+     * @return The current trigonometry mode.
+     */
+    inline kdr::Space::TrigMode getTrigMode()
+    { return kdr::Space::_trigMode.load(std::memory_order_relaxed); }
+    /**
+     * @brief Sets the trigonometry mode used at runtime.
+     *
+     * The mode affects the batched kdr::Space::sincos and kdr::Space::rotateMatrices. The polynomial
+     * only pays off when it runs across SIMD lanes, so single angles (rotate, angleAxis, the camera)
+     * always use std::sin and std::cos. Constant expressions always use the exact series.
+     *
+     * @param trigMode The new trigonometry mode.
+     */
+    inline void setTrigMode(const kdr::Space::TrigMode trigMode)
+    { kdr::Space::_trigMode.store(trigMode, std::memory_order_relaxed); }
+
+    /**
+     * @brief Computes the sine and cosine of an angle together.
+     *
+     * Evaluates with a Taylor series in constant expressions and with std::sin and std::cos at
+     * runtime, whatever the trigonometry mode. A single scalar polynomial evaluation is slower than
+     * libm, so TrigMode::Fast only applies to the batched overload.
+     *
+     * @param radians The angle in radians.
+     * @param sine Reference to store the sine of the angle.
+     * @param cosine Reference to store the cosine of the angle.
+     */
+    constexpr void sincos(const float radians, float& sine, float& cosine)
+    {
+      if (KDR_IS_CONSTANT_EVALUATED())
+      {
+        double sineTaylor {0.0};
+        double cosineTaylor {0.0};
+        kdr::Space::_sinCosTaylor(radians, sineTaylor, cosineTaylor);
+        sine = static_cast<float>(sineTaylor);
+        cosine = static_cast<float>(cosineTaylor);
+      }
+      else
+      {
+        sine = std::sin(radians);
+        cosine = std::cos(radians);
+      }
+    }
+
     /**
      * @class Vec2
      * @brief Represents a 2D vector in space with x and y components.
@@ -43,7 +243,7 @@ namespace kdr
          * @param x The x component of the vector.
          * @param y The y component of the vector.
          */
-        Vec2(const float x, const float y)
+        constexpr Vec2(const float x, const float y)
         : x(x), y(y)
         {}
         /**
@@ -51,7 +251,7 @@ namespace kdr
          *
          * @param scalar The scalar value to set for both components (x, y).
          */
-        Vec2(const float scalar)
+        constexpr Vec2(const float scalar)
         : x(scalar), y(scalar)
         {}
 
@@ -64,7 +264,7 @@ namespace kdr
          * @param vec The Vec2 vector to be added.
          * @return The result of the addition operation.
          */
-        Vec2 operator+(const kdr::Space::Vec2& vec) const
+        constexpr Vec2 operator+(const kdr::Space::Vec2& vec) const
         {
           return kdr::Space::Vec2(
             this->x + vec.x,
@@ -78,7 +278,7 @@ namespace kdr
          * @param vec The Vec2 vector to be subtracted.
          * @return The result of the subtraction operation.
          */
-        Vec2 operator-(const kdr::Space::Vec2& vec) const
+        constexpr Vec2 operator-(const kdr::Space::Vec2& vec) const
         {
           return kdr::Space::Vec2(
             this->x - vec.x,
@@ -94,7 +294,7 @@ namespace kdr
          * @return The result of the multiplication operation.
          */
         template <typename T>
-        Vec2 operator*(const T scalar)
+        constexpr Vec2 operator*(const T scalar) const
         {
           return kdr::Space::Vec2(
             static_cast<float>(this->x * scalar),
@@ -111,7 +311,7 @@ namespace kdr
          * @return The result of the multiplication operation.
          */
         template <typename T>
-        friend Vec2 operator*(const T scalar, const Vec2& vec)
+        friend constexpr Vec2 operator*(const T scalar, const Vec2& vec)
         {
           return kdr::Space::Vec2(
             static_cast<float>(vec.x * scalar),
@@ -125,7 +325,7 @@ namespace kdr
          * @param vec The vector to be added.
          * @return Reference to the modified vector.
          */
-        kdr::Space::Vec2& operator+=(const kdr::Space::Vec2& vec)
+        constexpr kdr::Space::Vec2& operator+=(const kdr::Space::Vec2& vec)
         {
           this->x += vec.x;
           this->y += vec.y;
@@ -138,7 +338,7 @@ namespace kdr
          * @param vec The vector to be subtracted.
          * @return Reference to the modified vector.
          */
-        kdr::Space::Vec2& operator-=(const kdr::Space::Vec2& vec)
+        constexpr kdr::Space::Vec2& operator-=(const kdr::Space::Vec2& vec)
         {
           this->x -= vec.x;
           this->y -= vec.y;
@@ -163,7 +363,7 @@ namespace kdr
          * @param y The y component of the vector.
          * @param z The z component of the vector.
          */
-        Vec3(const float x, const float y, const float z)
+        constexpr Vec3(const float x, const float y, const float z)
         : x(x), y(y), z(z)
         {}
         /**
@@ -171,7 +371,7 @@ namespace kdr
          *
          * @param scalar The scalar value to set for all components (x, y, z).
          */
-        Vec3(const float scalar)
+        constexpr Vec3(const float scalar)
         : x(scalar), y(scalar), z(scalar)
         {}
 
@@ -185,7 +385,7 @@ namespace kdr
          * @param vec The Vec3 vector to be added.
          * @return The result of the addition operation.
          */
-        Vec3 operator+(const kdr::Space::Vec3& vec) const
+        constexpr Vec3 operator+(const kdr::Space::Vec3& vec) const
         {
           return kdr::Space::Vec3(
             this->x + vec.x,
@@ -200,7 +400,7 @@ namespace kdr
          * @param vec The Vec3 vector to be subtracted.
          * @return The result of the subtraction operation.
          */
-        Vec3 operator-(const kdr::Space::Vec3& vec) const
+        constexpr Vec3 operator-(const kdr::Space::Vec3& vec) const
         {
           return kdr::Space::Vec3(
             this->x - vec.x,
@@ -217,7 +417,7 @@ namespace kdr
          * @return The result of the multiplication operation.
          */
         template <typename T>
-        Vec3 operator*(const T scalar)
+        constexpr Vec3 operator*(const T scalar) const
         {
           return kdr::Space::Vec3(
             static_cast<float>(this->x * scalar),
@@ -235,7 +435,7 @@ namespace kdr
          * @return The result of the multiplication operation.
          */
         template <typename T>
-        friend Vec3 operator*(const T scalar, const Vec3& vec)
+        friend constexpr Vec3 operator*(const T scalar, const Vec3& vec)
         {
           return kdr::Space::Vec3(
             static_cast<float>(vec.x * scalar),
@@ -250,7 +450,7 @@ namespace kdr
          * @param vec The vector to be added.
          * @return Reference to the modified vector.
          */
-        kdr::Space::Vec3& operator+=(const kdr::Space::Vec3& vec)
+        constexpr kdr::Space::Vec3& operator+=(const kdr::Space::Vec3& vec)
         {
           this->x += vec.x;
           this->y += vec.y;
@@ -264,7 +464,7 @@ namespace kdr
          * @param vec The vector to be subtracted.
          * @return Reference to the modified vector.
          */
-        kdr::Space::Vec3& operator-=(const kdr::Space::Vec3& vec)
+        constexpr kdr::Space::Vec3& operator-=(const kdr::Space::Vec3& vec)
         {
           this->x -= vec.x;
           this->y -= vec.y;
@@ -273,6 +473,84 @@ namespace kdr
         }
     };
 
+    /**
+     * @class Vec4
+     * @brief Represents a 4D vector with x, y, z, and w components.
+     *
+     * The Vec4 class is used to represent homogeneous points and directions
+     * with float precision for the x, y, z, and w components. It is 16-byte aligned,
+     * so it fills exactly one SSE register and matches a std140/std430 vec4.
+     */
+    class alignas(16) Vec4
+    {
+      public:
+        /**
+         * @brief Constructs a Vec4 with specified x, y, z, and w components.
+         *
+         * @param x The x component of the vector.
+         * @param y The y component of the vector.
+         * @param z The z component of the vector.
+         * @param w The w component of the vector.
+         */
+        constexpr Vec4(const float x, const float y, const float z, const float w)
+        : x(x), y(y), z(z), w(w)
+        {}
+        /**
+         * @brief Constructs a Vec4 from a 3D vector and a w component.
+         *
+         * @param vec The x, y, and z components of the vector.
+         * @param w The w component of the vector.
+         */
+        constexpr Vec4(const kdr::Space::Vec3& vec, const float w)
+        : x(vec.x), y(vec.y), z(vec.z), w(w)
+        {}
+        /**
+         * @brief Constructs a Vec4 with all components set to the given scalar value.
+         *
+         * @param scalar The scalar value to set for all components (x, y, z, w).
+         */
+        constexpr Vec4(const float scalar)
+        : x(scalar), y(scalar), z(scalar), w(scalar)
+        {}
+
+        float x;
+        float y;
+        float z;
+        float w;
+
+        /**
+         * @brief Overloaded addition operator for adding two Vec4 vectors.
+         *
+         * @param vec The Vec4 vector to be added.
+         * @return The result of the addition operation.
+         */
+        constexpr Vec4 operator+(const kdr::Space::Vec4& vec) const
+        {
+          return kdr::Space::Vec4(
+            this->x + vec.x,
+            this->y + vec.y,
+            this->z + vec.z,
+            this->w + vec.w
+          );
+        }
+
+        /**
+         * @brief Overloaded subtraction operator for subtracting two Vec4 vectors.
+         *
+         * @param vec The Vec4 vector to be subtracted.
+         * @return The result of the subtraction operation.
+         */
+        constexpr Vec4 operator-(const kdr::Space::Vec4& vec) const
+        {
+          return kdr::Space::Vec4(
+            this->x - vec.x,
+            this->y - vec.y,
+            this->z - vec.z,
+            this->w - vec.w
+          );
+        }
+    };
+
     /**
      * @brief Calculates the dot product of two 2D vectors.
      *
@@ -282,7 +560,7 @@ namespace kdr
      * @param vecB The second 2D vector.
      * @return The dot product of the two vectors.
      */
-    inline float dot(const kdr::Space::Vec2& vecA, const kdr::Space::Vec2& vecB)
+    constexpr float dot(const kdr::Space::Vec2& vecA, const kdr::Space::Vec2& vecB)
     {
       return vecA.x * vecB.x + vecA.y * vecB.y;
     }
@@ -295,9 +573,13 @@ namespace kdr
      * @param vecB The second 3D vector.
      * @return The dot product of the two vectors.
      */
-    inline float dot(const kdr::Space::Vec3& vecA, const kdr::Space::Vec3& vecB)
+    constexpr float dot(const kdr::Space::Vec3& vecA, const kdr::Space::Vec3& vecB)
     {
-      return vecA.x * vecB.x + vecA.y * vecB.y + vecA.z * vecB.z;
+      if (KDR_IS_CONSTANT_EVALUATED())
+      {
+        return vecA.x * vecB.x + vecA.y * vecB.y + vecA.z * vecB.z;
+      }
+      return kdr::Simd::dot3(&vecA.x, &vecB.x);
     }
 
     /**
@@ -306,9 +588,9 @@ namespace kdr
      * @param vec The input 2D vector.
      * @return The normalized 2D vector.
      */
-    inline kdr::Space::Vec2 normalize(const kdr::Space::Vec2& vec)
+    constexpr kdr::Space::Vec2 normalize(const kdr::Space::Vec2& vec)
     {
-      float length = sqrtf(vec.x * vec.x + vec.y * vec.y);
+      const float length = kdr::Space::sqrt(vec.x * vec.x + vec.y * vec.y);
       return kdr::Space::Vec2(
         vec.x / length,
         vec.y / length
@@ -320,14 +602,20 @@ namespace kdr
      * @param vec The input 3D vector.
      * @return The normalized 3D vector.
      */
-    inline kdr::Space::Vec3 normalize(const kdr::Space::Vec3& vec)
+    constexpr kdr::Space::Vec3 normalize(const kdr::Space::Vec3& vec)
     {
-      float length = sqrtf(vec.x * vec.x + vec.y * vec.y + vec.z * vec.z);
-      return kdr::Space::Vec3(
-        vec.x / length,
-        vec.y / length,
-        vec.z / length
-      );
+      if (KDR_IS_CONSTANT_EVALUATED())
+      {
+        const float length = kdr::Space::sqrt(vec.x * vec.x + vec.y * vec.y + vec.z * vec.z);
+        return kdr::Space::Vec3(
+          vec.x / length,
+          vec.y / length,
+          vec.z / length
+        );
+      }
+      kdr::Space::Vec3 result {0.f};
+      kdr::Simd::normalize3(&vec.x, &result.x);
+      return result;
     }
 
     /**
@@ -339,22 +627,33 @@ namespace kdr
      * @param vecB The second 3D vector.
      * @return The cross product of the two vectors.
      */
-    inline kdr::Space::Vec3 cross(const kdr::Space::Vec3& vecA, const kdr::Space::Vec3& vecB)
+    constexpr kdr::Space::Vec3 cross(const kdr::Space::Vec3& vecA, const kdr::Space::Vec3& vecB)
     {
-      return kdr::Space::Vec3(
-        vecA.y * vecB.z - vecA.z * vecB.y,
-        vecA.z * vecB.x - vecA.x * vecB.z,
-        vecA.x * vecB.y - vecA.y * vecB.x
-      );
+      if (KDR_IS_CONSTANT_EVALUATED())
+      {
+        return kdr::Space::Vec3(
+          vecA.y * vecB.z - vecA.z * vecB.y,
+          vecA.z * vecB.x - vecA.x * vecB.z,
+          vecA.x * vecB.y - vecA.y * vecB.x
+        );
+      }
+      kdr::Space::Vec3 result {0.f};
+      kdr::Simd::cross3(&vecA.x, &vecB.x, &result.x);
+      return result;
     }
 
     /**
      * @class Mat4
      * @brief Represents a 4x4 matrix of floating-point numbers.
      *
-     * The Mat4 class provides a basic 4x4 matrix with elements stored in a 2D array.
+     * The Mat4 class stores its elements in column-major order: mat[c][r] is the element in
+     * column c and row r, and the translation of an affine transform lives in mat[3][0..2].
+     * This is the layout OpenGL expects, so the matrix can be passed to
+     * glUniformMatrix4fv(..., GL_FALSE, ...), copied into std140/std430 buffers, or memcpy'd
+     * into mapped GPU memory without transposing. It is 16-byte aligned, so every column is
+     * one aligned SSE load.
      */
-    class Mat4
+    class alignas(16) Mat4
     {
       public:
         /**
@@ -362,16 +661,9 @@ namespace kdr
          *
          * Initializes all elements of the matrix to 0.
          */
-        Mat4()
-        {
-          for (int y = 0; y < 4; y++)
-          {
-            for (int x = 0; x < 4; x++)
-            {
-              elements[y][x] = 0.f;
-            }
-          }
-        }
+        constexpr Mat4()
+        : elements{}
+        {}
         /**
          * @brief Constructs a 4x4 matrix with diagonal elements set to a specified value.
          *
@@ -380,38 +672,80 @@ namespace kdr
          *
          * @param diagonalValue The value to set on the diagonal elements.
          */
-        Mat4(const float diagonalValue)
-        {
-          for (int y = 0; y < 4; y++)
-          {
-            for (int x = 0; x < 4; x++)
-            {
-              elements[y][x] = x == y ? diagonalValue : 0.f;
-            }
-          }
+        constexpr Mat4(const float diagonalValue)
+        : elements{
+          {diagonalValue, 0.f, 0.f, 0.f},
+          {0.f, diagonalValue, 0.f, 0.f},
+          {0.f, 0.f, diagonalValue, 0.f},
+          {0.f, 0.f, 0.f, diagonalValue}
         }
+        {}
 
         /**
          * @brief Overloaded operator to access the elements of the matrix.
          *
          * Provides access to the elements of the matrix using the subscript operator.
          *
-         * @param index The row index.
-         * @return A pointer to the array representing the specified row of the matrix.
+         * @param index The column index.
+         * @return A pointer to the four contiguous floats of the specified column.
          */
-        float* operator[](int index)
+        constexpr float* operator[](int index)
         { return this->elements[index]; }
         /**
          * @brief Overloaded operator to access the elements of the matrix (const version).
          *
          * Provides const access to the elements of the matrix using the subscript operator.
          *
-         * @param index The row index.
-         * @return A const pointer to the array representing the specified row of the matrix.
+         * @param index The column index.
+         * @return A const pointer to the four contiguous floats of the specified column.
          */
-        const float* operator[](int index) const
+        constexpr const float* operator[](int index) const
         { return this->elements[index]; }
 
+        /**
+         * @brief Gets a column of the matrix.
+         *
+         * @param index The column index.
+         * @return The column as a 4D vector.
+         */
+        constexpr kdr::Space::Vec4 getColumn(const int index) const
+        {
+          return kdr::Space::Vec4(
+            this->elements[index][0],
+            this->elements[index][1],
+            this->elements[index][2],
+            this->elements[index][3]
+          );
+        }
+        /**
+         * @brief Gets a row of the matrix.
+         *
+         * @param index The row index.
+         * @return The row as a 4D vector.
+         */
+        constexpr kdr::Space::Vec4 getRow(const int index) const
+        {
+          return kdr::Space::Vec4(
+            this->elements[0][index],
+            this->elements[1][index],
+            this->elements[2][index],
+            this->elements[3][index]
+          );
+        }
+        /**
+         * @brief Sets a column of the matrix.
+         *
+         * @param index The column index.
+         * @param column The new column.
+         */
+        constexpr void setColumn(const int index, const kdr::Space::Vec4& column)
+        {
+          this->elements[index][0] = column.x;
+          this->elements[index][1] = column.y;
+          this->elements[index][2] = column.z;
+          this->elements[index][3] = column.w;
+        }
+
         /**
          * @brief Multiplies this matrix by another matrix.
          *
@@ -420,16 +754,51 @@ namespace kdr
          * @param mat The matrix to multiply with.
          * @return The result of the matrix multiplication.
          */
-        Mat4 operator*(const kdr::Space::Mat4& mat) const
+        constexpr Mat4 operator*(const kdr::Space::Mat4& mat) const
         {
           Mat4 result;
-          for (int i = 0; i < 4; i++) {
-            for (int j = 0; j < 4; j++) {
-              for (int k = 0; k < 4; k++) {
-                result[i][j] += mat[i][k] * elements[k][j];
+          if (KDR_IS_CONSTANT_EVALUATED())
+          {
+            for (int i = 0; i < 4; i++)
+            {
+              for (int j = 0; j < 4; j++)
+              {
+                for (int k = 0; k < 4; k++)
+                {
+                  result[i][j] += mat[i][k] * this->elements[k][j];
+                }
               }
             }
+            return result;
           }
+          kdr::Simd::multiplyMat4(&this->elements[0][0], &mat.elements[0][0], &result.elements[0][0]);
+          return result;
+        }
+        /**
+         * @brief Multiplies this matrix by a 4D column vector.
+         *
+         * This function transforms the provided vector by this matrix.
+         *
+         * @param vec The vector to transform.
+         * @return The transformed vector.
+         */
+        constexpr kdr::Space::Vec4 operator*(const kdr::Space::Vec4& vec) const
+        {
+          kdr::Space::Vec4 result {0.f};
+          if (KDR_IS_CONSTANT_EVALUATED())
+          {
+            const float components[4] {vec.x, vec.y, vec.z, vec.w};
+            float* results[4] {&result.x, &result.y, &result.z, &result.w};
+            for (int j = 0; j < 4; j++)
+            {
+              for (int k = 0; k < 4; k++)
+              {
+                *results[j] += this->elements[k][j] * components[k];
+              }
+            }
+            return result;
+          }
+          kdr::Simd::transformVec4(&this->elements[0][0], &vec.x, &result.x);
           return result;
         }
 
@@ -437,6 +806,156 @@ namespace kdr
         float elements[4][4];
     };
 
+    /**
+     * @class Affine3x4
+     * @brief Represents an affine transform as a 3x4 matrix of floating-point numbers.
+     *
+     * The Affine3x4 class stores three rows of four floats: the 3x3 linear part followed by the
+     * translation in the last column. The constant (0, 0, 0, 1) last row of a Mat4 is implicit,
+     * which saves a quarter of the memory and of the work per compose and transform.
+     */
+    class alignas(16) Affine3x4
+    {
+      public:
+        /**
+         * @brief Default constructor for Affine3x4.
+         *
+         * Initializes all elements of the matrix to 0.
+         */
+        constexpr Affine3x4()
+        : rows{}
+        {}
+        /**
+         * @brief Constructs an affine matrix with diagonal elements set to a specified value.
+         *
+         * @param diagonalValue The value to set on the diagonal of the linear part.
+         */
+        constexpr Affine3x4(const float diagonalValue)
+        : rows{
+          {diagonalValue, 0.f, 0.f, 0.f},
+          {0.f, diagonalValue, 0.f, 0.f},
+          {0.f, 0.f, diagonalValue, 0.f}
+        }
+        {}
+        /**
+         * @brief Constructs an affine matrix from the upper three rows of a 4x4 matrix.
+         *
+         * @param mat The 4x4 matrix, whose last row is assumed to be (0, 0, 0, 1).
+         */
+        constexpr explicit Affine3x4(const kdr::Space::Mat4& mat)
+        : rows{}
+        {
+          for (int r = 0; r < 3; r++)
+          {
+            for (int c = 0; c < 4; c++)
+            {
+              this->rows[r][c] = mat[c][r];
+            }
+          }
+        }
+
+        /**
+         * @brief Overloaded operator to access the rows of the matrix.
+         *
+         * @param index The row index.
+         * @return A pointer to the array representing the specified row of the matrix.
+         */
+        constexpr float* operator[](int index)
+        { return this->rows[index]; }
+        /**
+         * @brief Overloaded operator to access the rows of the matrix (const version).
+         *
+         * @param index The row index.
+         * @return A const pointer to the array representing the specified row of the matrix.
+         */
+        constexpr const float* operator[](int index) const
+        { return this->rows[index]; }
+
+        /**
+         * @brief Composes this transform with another one.
+         *
+         * The resulting transform applies the provided transform first and this one second,
+         * like the equivalent Mat4 product.
+         *
+         * @param mat The transform to compose with.
+         * @return The composed transform.
+         */
+        constexpr Affine3x4 operator*(const kdr::Space::Affine3x4& mat) const
+        {
+          Affine3x4 result;
+          if (KDR_IS_CONSTANT_EVALUATED())
+          {
+            for (int r = 0; r < 3; r++)
+            {
+              for (int c = 0; c < 4; c++)
+              {
+                const float sum = this->rows[r][0] * mat[0][c] + this->rows[r][1] * mat[1][c] + this->rows[r][2] * mat[2][c];
+                result[r][c] = c == 3 ? sum + this->rows[r][3] : sum;
+              }
+            }
+            return result;
+          }
+          kdr::Simd::multiplyAffine(&this->rows[0][0], &mat.rows[0][0], &result.rows[0][0]);
+          return result;
+        }
+
+      private:
+        float rows[3][4];
+    };
+
+    /**
+     * @class Quat
+     * @brief Represents a rotation as a unit quaternion with w, x, y, and z components.
+     *
+     * The Quat class stores an orientation in four floats instead of a full matrix. Quaternions are
+     * composed with operator* and converted to a matrix with kdr::Space::toMat4 only when needed.
+     */
+    class Quat
+    {
+      public:
+        /**
+         * @brief Constructs the identity rotation.
+         */
+        constexpr Quat()
+        : w(1.f), x(0.f), y(0.f), z(0.f)
+        {}
+        /**
+         * @brief Constructs a Quat with specified w, x, y, and z components.
+         *
+         * @param w The scalar (real) component of the quaternion.
+         * @param x The x component of the vector part.
+         * @param y The y component of the vector part.
+         * @param z The z component of the vector part.
+         */
+        constexpr Quat(const float w, const float x, const float y, const float z)
+        : w(w), x(x), y(y), z(z)
+        {}
+
+        float w;
+        float x;
+        float y;
+        float z;
+
+        /**
+         * @brief Composes this rotation with another one.
+         *
+         * The product applies the same way as multiplying the matrices built by kdr::Space::toMat4,
+         * i.e. toMat4(a * b) equals toMat4(b) * toMat4(a).
+         *
+         * @param quat The rotation to compose with.
+         * @return The composed rotation.
+         */
+        constexpr Quat operator*(const kdr::Space::Quat& quat) const
+        {
+          return kdr::Space::Quat(
+            this->w * quat.w - this->x * quat.x - this->y * quat.y - this->z * quat.z,
+            this->w * quat.x + this->x * quat.w + this->y * quat.z - this->z * quat.y,
+            this->w * quat.y - this->x * quat.z + this->y * quat.w + this->z * quat.x,
+            this->w * quat.z + this->x * quat.y - this->y * quat.x + this->z * quat.w
+          );
+        }
+    };
+
     /**
      * @brief Gets a pointer to the first element of a 4x4 matrix.
      *
@@ -447,7 +966,27 @@ namespace kdr
      * @param mat The 4x4 matrix.
      * @return A const pointer to the first element of the matrix.
      */
-    inline const float* valuePointer(const kdr::Space::Mat4& mat)
+    constexpr const float* valuePointer(const kdr::Space::Mat4& mat)
+    { return &mat[0][0]; }
+    /**
+     * @brief Gets a pointer to the first component of a 4D vector.
+     *
+     * @param vec The 4D vector.
+     * @return A const pointer to the four contiguous components x, y, z, and w.
+     */
+    constexpr const float* valuePointer(const kdr::Space::Vec4& vec)
+    { return &vec.x; }
+
+    /**
+     * @brief Gets a pointer to the first element of a 3x4 affine matrix.
+     *
+     * The elements are stored row by row, so the matrix can be uploaded to a GLSL mat4x3 with
+     * glUniformMatrix4x3fv(location, 1, GL_TRUE, valuePointer(mat)).
+     *
+     * @param mat The 3x4 affine matrix.
+     * @return A const pointer to the first element of the matrix.
+     */
+    constexpr const float* valuePointer(const kdr::Space::Affine3x4& mat)
     { return &mat[0][0]; }
 
     /**
@@ -460,7 +999,42 @@ namespace kdr
      * @param vec The translation vector representing the translation in x, y, and z directions.
      * @return The resulting matrix after translation.
      */
-    kdr::Space::Mat4 translate(const kdr::Space::Mat4& mat, const kdr::Space::Vec3& vec);
+    constexpr kdr::Space::Mat4 translate(const kdr::Space::Mat4& mat, const kdr::Space::Vec3& vec)
+    {
+      kdr::Space::Mat4 result {mat};
+      result[3][0] += vec.x;
+      result[3][1] += vec.y;
+      result[3][2] += vec.z;
+      return result;
+    }
+    /**
+     * @brief Rotates a matrix by an angle given as its sine and cosine.
+     *
+     * Shared by kdr::Space::rotate and kdr::Space::rotateMatrices.
+     *
+     * @param mat The input 4x4 matrix to be rotated.
+     * @param normalizedVec The normalized axis of rotation.
+     * @param sinTheta The sine of the angle.
+     * @param cosTheta The cosine of the angle.
+     * @return The rotated 4x4 matrix.
+     */
+    constexpr kdr::Space::Mat4 _rotate(const kdr::Space::Mat4& mat, const kdr::Space::Vec3& normalizedVec, const float sinTheta, const float cosTheta)
+    {
+      kdr::Space::Mat4 viewMat {mat};
+      const float oneMinusCosTheta = 1 - cosTheta;
+
+      viewMat[0][0] = cosTheta + normalizedVec.x * normalizedVec.x * oneMinusCosTheta;
+      viewMat[0][1] = normalizedVec.x * normalizedVec.y * oneMinusCosTheta - normalizedVec.z * sinTheta;
+      viewMat[0][2] = normalizedVec.x * normalizedVec.z * oneMinusCosTheta + normalizedVec.y * sinTheta;
+      viewMat[1][0] = normalizedVec.y * normalizedVec.x * oneMinusCosTheta + normalizedVec.z * sinTheta;
+      viewMat[1][1] = cosTheta + normalizedVec.y * normalizedVec.y * oneMinusCosTheta;
+      viewMat[1][2] = normalizedVec.y * normalizedVec.z * oneMinusCosTheta - normalizedVec.x * sinTheta;
+      viewMat[2][0] = normalizedVec.z * normalizedVec.x * oneMinusCosTheta - normalizedVec.y * sinTheta;
+      viewMat[2][1] = normalizedVec.z * normalizedVec.y * oneMinusCosTheta + normalizedVec.x * sinTheta;
+      viewMat[2][2] = cosTheta + normalizedVec.z * normalizedVec.z * oneMinusCosTheta;
+
+      return viewMat * mat;
+    }
     /**
      * @brief Rotates a 4x4 matrix around a specified axis by a given angle.
      *
@@ -473,7 +1047,13 @@ namespace kdr
      *
      * @return The rotated 4x4 matrix.
      */
-    kdr::Space::Mat4 rotate(const kdr::Space::Mat4& mat, const kdr::Space::Vec3& vec, const float angle);
+    constexpr kdr::Space::Mat4 rotate(const kdr::Space::Mat4& mat, const kdr::Space::Vec3& vec, const float angle)
+    {
+      float sinTheta {0.f};
+      float cosTheta {0.f};
+      kdr::Space::sincos(kdr::Space::radians(angle), sinTheta, cosTheta);
+      return kdr::Space::_rotate(mat, kdr::Space::normalize(vec), sinTheta, cosTheta);
+    }
     /**
      * @brief Creates a perspective projection matrix.
      *
@@ -485,7 +1065,19 @@ namespace kdr
      * @param zFar The distance to the far clipping plane.
      * @return The perspective projection matrix.
      */
-    kdr::Space::Mat4 perspective(const float fov, const float aspect, const float zNear, const float zFar);
+    constexpr kdr::Space::Mat4 perspective(const float fov, const float aspect, const float zNear, const float zFar)
+    {
+      kdr::Space::Mat4 result;
+      const float halfTanFOV = kdr::Space::tan(kdr::Space::radians(fov)) / 2.f;
+
+      result[0][0] = 1.f / (halfTanFOV * aspect);
+      result[1][1] = 1.f / halfTanFOV;
+      result[2][2] = (zFar + zNear) / (zNear - zFar);
+      result[2][3] = -1.f;
+      result[3][2] = -(2.f * zFar * zNear) / (zFar - zNear);
+
+      return result;
+    }
     /**
      * @brief Creates a view matrix using the lookAt transformation.
      *
@@ -497,7 +1089,346 @@ namespace kdr
      * @param up The up vector indicating the camera's orientation.
      * @return The view matrix.
      */
-    kdr::Space::Mat4 lookAt(const kdr::Space::Vec3& eye, const kdr::Space::Vec3& target, const kdr::Space::Vec3& up);
+    constexpr kdr::Space::Mat4 lookAt(const kdr::Space::Vec3& eye, const kdr::Space::Vec3& target, const kdr::Space::Vec3& up)
+    {
+      const kdr::Space::Vec3 front = kdr::Space::normalize(eye - target);
+      const kdr::Space::Vec3 right = kdr::Space::normalize(kdr::Space::cross(up, front));
+      const kdr::Space::Vec3 newUp = kdr::Space::cross(front, right);
+      kdr::Space::Mat4 result;
+
+      result[0][0] = right.x;
+      result[1][0] = right.y;
+      result[2][0] = right.z;
+      result[0][1] = newUp.x;
+      result[1][1] = newUp.y;
+      result[2][1] = newUp.z;
+      result[0][2] = front.x;
+      result[1][2] = front.y;
+      result[2][2] = front.z;
+      result[3][0] = -kdr::Space::dot(right, eye);
+      result[3][1] = -kdr::Space::dot(newUp, eye);
+      result[3][2] = -kdr::Space::dot(front, eye);
+      result[3][3] = 1.f;
+
+      return result;
+    }
+    /**
+     * @brief Normalizes a quaternion.
+     *
+     * @param quat The input quaternion.
+     * @return The unit quaternion.
+     */
+    constexpr kdr::Space::Quat normalize(const kdr::Space::Quat& quat)
+    {
+      const float length = kdr::Space::sqrt(quat.w * quat.w + quat.x * quat.x + quat.y * quat.y + quat.z * quat.z);
+      return kdr::Space::Quat(
+        quat.w / length,
+        quat.x / length,
+        quat.y / length,
+        quat.z / length
+      );
+    }
+    /**
+     * @brief Creates a quaternion rotating around a specified axis by a given angle.
+     *
+     * The resulting rotation matches the one applied by kdr::Space::rotate with the same arguments.
+     *
+     * @param axis The axis of rotation.
+     * @param angle The angle of rotation in degrees.
+     * @return The unit quaternion representing the rotation.
+     */
+    constexpr kdr::Space::Quat angleAxis(const kdr::Space::Vec3& axis, const float angle)
+    {
+      const kdr::Space::Vec3 normalizedAxis = kdr::Space::normalize(axis);
+      float sinHalfAngle {0.f};
+      float cosHalfAngle {0.f};
+      kdr::Space::sincos(kdr::Space::radians(angle) / 2.f, sinHalfAngle, cosHalfAngle);
+      return kdr::Space::Quat(
+        cosHalfAngle,
+        normalizedAxis.x * sinHalfAngle,
+        normalizedAxis.y * sinHalfAngle,
+        normalizedAxis.z * sinHalfAngle
+      );
+    }
+    /**
+     * @brief Creates a model matrix from a translation, a rotation, and a scale.
+     *
+     * This function builds the matrix directly, which is equivalent to (but much cheaper than)
+     * translating an identity matrix, multiplying it by the rotation matrix, and then by a scale matrix.
+     *
+     * @param translation The translation in x, y, and z directions.
+     * @param rotation The unit quaternion representing the rotation.
+     * @param scale The scale along the x, y, and z axes.
+     * @return The resulting model matrix.
+     */
+    constexpr kdr::Space::Mat4 compose(const kdr::Space::Vec3& translation, const kdr::Space::Quat& rotation, const kdr::Space::Vec3& scale)
+    {
+      const float xx = rotation.x * rotation.x;
+      const float yy = rotation.y * rotation.y;
+      const float zz = rotation.z * rotation.z;
+      const float xy = rotation.x * rotation.y;
+      const float xz = rotation.x * rotation.z;
+      const float yz = rotation.y * rotation.z;
+      const float wx = rotation.w * rotation.x;
+      const float wy = rotation.w * rotation.y;
+      const float wz = rotation.w * rotation.z;
+      kdr::Space::Mat4 result;
+
+      result[0][0] = (1.f - 2.f * (yy + zz)) * scale.x;
+      result[0][1] = 2.f * (xy - wz) * scale.x;
+      result[0][2] = 2.f * (xz + wy) * scale.x;
+      result[1][0] = 2.f * (xy + wz) * scale.y;
+      result[1][1] = (1.f - 2.f * (xx + zz)) * scale.y;
+      result[1][2] = 2.f * (yz - wx) * scale.y;
+      result[2][0] = 2.f * (xz - wy) * scale.z;
+      result[2][1] = 2.f * (yz + wx) * scale.z;
+      result[2][2] = (1.f - 2.f * (xx + yy)) * scale.z;
+      result[3][0] = translation.x;
+      result[3][1] = translation.y;
+      result[3][2] = translation.z;
+      result[3][3] = 1.f;
+
+      return result;
+    }
+    /**
+     * @brief Converts a quaternion to a rotation matrix.
+     *
+     * @param quat The unit quaternion.
+     * @return The rotation matrix, laid out like the ones built by kdr::Space::rotate.
+     */
+    constexpr kdr::Space::Mat4 toMat4(const kdr::Space::Quat& quat)
+    { return kdr::Space::compose({0.f}, quat, {1.f}); }
+
+    /**
+     * @brief Converts a 3x4 affine matrix to a 4x4 matrix.
+     *
+     * @param mat The 3x4 affine matrix.
+     * @return The 4x4 matrix with a (0, 0, 0, 1) last row.
+     */
+    constexpr kdr::Space::Mat4 toMat4(const kdr::Space::Affine3x4& mat)
+    {
+      kdr::Space::Mat4 result {1.f};
+      for (int r = 0; r < 3; r++)
+      {
+        for (int c = 0; c < 4; c++)
+        {
+          result[c][r] = mat[r][c];
+        }
+      }
+      return result;
+    }
+    /**
+     * @brief Transforms a point by a 3x4 affine matrix, applying its translation.
+     *
+     * @param mat The 3x4 affine matrix.
+     * @param point The point to transform.
+     * @return The transformed point.
+     */
+    constexpr kdr::Space::Vec3 transformPoint(const kdr::Space::Affine3x4& mat, const kdr::Space::Vec3& point)
+    {
+      if (KDR_IS_CONSTANT_EVALUATED())
+      {
+        return kdr::Space::Vec3(
+          mat[0][0] * point.x + mat[0][1] * point.y + mat[0][2] * point.z + mat[0][3],
+          mat[1][0] * point.x + mat[1][1] * point.y + mat[1][2] * point.z + mat[1][3],
+          mat[2][0] * point.x + mat[2][1] * point.y + mat[2][2] * point.z + mat[2][3]
+        );
+      }
+      kdr::Space::Vec3 result {0.f};
+      kdr::Simd::transformAffine(&mat[0][0], &point.x, 1.f, &result.x);
+      return result;
+    }
+    /**
+     * @brief Transforms a direction by a 3x4 affine matrix, ignoring its translation.
+     *
+     * @param mat The 3x4 affine matrix.
+     * @param direction The direction to transform.
+     * @return The transformed direction.
+     */
+    constexpr kdr::Space::Vec3 transformDirection(const kdr::Space::Affine3x4& mat, const kdr::Space::Vec3& direction)
+    {
+      if (KDR_IS_CONSTANT_EVALUATED())
+      {
+        return kdr::Space::Vec3(
+          mat[0][0] * direction.x + mat[0][1] * direction.y + mat[0][2] * direction.z,
+          mat[1][0] * direction.x + mat[1][1] * direction.y + mat[1][2] * direction.z,
+          mat[2][0] * direction.x + mat[2][1] * direction.y + mat[2][2] * direction.z
+        );
+      }
+      kdr::Space::Vec3 result {0.f};
+      kdr::Simd::transformAffine(&mat[0][0], &direction.x, 0.f, &result.x);
+      return result;
+    }
+    /**
+     * @brief Inverts a 3x4 affine matrix.
+     *
+     * Uses the closed form inv([A | t]) = [inv(A) | -inv(A) * t], which is much cheaper than a general
+     * 4x4 inverse. The linear part must be invertible.
+     *
+     * @param mat The 3x4 affine matrix.
+     * @return The inverse transform.
+     */
+    constexpr kdr::Space::Affine3x4 inverse(const kdr::Space::Affine3x4& mat)
+    {
+      kdr::Space::Affine3x4 result;
+      if (KDR_IS_CONSTANT_EVALUATED())
+      {
+        const kdr::Space::Vec3 row0 {mat[0][0], mat[0][1], mat[0][2]};
+        const kdr::Space::Vec3 row1 {mat[1][0], mat[1][1], mat[1][2]};
+        const kdr::Space::Vec3 row2 {mat[2][0], mat[2][1], mat[2][2]};
+        const kdr::Space::Vec3 cols[3] {
+          kdr::Space::cross(row1, row2),
+          kdr::Space::cross(row2, row0),
+          kdr::Space::cross(row0, row1)
+        };
+        const float invDet = 1.f / kdr::Space::dot(row0, cols[0]);
+        for (int c = 0; c < 3; c++)
+        {
+          result[0][c] = cols[c].x * invDet;
+          result[1][c] = cols[c].y * invDet;
+          result[2][c] = cols[c].z * invDet;
+        }
+        for (int r = 0; r < 3; r++)
+        {
+          result[r][3] = -(result[r][0] * mat[0][3] + result[r][1] * mat[1][3] + result[r][2] * mat[2][3]);
+        }
+        return result;
+      }
+      kdr::Simd::inverseAffine(&mat[0][0], &result[0][0]);
+      return result;
+    }
+    /**
+     * @brief Inverts a 4x4 matrix.
+     *
+     * Prefer the Affine3x4 overload for affine transforms; this one handles any invertible matrix,
+     * including projections.
+     *
+     * @param mat The 4x4 matrix. Must be invertible.
+     * @return The inverse matrix.
+     */
+    constexpr kdr::Space::Mat4 inverse(const kdr::Space::Mat4& mat)
+    {
+      kdr::Space::Mat4 result;
+      if (KDR_IS_CONSTANT_EVALUATED())
+      {
+        // Cofactor expansion, with c(i, j) = 3x3 minor determinant of mat without column i and row j
+        const auto minor = [&mat](const int col, const int row) {
+          int cols[3] {};
+          int rows[3] {};
+          for (int i = 0, c = 0, r = 0; i < 4; i++)
+          {
+            if (i != col) cols[c++] = i;
+            if (i != row) rows[r++] = i;
+          }
+          return
+            mat[cols[0]][rows[0]] * (mat[cols[1]][rows[1]] * mat[cols[2]][rows[2]] - mat[cols[2]][rows[1]] * mat[cols[1]][rows[2]]) -
+            mat[cols[1]][rows[0]] * (mat[cols[0]][rows[1]] * mat[cols[2]][rows[2]] - mat[cols[2]][rows[1]] * mat[cols[0]][rows[2]]) +
+            mat[cols[2]][rows[0]] * (mat[cols[0]][rows[1]] * mat[cols[1]][rows[2]] - mat[cols[1]][rows[1]] * mat[cols[0]][rows[2]]);
+        };
+        float det {0.f};
+        for (int c = 0; c < 4; c++)
+        {
+          det += mat[c][0] * minor(c, 0) * (c % 2 == 0 ? 1.f : -1.f);
+        }
+        for (int c = 0; c < 4; c++)
+        {
+          for (int r = 0; r < 4; r++)
+          {
+            result[c][r] = minor(r, c) * ((c + r) % 2 == 0 ? 1.f : -1.f) / det;
+          }
+        }
+        return result;
+      }
+      kdr::Simd::inverseMat4(&mat[0][0], &result[0][0]);
+      return result;
+    }
+
+    /**
+     * @brief Composes two packed arrays of matrices pairwise.
+     *
+     * Computes result[i] = lhs[i] * rhs[i] for every index, e.g. parent * local model matrices.
+     * The work is optionally split across threads. Like every batched function here, the chunks run
+     * on a persistent worker pool, capped at the hardware concurrency; batches too small to amortize
+     * the hand-off run on the calling thread.
+     *
+     * @param lhs The packed array of left matrices.
+     * @param rhs The packed array of right matrices.
+     * @param result The packed array receiving the products. May alias neither input.
+     * @param count The number of matrices in every array.
+     * @param threadCount The number of threads to split the work across.
+     */
+    void composeMatrices(const kdr::Space::Mat4* lhs, const kdr::Space::Mat4* rhs, kdr::Space::Mat4* result, const size_t count, const unsigned int threadCount = 1);
+    /**
+     * @brief Multiplies a packed array of matrices by one shared matrix.
+     *
+     * Computes result[i] = mat * mats[i] for every index, e.g. a shared view-projection matrix
+     * applied to every model matrix. The work is optionally split across threads.
+     *
+     * @param mat The shared left matrix.
+     * @param mats The packed array of right matrices.
+     * @param result The packed array receiving the products. May not alias the inputs.
+     * @param count The number of matrices.
+     * @param threadCount The number of threads to split the work across.
+     */
+    void multiplyMatrices(const kdr::Space::Mat4& mat, const kdr::Space::Mat4* mats, kdr::Space::Mat4* result, const size_t count, const unsigned int threadCount = 1);
+    /**
+     * @brief Translates a packed array of matrices by structure-of-arrays offsets.
+     *
+     * The batched counterpart of kdr::Space::translate, computing result[i] = translate(mats[i], {xs[i], ys[i], zs[i]}).
+     *
+     * @param mats The packed array of matrices to translate.
+     * @param xs The translations along the x-axis.
+     * @param ys The translations along the y-axis.
+     * @param zs The translations along the z-axis.
+     * @param result The packed array receiving the translated matrices. May be the same array as mats.
+     * @param count The number of matrices.
+     * @param threadCount The number of threads to split the work across.
+     */
+    void translateMatrices(const kdr::Space::Mat4* mats, const float* xs, const float* ys, const float* zs, kdr::Space::Mat4* result, const size_t count, const unsigned int threadCount = 1);
+    /**
+     * @brief Transforms structure-of-arrays points by one matrix.
+     *
+     * Every point is treated as (x, y, z, 1) and the resulting w component is discarded.
+     * The input and output arrays may be the same.
+     *
+     * @param mat The transformation matrix.
+     * @param xs The x components of the points.
+     * @param ys The y components of the points.
+     * @param zs The z components of the points.
+     * @param outXs The x components receiving the transformed points.
+     * @param outYs The y components receiving the transformed points.
+     * @param outZs The z components receiving the transformed points.
+     * @param count The number of points.
+     * @param threadCount The number of threads to split the work across.
+     */
+    void transformPoints(const kdr::Space::Mat4& mat, const float* xs, const float* ys, const float* zs, float* outXs, float* outYs, float* outZs, const size_t count, const unsigned int threadCount = 1);
+    /**
+     * @brief Computes the sines and cosines of an array of angles.
+     *
+     * The batched counterpart of kdr::Space::sincos. In TrigMode::Fast the angles go through the
+     * SIMD polynomial kernel, in TrigMode::Exact through std::sin and std::cos.
+     *
+     * @param radians The angles in radians.
+     * @param sines The floats receiving the sines.
+     * @param cosines The floats receiving the cosines.
+     * @param count The number of angles.
+     * @param threadCount The number of threads to split the work across.
+     */
+    void sincos(const float* radians, float* sines, float* cosines, const size_t count, const unsigned int threadCount = 1);
+    /**
+     * @brief Rotates a packed array of matrices around one axis by per-matrix angles.
+     *
+     * The batched counterpart of kdr::Space::rotate, computing result[i] = rotate(mats[i], axis, angles[i]).
+     * The sines and cosines are computed in SIMD batches when the trigonometry mode is TrigMode::Fast.
+     *
+     * @param mats The packed array of matrices to rotate.
+     * @param axis The axis of rotation.
+     * @param angles The angles of rotation in degrees.
+     * @param result The packed array receiving the rotated matrices. May be the same array as mats.
+     * @param count The number of matrices.
+     * @param threadCount The number of threads to split the work across.
+     */
+    void rotateMatrices(const kdr::Space::Mat4* mats, const kdr::Space::Vec3& axis, const float* angles, kdr::Space::Mat4* result, const size_t count, const unsigned int threadCount = 1);
   }
 }
 
@@ -0,0 +1,254 @@
+#ifndef KDR_STATE_HPP
+#define KDR_STATE_HPP
+
+#include <GL/glew.h>
+#include <cstddef>
+
+namespace kdr
+{
+  /**
+   * @namespace State
+   * @brief Contains the tracked OpenGL state layer.
+   *
+   * This namespace mirrors the OpenGL state the engine touches, so binds and state changes
+   * that would not change anything are dropped before they reach the driver.
+   */
+  namespace State
+  {
+    /**
+     * @brief The number of texture units tracked by the state cache.
+     */
+    constexpr size_t TEXTURE_UNIT_COUNT {32};
+
+    /**
+     * @struct DepthState
+     * @brief Holds the depth test configuration.
+     */
+    struct DepthState
+    {
+      bool test {true};
+      bool write {true};
+      GLenum func {GL_LESS};
+    };
+
+    /**
+     * @struct CullState
+     * @brief Holds the face culling configuration.
+     */
+    struct CullState
+    {
+      bool enabled {true};
+      GLenum face {GL_BACK};
+      GLenum frontFace {GL_CCW};
+    };
+
+    /**
+     * @struct BlendState
+     * @brief Holds the color blending configuration.
+     */
+    struct BlendState
+    {
+      bool enabled {false};
+      GLenum srcFactor {GL_SRC_ALPHA};
+      GLenum dstFactor {GL_ONE_MINUS_SRC_ALPHA};
+      GLenum equation {GL_FUNC_ADD};
+    };
+
+    /**
+     * @struct RenderState
+     * @brief Bundles the fixed-function state a draw depends on.
+     *
+     * The defaults enable depth testing and back-face culling with blending off and filled
+     * polygons, matching what kdr::Window sets up at startup.
+     */
+    struct RenderState
+    {
+      kdr::State::DepthState depth;
+      kdr::State::CullState cull;
+      kdr::State::BlendState blend;
+      GLenum polygonMode {GL_FILL};
+    };
+
+    /**
+     * @class Cache
+     * @brief Tracks the current OpenGL state and skips redundant state changes.
+     *
+     * The cache starts out with the OpenGL defaults of a fresh context. Every change routed
+     * through it is compared against the tracked value first and only issued when it differs.
+     * Code that changes the same state with raw OpenGL calls must call invalidate() afterwards.
+     */
+    class Cache
+    {
+      public:
+        /**
+         * @brief Gets the number of state changes issued to OpenGL.
+         *
+         * @return The number of issued state changes since the last resetCounters() call.
+         */
+        size_t getIssuedCount() const
+        { return this->issuedCount; }
+        /**
+         * @brief Gets the number of state changes dropped as redundant.
+         *
+         * @return The number of skipped state changes since the last resetCounters() call.
+         */
+        size_t getSkippedCount() const
+        { return this->skippedCount; }
+        /**
+         * @brief Resets the issued and skipped counters.
+         */
+        void resetCounters()
+        {
+          this->issuedCount = 0;
+          this->skippedCount = 0;
+        }
+
+        /**
+         * @brief Makes a shader program current.
+         *
+         * @param program The OpenGL ID of the program.
+         */
+        void useProgram(const GLuint program);
+        /**
+         * @brief Binds a vertex array object.
+         *
+         * @param vertexArray The OpenGL ID of the vertex array object.
+         */
+        void bindVertexArray(const GLuint vertexArray);
+        /**
+         * @brief Selects the active texture unit.
+         *
+         * @param unit The texture unit (e.g., GL_TEXTURE0).
+         */
+        void activeTexture(const GLenum unit);
+        /**
+         * @brief Binds a texture to the active texture unit.
+         *
+         * @param target The target of the texture (e.g., GL_TEXTURE_2D).
+         * @param texture The OpenGL ID of the texture.
+         */
+        void bindTexture(const GLenum target, const GLuint texture);
+
+        /**
+         * @brief Sets the depth test configuration.
+         *
+         * @param depth The depth state to apply.
+         */
+        void setDepthState(const kdr::State::DepthState& depth);
+        /**
+         * @brief Sets the face culling configuration.
+         *
+         * @param cull The cull state to apply.
+         */
+        void setCullState(const kdr::State::CullState& cull);
+        /**
+         * @brief Sets the color blending configuration.
+         *
+         * @param blend The blend state to apply.
+         */
+        void setBlendState(const kdr::State::BlendState& blend);
+        /**
+         * @brief Sets the polygon rasterization mode of front and back faces.
+         *
+         * @param mode The polygon mode (GL_POINT, GL_LINE, or GL_FILL).
+         */
+        void setPolygonMode(const GLenum mode);
+        /**
+         * @brief Sets whether primitive restart is enabled and which index marks a restart.
+         *
+         * @param enabled Whether primitive restart is enabled.
+         * @param index The restart index, only changed while primitive restart is enabled.
+         */
+        void setPrimitiveRestart(const bool enabled, const GLuint index);
+        /**
+         * @brief Applies a bundle of fixed-function state.
+         *
+         * Only the parts that differ from the tracked state are issued.
+         *
+         * @param state The render state to apply.
+         */
+        void apply(const kdr::State::RenderState& state);
+
+        /**
+         * @brief Forgets a deleted program, which OpenGL unbinds implicitly.
+         *
+         * @param program The OpenGL ID of the deleted program.
+         */
+        void releaseProgram(const GLuint program);
+        /**
+         * @brief Forgets a deleted vertex array object, which OpenGL unbinds implicitly.
+         *
+         * @param vertexArray The OpenGL ID of the deleted vertex array object.
+         */
+        void releaseVertexArray(const GLuint vertexArray);
+        /**
+         * @brief Forgets a deleted texture, which OpenGL unbinds from every unit implicitly.
+         *
+         * @param texture The OpenGL ID of the deleted texture.
+         */
+        void releaseTexture(const GLuint texture);
+        /**
+         * @brief Resynchronizes the cache after raw OpenGL state changes.
+         *
+         * The tracked fixed-function state is issued again and the bound objects are forgotten,
+         * so the next bind of each is sent to OpenGL.
+         */
+        void invalidate();
+
+      private:
+        /**
+         * @brief The value tracked for objects whose binding is unknown; never a valid OpenGL name.
+         */
+        static constexpr GLuint UNKNOWN_NAME {static_cast<GLuint>(-1)};
+
+        struct TextureBinding
+        {
+          GLenum target {GL_TEXTURE_2D};
+          GLuint texture {0};
+        };
+
+        GLuint program {0};
+        GLuint vertexArray {0};
+        GLenum textureUnit {GL_TEXTURE0};
+        TextureBinding textures[kdr::State::TEXTURE_UNIT_COUNT];
+        kdr::State::RenderState renderState {{false, true, GL_LESS}, {false, GL_BACK, GL_CCW}, {false, GL_ONE, GL_ZERO, GL_FUNC_ADD}, GL_FILL};
+        bool isPrimitiveRestartEnabled {false};
+        GLuint primitiveRestartIndex {0};
+
+        size_t issuedCount {0};
+        size_t skippedCount {0};
+
+        /**
+         * @brief Decides whether a tracked value has to be sent to OpenGL and updates it.
+         *
+         * @tparam T The type of the tracked value.
+         * @param current The tracked value.
+         * @param value The requested value.
+         * @return True if the change must be issued, false if it is redundant.
+         */
+        template <typename T>
+        bool _change(T& current, const T& value)
+        {
+          if (current == value)
+          {
+            this->skippedCount++;
+            return false;
+          }
+          current = value;
+          this->issuedCount++;
+          return true;
+        }
+    };
+
+    /**
+     * @brief Gets the state cache of the current OpenGL context.
+     *
+     * The engine uses a single context, so one cache is shared by everything that binds state.
+     *
+     * @return The shared state cache.
+     */
+    kdr::State::Cache& getCache();
+  }
+}
+
+#endif // KDR_STATE_HPP
@@ -5,14 +5,30 @@
 #include <GLFW/glfw3.h>
 #include <iostream>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "Color.hpp"
 #include "Graphics.hpp"
 #include "Solids.hpp"
 #include "Camera.hpp"
+#include "Culling.hpp"
 
 namespace kdr
 {
+  /**
+   * @brief The size (in bytes) of the per-frame region of the instance stream buffer.
+   */
+  constexpr GLsizeiptr INSTANCE_BUFFER_REGION_SIZE {4 * 1024 * 1024};
+  /**
+   * @brief The size (in bytes) of the per-frame region of the indirect command stream buffer.
+   */
+  constexpr GLsizeiptr INDIRECT_BUFFER_REGION_SIZE {64 * 1024};
+  /**
+   * @brief The size (in bytes) of GPU memory the texture cache evicts unused textures to stay under.
+   */
+  constexpr size_t TEXTURE_CACHE_MEMORY_BUDGET {256 * 1024 * 1024};
+
   /**
    * @struct WindowProps
    * @brief Holds properties for window creation.
@@ -146,6 +162,42 @@ namespace kdr
        */
       kdr::Camera* getBoundCamera() const
       { return this->boundCamera; }
+      /**
+       * @brief Gets the currently bound shader.
+       *
+       * @return A pointer to the bound shader, or NULL if no shader has been bound.
+       */
+      kdr::Graphics::Shader* getBoundShader() const
+      { return this->boundShader; }
+      /**
+       * @brief Gets the texture cache of the window.
+       *
+       * Textures acquired from the cache are shared by path and sampling and loaded in the
+       * background, see kdr::Graphics::TextureCache.
+       *
+       * @return The texture cache.
+       */
+      kdr::Graphics::TextureCache& getTextureCache()
+      { return *this->textureCache; }
+      /**
+       * @brief Gets the shader compiler of the window.
+       *
+       * Shaders constructed with it compile in the background and are finished once per
+       * frame before render(), see kdr::Graphics::ShaderCompiler.
+       *
+       * @return The shader compiler.
+       */
+      kdr::Graphics::ShaderCompiler& getShaderCompiler()
+      { return *this->shaderCompiler; }
+      /**
+       * @brief Gets the view frustum of the bound camera.
+       *
+       * The frustum is extracted from the camera matrix every time the camera is updated.
+       *
+       * @return The view frustum, which contains everything until a camera has been updated.
+       */
+      const kdr::Culling::Frustum& getFrustum() const
+      { return this->frustum; }
 
       /**
        * @brief Sets the clear color for rendering.
@@ -214,28 +266,72 @@ namespace kdr
        * @brief Binds the specified shader for rendering.
        *
        * This function sets the specified shader as the currently active shader program for rendering.
-       * It also updates the internal state to keep track of the currently bound shader.
+       * It also updates the internal state to keep track of the currently bound shader and looks up
+       * the handles of the "model" and "tex0" uniforms once, so drawing needs no string lookups.
+       * The camera reaches every shader through the camera uniform buffer instead.
        *
        * @param shader The shader to be bound for rendering.
        */
-      void bindShader(const kdr::Graphics::Shader& shader)
+      void bindShader(kdr::Graphics::Shader& shader)
       {
-        glUseProgram(shader.getID());
-        this->boundShader = shader.getID();
+        shader.Use();
+        if (this->boundShader != &shader)
+        {
+          this->boundShader = &shader;
+          this->modelUniform = shader.getUniformHandle("model");
+          this->textureUniform = shader.getUniformHandle("tex0");
+        }
+      }
+      /**
+       * @brief Binds the specified pipeline for rendering.
+       *
+       * This function binds the pipeline's shader like bindShader() and applies its render state.
+       * Only the program and state that differ from the current ones reach OpenGL.
+       *
+       * @param pipeline The pipeline to be bound for rendering.
+       */
+      void bindPipeline(const kdr::Graphics::Pipeline& pipeline)
+      {
+        this->bindShader(pipeline.getShader());
+        kdr::State::getCache().apply(pipeline.getRenderState());
       }
       /**
        * @brief Binds the specified texture for rendering.
        *
        * This function sets the specified texture unit in the bound shader and binds the texture.
-       * It is used to prepare a texture for rendering.
+       * It is used to prepare a texture for rendering. A texture that is still loading is
+       * replaced with a plain white placeholder.
        *
        * @param texture The texture to be bound for rendering.
        */
       void bindTexture(const kdr::Graphics::Texture& texture)
       {
-        texture.TextureUnit(this->boundShader, "tex0", 0);
-        texture.Bind();
+        texture.TextureUnit(*this->boundShader, this->textureUniform, 0);
+        texture.getIsReady() ? texture.Bind() : this->placeholderTexture->Bind();
+      }
+      /**
+       * @brief Binds the specified texture array for rendering.
+       *
+       * The bound shader must sample it with a sampler2DArray, like resources/Shaders/array.frag.
+       *
+       * @param textureArray The texture array to be bound for rendering.
+       */
+      void bindTexture(const kdr::Graphics::TextureArray& textureArray)
+      {
+        textureArray.TextureUnit(*this->boundShader, this->textureUniform, 0);
+        textureArray.Bind();
       }
+      /**
+       * @brief Loads a PNG file into a texture in the background.
+       *
+       * The file is decoded on a worker thread and uploaded over the following frames, see
+       * kdr::Graphics::TextureLoader. The texture must outlive the load.
+       *
+       * @param texture The texture receiving the image, typically constructed with Texture(GLenum).
+       * @param pngPath The path to the PNG file.
+       */
+      void loadTexture(kdr::Graphics::Texture& texture, const std::string& pngPath)
+      { this->textureLoader->Load(texture, pngPath); }
       /**
        * @brief Renders the specified solid object.
        *
@@ -246,9 +342,120 @@ namespace kdr
        */
       void renderSolid(kdr::Solids::Solid& solid)
       {
-        solid.applyModelMatrix(this->boundShader);
+        solid.applyModelMatrix(*this->boundShader, this->modelUniform);
         solid.render();
       }
+      /**
+       * @brief Renders many copies of a mesh with a single instanced draw call.
+       *
+       * This function writes the model matrices, and the colors and texture regions if given,
+       * to the instance stream buffer and draws every instance with one glDrawElementsInstanced
+       * call, split only if the instances do not fit into what is left of this frame's region.
+       * The bound shader must read the model matrix from kdr::Graphics::INSTANCE_MODEL_LOCATION,
+       * the color from kdr::Graphics::INSTANCE_COLOR_LOCATION, and the texture region from
+       * kdr::Graphics::INSTANCE_TEXTURE_RECT_LOCATION and INSTANCE_TEXTURE_LAYER_LOCATION, like
+       * resources/Shaders/instanced.vert.
+       *
+       * @param mesh The mesh to draw.
+       * @param models The model matrices, one per instance.
+       * @param count The number of instances.
+       * @param colors The colors, one per instance, or NULL to draw every instance in white.
+       * @param regions The texture regions, one per instance, or NULL to sample the whole texture.
+       */
+      void renderInstanced(
+        const kdr::Solids::Mesh& mesh,
+        const kdr::Space::Mat4* models,
+        const size_t count,
+        const kdr::Color::RGBA* colors = NULL,
+        const kdr::Graphics::TextureRegion* regions = NULL
+      );
+      /**
+       * @brief Renders solid objects with one instanced draw call per shared mesh.
+       *
+       * This function groups the solid objects by mesh and calls renderInstanced() for every
+       * group, so a scene of identical shapes costs a handful of draw calls. Each solid samples
+       * its own texture region, so materials from one texture array or atlas do not split groups. The bound shader
+       * must be an instanced one, like resources/Shaders/instanced.vert.
+       *
+       * @tparam T The solid type.
+       * @param solids The solid objects to be rendered.
+       */
+      template <typename T>
+      void renderSolidsInstanced(const std::vector<T*>& solids)
+      {
+        this->_batchSolids(solids);
+
+        const kdr::Solids::MeshRegistry& meshRegistry = kdr::Solids::getMeshRegistry();
+        for (const std::pair<const size_t, InstanceBatch>& batch : this->instanceBatches)
+        {
+          if (!batch.second.models.empty())
+          {
+            this->renderInstanced(
+              meshRegistry.getMesh(batch.first),
+              batch.second.models.data(),
+              batch.second.models.size(),
+              NULL,
+              batch.second.regions.data()
+            );
+          }
+        }
+      }
+      /**
+       * @brief Renders solid objects of any shape in a single multi-draw submission.
+       *
+       * This function draws from the mesh registry's pool, which holds all meshes in one
+       * vertex and one index buffer. One indirect command per shared mesh is built on the CPU
+       * and the model matrices of all commands are written back to back, with each command's
+       * base instance pointing at its first matrix. Everything is then submitted with one
+       * glMultiDrawElementsIndirect call, or with one instanced draw per command where
+       * GL_ARB_multi_draw_indirect is missing. Scenes too large for the rest of the instance
+       * buffer are split into several submissions, cutting commands where needed. The bound shader must be an instanced one,
+       * like resources/Shaders/instanced.vert.
+       *
+       * @tparam T The solid type.
+       * @param solids The solid objects to be rendered.
+       */
+      template <typename T>
+      void renderSolidsIndirect(const std::vector<T*>& solids)
+      {
+        this->_batchSolids(solids);
+        this->_renderBatchesIndirect();
+      }
+      /**
+       * @brief Collects the solid objects that intersect the view frustum.
+       *
+       * This function tests the world-space bounding spheres in the shared bounds table against
+       * the frustum in SIMD batches. Run it before rendering so off-screen solids never issue GL calls.
+       *
+       * @tparam T The solid type.
+       * @param solids The solid objects to test.
+       * @param visibleSolids The vector receiving the visible solid objects. Cleared first.
+       */
+      template <typename T>
+      void cullSolids(const std::vector<T*>& solids, std::vector<T*>& visibleSolids)
+      {
+        kdr::Solids::BoundsTable& boundsTable = kdr::Solids::getBoundsTable();
+        boundsTable.flush();
+        this->cullResults.resize(boundsTable.getCount());
+        kdr::Culling::testSpheres(
+          this->frustum,
+          boundsTable.getCenterXs(),
+          boundsTable.getCenterYs(),
+          boundsTable.getCenterZs(),
+          boundsTable.getRadii(),
+          boundsTable.getCount(),
+          this->cullResults.data()
+        );
+
+        visibleSolids.clear();
+        for (T* solid : solids)
+        {
+          if (this->cullResults[boundsTable.getIndex(solid->getBoundsHandle())])
+          {
+            visibleSolids.push_back(solid);
+          }
+        }
+      }
 
     private:
       unsigned int width {800};
@@ -258,8 +465,30 @@ namespace kdr
       GLFWwindow* glfwWindow {NULL};
       kdr::Color::RGBA clearColor {kdr::Color::Black};
 
-      GLuint boundShader {0};
+      kdr::Graphics::Shader* boundShader {NULL};
+      GLint modelUniform {-1};
+      GLint textureUniform {-1};
       kdr::Camera* boundCamera {NULL};
+      kdr::Graphics::UBO* cameraBuffer {NULL};
+      kdr::Graphics::StreamBuffer* instanceBuffer {NULL};
+      kdr::Graphics::StreamBuffer* indirectBuffer {NULL};
+      kdr::Graphics::TextureLoader* textureLoader {NULL};
+      kdr::Graphics::TextureCache* textureCache {NULL};
+      kdr::Graphics::Texture* placeholderTexture {NULL};
+      kdr::Graphics::ShaderCompiler* shaderCompiler {NULL};
+      std::vector<kdr::Graphics::DrawElementsIndirectCommand> indirectCommands;
+      std::vector<kdr::Graphics::DrawElementsIndirectCommand> indirectSubmission;
+      std::vector<kdr::Space::Mat4> indirectModels;
+      std::vector<kdr::Graphics::TextureRegion> indirectRegions;
+
+      struct InstanceBatch
+      {
+        std::vector<kdr::Space::Mat4> models;
+        std::vector<kdr::Graphics::TextureRegion> regions;
+      };
+      std::unordered_map<size_t, InstanceBatch> instanceBatches;
+      kdr::Culling::Frustum frustum;
+      std::vector<unsigned char> cullResults;
 
       bool isMaximized {false};
       bool isMouseLocked {false};
@@ -301,6 +530,51 @@ namespace kdr
         * @return True if OpenGL settings initialization is successful; false otherwise.
         */
       bool _initializeOpenGLSettings();
+      /**
+       * @brief Initializes the camera uniform buffer.
+       *
+       * This function allocates the std140 camera buffer and binds it to
+       * kdr::Graphics::CAMERA_BLOCK_BINDING, where every shader's camera block reads it.
+       *
+       * @return True if the camera buffer initialization is successful; false otherwise.
+       */
+      bool _initializeCameraBuffer();
+      /**
+       * @brief Initializes the instance buffer.
+       *
+       * This function creates the stream buffer renderInstanced() writes the per-instance
+       * model matrices and colors into.
+       *
+       * @return True if the instance buffer initialization is successful; false otherwise.
+       */
+      bool _initializeInstanceBuffer();
+      /**
+       * @brief Initializes the indirect command buffer.
+       *
+       * This function creates the stream buffer renderSolidsIndirect() writes its draw commands
+       * into, if GL_ARB_multi_draw_indirect and GL_ARB_base_instance are supported.
+       *
+       * @return True if the indirect buffer initialization is successful; false otherwise.
+       */
+      bool _initializeIndirectBuffer();
+      /**
+       * @brief Initializes the texture loader.
+       *
+       * This function starts the background texture loader and the texture cache on top of it,
+       * and creates the placeholder bindTexture() falls back to while a texture is loading.
+       *
+       * @return True if the texture loader initialization is successful; false otherwise.
+       */
+      bool _initializeTextureLoader();
+      /**
+       * @brief Initializes the shader compiler.
+       *
+       * This function creates the compiler that finishes shaders in the background, letting
+       * the driver compile on as many threads as it likes.
+       *
+       * @return True if the shader compiler initialization is successful; false otherwise.
+       */
+      bool _initializeShaderCompiler();
       /**
        * @brief Initializes the window.
        */
@@ -327,6 +601,53 @@ namespace kdr
        * @brief Renders the window.
        */
       void _render();
+      /**
+       * @brief Groups the model matrices and texture regions of solid objects by shared mesh.
+       *
+       * @tparam T The solid type.
+       * @param solids The solid objects to group.
+       */
+      template <typename T>
+      void _batchSolids(const std::vector<T*>& solids)
+      {
+        for (std::pair<const size_t, InstanceBatch>& batch : this->instanceBatches)
+        {
+          batch.second.models.clear();
+          batch.second.regions.clear();
+        }
+        for (const T* solid : solids)
+        {
+          InstanceBatch& batch = this->instanceBatches[solid->getMeshHandle()];
+          batch.models.push_back(solid->getModelMatrix());
+          batch.regions.push_back(solid->getTextureRegion());
+        }
+      }
+      /**
+       * @brief Submits the grouped solid objects from the mesh pool.
+       */
+      void _renderBatchesIndirect();
+      /**
+       * @brief Draws the commands of one submission from the mesh pool.
+       *
+       * @param pool The mesh pool, which must be bound.
+       * @param modelOffset The offset of the submission's first model matrix in the instance buffer.
+       * @param regionOffset The offset of the submission's first texture region in the instance buffer.
+       */
+      void _submitIndirect(const kdr::Solids::Mesh& pool, const GLintptr modelOffset, const GLintptr regionOffset);
+      /**
+       * @brief Points the per-instance model matrix attributes of a mesh at the instance buffer.
+       *
+       * @param mesh The mesh whose VAO is bound.
+       * @param offset The offset of the first model matrix in the instance buffer.
+       */
+      void _linkInstanceModels(const kdr::Solids::Mesh& mesh, const GLintptr offset);
+      /**
+       * @brief Points the per-instance texture region attributes of a mesh at the instance buffer.
+       *
+       * @param mesh The mesh whose VAO is bound.
+       * @param offset The offset of the first texture region in the instance buffer.
+       */
+      void _linkInstanceRegions(const kdr::Solids::Mesh& mesh, const GLintptr offset);
   };
 }
 
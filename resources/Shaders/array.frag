@@ -0,0 +1,14 @@
+#version 330 core
+
+in vec3 vertCol;
+in vec2 vertTex;
+flat in float vertLayer;
+
+uniform sampler2DArray tex0;
+
+out vec4 FragColor;
+
+void main()
+{
+  FragColor = texture(tex0, vec3(vertTex, vertLayer)) * vec4(vertCol, 1.f);
+}
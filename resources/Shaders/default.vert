@@ -4,7 +4,14 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aCol;
 layout (location = 2) in vec2 aTex;
 
-uniform mat4 cameraMatrix;
+layout (std140) uniform Camera
+{
+  mat4 view;
+  mat4 projection;
+  mat4 viewProjection;
+  vec4 position;
+} camera;
+
 uniform mat4 model;
 
 out vec3 vertCol;
@@ -12,7 +19,7 @@ out vec2 vertTex;
 
 void main()
 {
-  gl_Position = cameraMatrix * model * vec4(aPos, 1.f);
+  gl_Position = camera.viewProjection * model * vec4(aPos, 1.f);
   vertCol = aCol;
   vertTex = aTex;
 }
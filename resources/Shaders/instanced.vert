@@ -0,0 +1,29 @@
+#version 330 core
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aCol;
+layout (location = 2) in vec2 aTex;
+layout (location = 3) in mat4 aModel;
+layout (location = 7) in vec4 aInstanceCol;
+layout (location = 8) in vec4 aTexRect;
+layout (location = 9) in float aTexLayer;
+
+layout (std140) uniform Camera
+{
+  mat4 view;
+  mat4 projection;
+  mat4 viewProjection;
+  vec4 position;
+} camera;
+
+out vec3 vertCol;
+out vec2 vertTex;
+flat out float vertLayer;
+
+void main()
+{
+  gl_Position = camera.viewProjection * aModel * vec4(aPos, 1.f);
+  vertCol = aCol * aInstanceCol.rgb;
+  vertTex = aTexRect.xy + aTex * aTexRect.zw;
+  vertLayer = aTexLayer;
+}
@@ -1,5 +1,14 @@
 #include "Kedarium/Camera.hpp"
 
+#include <cstddef>
+
+// The camera block is uploaded with a single memcpy, so the struct must match std140 exactly
+static_assert(offsetof(kdr::CameraUniforms, view) == 0);
+static_assert(offsetof(kdr::CameraUniforms, projection) == 64);
+static_assert(offsetof(kdr::CameraUniforms, viewProjection) == 128);
+static_assert(offsetof(kdr::CameraUniforms, position) == 192);
+static_assert(sizeof(kdr::CameraUniforms) == 208);
+
 void kdr::Camera::updateKeys(GLFWwindow* window, const float deltaTime)
 {
   if (kdr::Keys::isPressed(window, kdr::Key::W))
@@ -54,33 +63,37 @@ void kdr::Camera::updateMouse(GLFWwindow* window)
 
 void kdr::Camera::updateMatrix()
 {
-  kdr::Space::Mat4 view {1.f};
-  kdr::Space::Mat4 proj {1.f};
   kdr::Space::Vec3 tempFront {0.f};
 
-  tempFront.x = cos(kdr::Space::radians(this->yaw)) * cos(kdr::Space::radians(this->pitch));
-  tempFront.y = sin(kdr::Space::radians(this->pitch));
-  tempFront.z = sin(kdr::Space::radians(this->yaw)) * cos(kdr::Space::radians(this->pitch));
+  float sinYaw {0.f};
+  float cosYaw {0.f};
+  float sinPitch {0.f};
+  float cosPitch {0.f};
+  kdr::Space::sincos(kdr::Space::radians(this->yaw), sinYaw, cosYaw);
+  kdr::Space::sincos(kdr::Space::radians(this->pitch), sinPitch, cosPitch);
+
+  tempFront.x = cosYaw * cosPitch;
+  tempFront.y = sinPitch;
+  tempFront.z = sinYaw * cosPitch;
 
   this->front = kdr::Space::normalize(tempFront);
 
-  view = kdr::Space::lookAt(
+  this->view = kdr::Space::lookAt(
     this->position,
     this->position + this->front,
     this->up
   );
-  proj = kdr::Space::perspective(
+  this->projection = kdr::Space::perspective(
     this->fov,
     this->aspect,
     this->zNear,
     this->zFar
   );
 
-  this->matrix = proj * view;
+  this->matrix = this->projection * this->view;
 }
 
-void kdr::Camera::applyMatrix(GLuint shaderID)
+void kdr::Camera::applyMatrix(kdr::Graphics::Shader& shader, const GLint uniform)
 {
-  GLuint matrixLoc = glGetUniformLocation(shaderID, "cameraMatrix");
-  glUniformMatrix4fv(matrixLoc, 1, GL_FALSE, kdr::Space::valuePointer(this->matrix));
+  shader.setUniform(uniform, this->matrix);
 }
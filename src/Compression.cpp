@@ -0,0 +1,597 @@
+#include "Kedarium/Compression.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include "Kedarium/File.hpp"
+#include "Kedarium/Image.hpp"
+
+/**
+ * @brief Identifies compressed texture cache files.
+ */
+static constexpr char CACHE_MAGIC[4] {'K', 'D', 'R', 'C'};
+/**
+ * @brief The version of the cache file layout, bumped whenever the layout or the encoder changes.
+ */
+static constexpr uint32_t CACHE_VERSION {1};
+
+/**
+ * @brief The header of a compressed texture cache file, followed by the size and data of every level.
+ */
+struct CacheHeader
+{
+  char magic[4];
+  uint32_t version;
+  uint32_t format;
+  uint32_t width;
+  uint32_t height;
+  uint32_t levelCount;
+  uint64_t sourceSize;
+  int64_t sourceTime;
+  uint64_t sourceHash;
+};
+
+/**
+ * @brief Hashes bytes with 64-bit FNV-1a.
+ *
+ * @param data The bytes to hash.
+ * @param size The number of bytes.
+ * @param hash The hash to continue from.
+ * @return The updated hash.
+ */
+static uint64_t hashBytes(const char* data, const size_t size, uint64_t hash = 14695981039346656037ull)
+{
+  for (size_t i = 0; i < size; i++)
+  {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+/**
+ * @brief Hashes the contents of a file with 64-bit FNV-1a.
+ *
+ * @param path The path to the file.
+ * @param hash Reference to store the hash.
+ * @return True if the file is successfully read, false otherwise.
+ */
+static bool hashFile(const std::string& path, uint64_t& hash)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open())
+  {
+    return false;
+  }
+
+  char buffer[64 * 1024];
+  hash = 14695981039346656037ull;
+  while (file)
+  {
+    file.read(buffer, sizeof(buffer));
+    hash = hashBytes(buffer, static_cast<size_t>(file.gcount()), hash);
+  }
+  return true;
+}
+
+/**
+ * @brief Quantizes an 8-bit RGB color to RGB565.
+ *
+ * @param texel The color.
+ * @return The 16-bit color.
+ */
+static uint16_t toRgb565(const GLubyte* texel)
+{
+  const uint16_t r = static_cast<uint16_t>((texel[0] * 31 + 127) / 255);
+  const uint16_t g = static_cast<uint16_t>((texel[1] * 63 + 127) / 255);
+  const uint16_t b = static_cast<uint16_t>((texel[2] * 31 + 127) / 255);
+  return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+/**
+ * @brief Expands an RGB565 color back to 8 bits per channel, like the GPU decoder.
+ *
+ * @param color The 16-bit color.
+ * @param rgb The three channels receiving the color.
+ */
+static void fromRgb565(const uint16_t color, int rgb[3])
+{
+  const int r = (color >> 11) & 31;
+  const int g = (color >> 5) & 63;
+  const int b = color & 31;
+  rgb[0] = (r << 3) | (r >> 2);
+  rgb[1] = (g << 2) | (g >> 4);
+  rgb[2] = (b << 3) | (b >> 2);
+}
+
+/**
+ * @brief Encodes the color of a 4x4 block in the four-color BC1 mode.
+ *
+ * @param texels The 16 texels of the block as 8-bit RGBA, row by row.
+ * @param block The 8 bytes receiving the color block.
+ */
+static void encodeColorBlock(const GLubyte texels[64], GLubyte block[8])
+{
+  float mean[3] {0.f, 0.f, 0.f};
+  for (int i = 0; i < 16; i++)
+  {
+    for (int c = 0; c < 3; c++)
+    {
+      mean[c] += texels[i * 4 + c] / 16.f;
+    }
+  }
+
+  // The principal axis of the colors, found by power iteration on their covariance
+  float covariance[6] {0.f, 0.f, 0.f, 0.f, 0.f, 0.f};
+  for (int i = 0; i < 16; i++)
+  {
+    const float r = texels[i * 4 + 0] - mean[0];
+    const float g = texels[i * 4 + 1] - mean[1];
+    const float b = texels[i * 4 + 2] - mean[2];
+    covariance[0] += r * r;
+    covariance[1] += r * g;
+    covariance[2] += r * b;
+    covariance[3] += g * g;
+    covariance[4] += g * b;
+    covariance[5] += b * b;
+  }
+  // Starting from the row of the channel that varies most keeps anticorrelated channels from cancelling out
+  float axis[3] {covariance[0], covariance[1], covariance[2]};
+  if (covariance[3] > covariance[0] && covariance[3] >= covariance[5])
+  {
+    axis[0] = covariance[1];
+    axis[1] = covariance[3];
+    axis[2] = covariance[4];
+  }
+  else if (covariance[5] > covariance[0] && covariance[5] > covariance[3])
+  {
+    axis[0] = covariance[2];
+    axis[1] = covariance[4];
+    axis[2] = covariance[5];
+  }
+  for (int iteration = 0; iteration < 8; iteration++)
+  {
+    const float x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+    const float y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+    const float z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+    const float length = std::max(std::max(std::fabs(x), std::fabs(y)), std::fabs(z));
+    if (length <= 0.f)
+    {
+      break;
+    }
+    axis[0] = x / length;
+    axis[1] = y / length;
+    axis[2] = z / length;
+  }
+
+  int minIndex {0};
+  int maxIndex {0};
+  float minProjection {0.f};
+  float maxProjection {0.f};
+  for (int i = 0; i < 16; i++)
+  {
+    const float projection = texels[i * 4 + 0] * axis[0] + texels[i * 4 + 1] * axis[1] + texels[i * 4 + 2] * axis[2];
+    if (i == 0 || projection < minProjection)
+    {
+      minProjection = projection;
+      minIndex = i;
+    }
+    if (i == 0 || projection > maxProjection)
+    {
+      maxProjection = projection;
+      maxIndex = i;
+    }
+  }
+
+  // The first endpoint must be the larger one, which selects the four-color mode
+  uint16_t color0 = toRgb565(texels + maxIndex * 4);
+  uint16_t color1 = toRgb565(texels + minIndex * 4);
+  if (color0 < color1)
+  {
+    std::swap(color0, color1);
+  }
+
+  uint32_t indices {0};
+  if (color0 != color1)
+  {
+    int palette[4][3];
+    fromRgb565(color0, palette[0]);
+    fromRgb565(color1, palette[1]);
+    for (int c = 0; c < 3; c++)
+    {
+      palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+      palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+
+    for (int i = 0; i < 16; i++)
+    {
+      uint32_t bestIndex {0};
+      int bestDistance {-1};
+      for (uint32_t p = 0; p < 4; p++)
+      {
+        const int dr = texels[i * 4 + 0] - palette[p][0];
+        const int dg = texels[i * 4 + 1] - palette[p][1];
+        const int db = texels[i * 4 + 2] - palette[p][2];
+        const int distance = dr * dr + dg * dg + db * db;
+        if (bestDistance < 0 || distance < bestDistance)
+        {
+          bestDistance = distance;
+          bestIndex = p;
+        }
+      }
+      indices |= bestIndex << (i * 2);
+    }
+  }
+
+  block[0] = static_cast<GLubyte>(color0 & 0xff);
+  block[1] = static_cast<GLubyte>(color0 >> 8);
+  block[2] = static_cast<GLubyte>(color1 & 0xff);
+  block[3] = static_cast<GLubyte>(color1 >> 8);
+  for (int i = 0; i < 4; i++)
+  {
+    block[4 + i] = static_cast<GLubyte>((indices >> (i * 8)) & 0xff);
+  }
+}
+
+/**
+ * @brief Encodes the alpha of a 4x4 block in the eight-value BC3 mode.
+ *
+ * @param texels The 16 texels of the block as 8-bit RGBA, row by row.
+ * @param block The 8 bytes receiving the alpha block.
+ */
+static void encodeAlphaBlock(const GLubyte texels[64], GLubyte block[8])
+{
+  int alpha0 {0};
+  int alpha1 {255};
+  for (int i = 0; i < 16; i++)
+  {
+    alpha0 = std::max(alpha0, static_cast<int>(texels[i * 4 + 3]));
+    alpha1 = std::min(alpha1, static_cast<int>(texels[i * 4 + 3]));
+  }
+
+  uint64_t indices {0};
+  if (alpha0 != alpha1)
+  {
+    int palette[8] {alpha0, alpha1};
+    for (int p = 1; p < 7; p++)
+    {
+      palette[p + 1] = ((7 - p) * alpha0 + p * alpha1) / 7;
+    }
+
+    for (int i = 0; i < 16; i++)
+    {
+      uint64_t bestIndex {0};
+      int bestDistance {256};
+      for (uint64_t p = 0; p < 8; p++)
+      {
+        const int distance = std::abs(texels[i * 4 + 3] - palette[p]);
+        if (distance < bestDistance)
+        {
+          bestDistance = distance;
+          bestIndex = p;
+        }
+      }
+      indices |= bestIndex << (i * 3);
+    }
+  }
+
+  block[0] = static_cast<GLubyte>(alpha0);
+  block[1] = static_cast<GLubyte>(alpha1);
+  for (int i = 0; i < 6; i++)
+  {
+    block[2 + i] = static_cast<GLubyte>((indices >> (i * 8)) & 0xff);
+  }
+}
+
+/**
+ * @brief Builds the path of the cache file of a PNG file.
+ *
+ * @param pngPath The path to the PNG file.
+ * @param format The compressed format.
+ * @param cacheDirectory The directory the compressed files are cached in.
+ * @return The path of the cache file.
+ */
+static std::string getCachePath(const std::string& pngPath, const kdr::Compression::Format format, const std::string& cacheDirectory)
+{
+  const std::string key = pngPath + '#' + std::to_string(static_cast<int>(format));
+  const uint64_t hash = hashBytes(key.data(), key.size());
+
+  static const char digits[] = "0123456789abcdef";
+  std::string name(16, '0');
+  for (int i = 0; i < 16; i++)
+  {
+    name[15 - i] = digits[(hash >> (i * 4)) & 0xf];
+  }
+  return cacheDirectory + '/' + name + ".kdrc";
+}
+
+/**
+ * @brief Reads the levels of a cache file whose header has been read.
+ *
+ * @param file The cache file, positioned after the header.
+ * @param header The header of the cache file.
+ * @param image The image receiving every mipmap level.
+ * @return True if every level is read and has the expected size, false otherwise.
+ */
+static bool readCacheLevels(std::ifstream& file, const CacheHeader& header, kdr::Compression::CompressedImage& image)
+{
+  const kdr::Compression::Format format = static_cast<kdr::Compression::Format>(header.format);
+  image.format = format;
+  image.width = static_cast<GLsizei>(header.width);
+  image.height = static_cast<GLsizei>(header.height);
+  image.levels.resize(header.levelCount);
+
+  for (uint32_t level = 0; level < header.levelCount; level++)
+  {
+    const uint64_t levelWidth = std::max<uint64_t>(header.width >> level, 1);
+    const uint64_t levelHeight = std::max<uint64_t>(header.height >> level, 1);
+    const uint64_t expectedSize = ((levelWidth + 3) / 4) * ((levelHeight + 3) / 4) * kdr::Compression::getBlockSize(format);
+
+    uint64_t size {0};
+    file.read(reinterpret_cast<char*>(&size), sizeof(size));
+    if (!file || size != expectedSize)
+    {
+      return false;
+    }
+    image.levels[level].resize(size);
+    file.read(reinterpret_cast<char*>(image.levels[level].data()), size);
+    if (!file)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Writes a cache file, replacing the previous one only once it is complete.
+ *
+ * @param cachePath The path of the cache file.
+ * @param header The header of the cache file.
+ * @param image The image whose levels are written.
+ * @return True if the cache file is written, false otherwise.
+ */
+static bool writeCache(const std::string& cachePath, const CacheHeader& header, const kdr::Compression::CompressedImage& image)
+{
+  std::error_code error;
+  std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+
+  // Workers may write the same cache file at once (e.g. one image with two samplings), so every
+  // write gets its own temporary file and the last rename wins with a complete file
+  const std::string temporaryPath = kdr::File::getTemporaryPath(cachePath);
+  {
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+      return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const std::vector<GLubyte>& level : image.levels)
+    {
+      const uint64_t size = level.size();
+      file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+      file.write(reinterpret_cast<const char*>(level.data()), size);
+    }
+    if (!file)
+    {
+      file.close();
+      std::filesystem::remove(temporaryPath, error);
+      return false;
+    }
+  }
+
+  std::filesystem::rename(temporaryPath, cachePath, error);
+  if (error)
+  {
+    std::filesystem::remove(temporaryPath, error);
+    return false;
+  }
+  return true;
+}
+
+GLenum kdr::Compression::getInternalFormat(const kdr::Compression::Format format)
+{
+  switch (format)
+  {
+    case kdr::Compression::Format::BC1:
+      return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    case kdr::Compression::Format::BC3:
+      return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    default:
+      return GL_RGBA8;
+  }
+}
+
+size_t kdr::Compression::getBlockSize(const kdr::Compression::Format format)
+{
+  switch (format)
+  {
+    case kdr::Compression::Format::BC1:
+      return 8;
+    case kdr::Compression::Format::BC3:
+      return 16;
+    default:
+      return 0;
+  }
+}
+
+bool kdr::Compression::isSupported(const kdr::Compression::Format format)
+{
+  if (format == kdr::Compression::Format::None)
+  {
+    return true;
+  }
+  return GLEW_EXT_texture_compression_s3tc;
+}
+
+void kdr::Compression::encodeBC1Block(const GLubyte texels[64], GLubyte block[8])
+{
+  encodeColorBlock(texels, block);
+}
+
+void kdr::Compression::encodeBC3Block(const GLubyte texels[64], GLubyte block[16])
+{
+  encodeAlphaBlock(texels, block);
+  encodeColorBlock(texels, block + 8);
+}
+
+std::vector<GLubyte> kdr::Compression::encode(const GLubyte* rgba, const GLsizei width, const GLsizei height, const kdr::Compression::Format format)
+{
+  const size_t blockSize = kdr::Compression::getBlockSize(format);
+  const GLsizei blocksX = (width + 3) / 4;
+  const GLsizei blocksY = (height + 3) / 4;
+  std::vector<GLubyte> blocks(static_cast<size_t>(blocksX) * blocksY * blockSize);
+
+  GLubyte texels[64];
+  for (GLsizei blockY = 0; blockY < blocksY; blockY++)
+  {
+    for (GLsizei blockX = 0; blockX < blocksX; blockX++)
+    {
+      for (int y = 0; y < 4; y++)
+      {
+        const GLsizei sourceY = std::min(blockY * 4 + y, height - 1);
+        for (int x = 0; x < 4; x++)
+        {
+          const GLsizei sourceX = std::min(blockX * 4 + x, width - 1);
+          std::memcpy(texels + (y * 4 + x) * 4, rgba + (static_cast<size_t>(sourceY) * width + sourceX) * 4, 4);
+        }
+      }
+
+      GLubyte* block = blocks.data() + (static_cast<size_t>(blockY) * blocksX + blockX) * blockSize;
+      if (format == kdr::Compression::Format::BC3)
+      {
+        kdr::Compression::encodeBC3Block(texels, block);
+      }
+      else
+      {
+        kdr::Compression::encodeBC1Block(texels, block);
+      }
+    }
+  }
+  return blocks;
+}
+
+void kdr::Compression::encodeMipmaps(const GLubyte* rgba, const GLsizei width, const GLsizei height, const kdr::Compression::Format format, kdr::Compression::CompressedImage& image)
+{
+  image.format = format;
+  image.width = width;
+  image.height = height;
+  image.levels.clear();
+
+  std::vector<GLubyte> level(rgba, rgba + static_cast<size_t>(width) * height * 4);
+  GLsizei levelWidth = width;
+  GLsizei levelHeight = height;
+  while (true)
+  {
+    image.levels.push_back(kdr::Compression::encode(level.data(), levelWidth, levelHeight, format));
+    if (levelWidth == 1 && levelHeight == 1)
+    {
+      break;
+    }
+
+    const GLsizei nextWidth = std::max(levelWidth / 2, 1);
+    const GLsizei nextHeight = std::max(levelHeight / 2, 1);
+    std::vector<GLubyte> next(static_cast<size_t>(nextWidth) * nextHeight * 4);
+    for (GLsizei y = 0; y < nextHeight; y++)
+    {
+      const GLsizei y0 = std::min(y * 2, levelHeight - 1);
+      const GLsizei y1 = std::min(y * 2 + 1, levelHeight - 1);
+      for (GLsizei x = 0; x < nextWidth; x++)
+      {
+        const GLsizei x0 = std::min(x * 2, levelWidth - 1);
+        const GLsizei x1 = std::min(x * 2 + 1, levelWidth - 1);
+        for (int c = 0; c < 4; c++)
+        {
+          const int sum =
+            level[(static_cast<size_t>(y0) * levelWidth + x0) * 4 + c] +
+            level[(static_cast<size_t>(y0) * levelWidth + x1) * 4 + c] +
+            level[(static_cast<size_t>(y1) * levelWidth + x0) * 4 + c] +
+            level[(static_cast<size_t>(y1) * levelWidth + x1) * 4 + c];
+          next[(static_cast<size_t>(y) * nextWidth + x) * 4 + c] = static_cast<GLubyte>((sum + 2) / 4);
+        }
+      }
+    }
+    level.swap(next);
+    levelWidth = nextWidth;
+    levelHeight = nextHeight;
+  }
+}
+
+bool kdr::Compression::loadPng(const std::string& pngPath, const kdr::Compression::Format format, const std::string& cacheDirectory, kdr::Compression::CompressedImage& image)
+{
+  std::error_code error;
+  const uint64_t sourceSize = std::filesystem::file_size(pngPath, error);
+  const int64_t sourceTime = std::filesystem::last_write_time(pngPath, error).time_since_epoch().count();
+  if (error)
+  {
+    std::cerr << "Failed to open file (" << pngPath << ")!\n";
+    return false;
+  }
+
+  const std::string cachePath = getCachePath(pngPath, format, cacheDirectory);
+  CacheHeader header {};
+  std::ifstream cacheFile(cachePath, std::ios::binary);
+  if (cacheFile.is_open())
+  {
+    cacheFile.read(reinterpret_cast<char*>(&header), sizeof(header));
+    const bool isCompatible =
+      cacheFile &&
+      std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 &&
+      header.version == CACHE_VERSION &&
+      header.format == static_cast<uint32_t>(format);
+
+    // A matching size and time is trusted, otherwise the contents decide, so touched files are not encoded again
+    bool isFresh = header.sourceSize == sourceSize && header.sourceTime == sourceTime;
+    bool isTouched {false};
+    uint64_t sourceHash {0};
+    if (isCompatible && !isFresh && hashFile(pngPath, sourceHash) && sourceHash == header.sourceHash)
+    {
+      isFresh = true;
+      isTouched = true;
+      header.sourceSize = sourceSize;
+      header.sourceTime = sourceTime;
+    }
+
+    if (isCompatible && isFresh && readCacheLevels(cacheFile, header, image))
+    {
+      cacheFile.close();
+      if (isTouched)
+      {
+        writeCache(cachePath, header, image);
+      }
+      return true;
+    }
+    cacheFile.close();
+  }
+
+  int imgWidth {0};
+  int imgHeight {0};
+  if (!kdr::Image::readPngSize(pngPath, imgWidth, imgHeight) || imgWidth <= 0 || imgHeight <= 0)
+  {
+    return false;
+  }
+  std::vector<GLubyte> rgba(static_cast<size_t>(imgWidth) * imgHeight * 4);
+  if (!kdr::Image::loadRgbaFromPng(pngPath, rgba.data(), imgWidth, imgHeight))
+  {
+    return false;
+  }
+  kdr::Compression::encodeMipmaps(rgba.data(), imgWidth, imgHeight, format, image);
+
+  std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+  header.version = CACHE_VERSION;
+  header.format = static_cast<uint32_t>(format);
+  header.width = static_cast<uint32_t>(imgWidth);
+  header.height = static_cast<uint32_t>(imgHeight);
+  header.levelCount = static_cast<uint32_t>(image.levels.size());
+  header.sourceSize = sourceSize;
+  header.sourceTime = sourceTime;
+  if (!hashFile(pngPath, header.sourceHash) || !writeCache(cachePath, header, image))
+  {
+    std::cerr << "Failed to write the compressed texture cache (" << cachePath << ")!\n";
+  }
+  return true;
+}
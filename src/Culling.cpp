@@ -0,0 +1,67 @@
+#include "Kedarium/Culling.hpp"
+
+kdr::Culling::Frustum::Frustum()
+{
+  for (int p = 0; p < 6; p++)
+  {
+    this->planes[p][0] = 0.f;
+    this->planes[p][1] = 0.f;
+    this->planes[p][2] = 0.f;
+    this->planes[p][3] = 1.f;
+  }
+}
+
+kdr::Culling::Frustum::Frustum(const kdr::Space::Mat4& matrix)
+{
+  // Row i of the matrix is (matrix[0][i], matrix[1][i], matrix[2][i], matrix[3][i])
+  for (int p = 0; p < 6; p++)
+  {
+    const int row = p / 2;
+    const float sign = p % 2 == 0 ? 1.f : -1.f;
+    for (int c = 0; c < 4; c++)
+    {
+      this->planes[p][c] = matrix[c][3] + sign * matrix[c][row];
+    }
+
+    const float length = kdr::Space::sqrt(
+      this->planes[p][0] * this->planes[p][0] +
+      this->planes[p][1] * this->planes[p][1] +
+      this->planes[p][2] * this->planes[p][2]
+    );
+    if (length > 0.f)
+    {
+      for (int c = 0; c < 4; c++)
+      {
+        this->planes[p][c] /= length;
+      }
+    }
+  }
+}
+
+bool kdr::Culling::Frustum::intersectsSphere(const kdr::Space::Vec3& center, const float radius) const
+{
+  unsigned char result {0};
+  kdr::Simd::cullSpheres(&this->planes[0][0], &center.x, &center.y, &center.z, &radius, 1, &result);
+  return result;
+}
+
+bool kdr::Culling::Frustum::intersectsBox(const kdr::Space::Vec3& min, const kdr::Space::Vec3& max) const
+{
+  const float* mins[3] {&min.x, &min.y, &min.z};
+  const float* maxs[3] {&max.x, &max.y, &max.z};
+  unsigned char result {0};
+  kdr::Simd::cullBoxes(&this->planes[0][0], mins, maxs, 1, &result);
+  return result;
+}
+
+void kdr::Culling::testSpheres(const kdr::Culling::Frustum& frustum, const float* xs, const float* ys, const float* zs, const float* radii, const size_t count, unsigned char* results)
+{
+  kdr::Simd::cullSpheres(frustum.getPlanes(), xs, ys, zs, radii, count, results);
+}
+
+void kdr::Culling::testBoxes(const kdr::Culling::Frustum& frustum, const float* minXs, const float* minYs, const float* minZs, const float* maxXs, const float* maxYs, const float* maxZs, const size_t count, unsigned char* results)
+{
+  const float* mins[3] {minXs, minYs, minZs};
+  const float* maxs[3] {maxXs, maxYs, maxZs};
+  kdr::Simd::cullBoxes(frustum.getPlanes(), mins, maxs, count, results);
+}
@@ -1,5 +1,11 @@
 #include "Kedarium/File.hpp"
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <thread>
+
 std::string kdr::File::getContents(const std::string& path)
 {
   std::ifstream file;
@@ -16,3 +22,13 @@ std::string kdr::File::getContents(const std::string& path)
   file.close();
   return buffer.str();
 }
+
+std::string kdr::File::getTemporaryPath(const std::string& path)
+{
+  static const uint32_t processToken = std::random_device()();
+  static std::atomic<uint64_t> pathCount {0};
+  return path + ".tmp." +
+    std::to_string(processToken) + '.' +
+    std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + '.' +
+    std::to_string(pathCount.fetch_add(1, std::memory_order_relaxed));
+}
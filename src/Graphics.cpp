@@ -1,73 +1,730 @@
 #include "Kedarium/Graphics.hpp"
 
-kdr::Graphics::Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath)
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+/**
+ * @brief The version of the program cache file layout, bumped whenever it changes.
+ */
+static constexpr uint32_t PROGRAM_CACHE_VERSION {1};
+
+/**
+ * @struct ProgramCacheHeader
+ * @brief Heads every cached program binary.
+ */
+struct ProgramCacheHeader
 {
-   // Shader Sources
-  const std::string vertexShaderSource = kdr::File::getContents(vertexPath);
-  const std::string fragmentShaderSource = kdr::File::getContents(fragmentPath);
+  char magic[4];
+  uint32_t version;
+  uint64_t key;
+  uint32_t binaryFormat;
+  uint32_t binarySize;
+};
 
-  // Shader Sources (C)
-  const char* vertexShaderSourceC = vertexShaderSource.c_str();
-  const char* fragmentShaderSourceC = fragmentShaderSource.c_str();
+/**
+ * @brief Hashes a string with 64-bit FNV-1a.
+ *
+ * @param text The string to hash.
+ * @param hash The hash to continue from.
+ * @return The updated hash.
+ */
+static uint64_t hashString(const std::string& text, uint64_t hash = 14695981039346656037ull)
+{
+  for (const char c : text)
+  {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ull;
+  }
+  // Terminate every string, so ("ab", "c") and ("a", "bc") differ
+  hash ^= 0xff;
+  hash *= 1099511628211ull;
+  return hash;
+}
 
-  // Shaders
-  GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-  GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+/**
+ * @brief Gets a string of the current OpenGL context.
+ *
+ * @param name The string to get (e.g., GL_VENDOR).
+ * @return The string, or an empty string if there is none.
+ */
+static std::string getGlString(const GLenum name)
+{
+  const GLubyte* value = glGetString(name);
+  return value != NULL ? reinterpret_cast<const char*>(value) : "";
+}
+
+/**
+ * @brief Checks whether the driver can save and load program binaries.
+ *
+ * @return True if program binaries are supported, false otherwise.
+ */
+static bool isProgramBinarySupported()
+{
+  if (!GLEW_ARB_get_program_binary)
+  {
+    return false;
+  }
+  GLint formatCount {0};
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+  return formatCount > 0;
+}
+
+/**
+ * @brief Inserts macro definitions into shader source code, right after its #version line.
+ *
+ * @param source The shader source code.
+ * @param defines The macros, as "NAME" or "NAME VALUE".
+ * @return The source code with the definitions.
+ */
+static std::string addDefines(const std::string& source, const std::vector<std::string>& defines)
+{
+  if (defines.empty())
+  {
+    return source;
+  }
+
+  std::string definitions;
+  for (const std::string& define : defines)
+  {
+    definitions += "#define " + define + '\n';
+  }
+
+  size_t insertAt {0};
+  const size_t versionAt = source.find("#version");
+  if (versionAt != std::string::npos)
+  {
+    const size_t lineEnd = source.find('\n', versionAt);
+    insertAt = lineEnd != std::string::npos ? lineEnd + 1 : source.size();
+  }
+  std::string result = source;
+  if (insertAt == source.size() && insertAt > 0 && source.back() != '\n')
+  {
+    definitions.insert(definitions.begin(), '\n');
+  }
+  result.insert(insertAt, definitions);
+  return result;
+}
+
+/**
+ * @brief Gets the program cache directory shared by every shader.
+ *
+ * @return The program cache directory.
+ */
+static std::string& programCacheDirectory()
+{
+  static std::string directory {kdr::Graphics::DEFAULT_PROGRAM_CACHE_DIRECTORY};
+  return directory;
+}
+
+/**
+ * @brief Converts a float to an IEEE 754 half float, rounding to nearest even.
+ *
+ * @param value The float to convert.
+ * @return The bits of the half float.
+ */
+static GLushort floatToHalf(const float value)
+{
+  uint32_t bits {0};
+  std::memcpy(&bits, &value, sizeof(bits));
+  const uint32_t sign = (bits >> 16) & 0x8000;
+  const uint32_t biasedExponent = (bits >> 23) & 0xff;
+  uint32_t mantissa = bits & 0x7fffff;
+
+  if (biasedExponent == 0xff)
+  {
+    return static_cast<GLushort>(sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0));
+  }
+  const int32_t exponent = static_cast<int32_t>(biasedExponent) - 127 + 15;
+  if (exponent >= 31)
+  {
+    return static_cast<GLushort>(sign | 0x7c00);
+  }
+  if (exponent <= 0)
+  {
+    if (exponent < -10)
+    {
+      return static_cast<GLushort>(sign);
+    }
+    mantissa |= 0x800000;
+    const uint32_t shift = static_cast<uint32_t>(14 - exponent);
+    uint32_t half = mantissa >> shift;
+    const uint32_t rest = mantissa & ((1u << shift) - 1);
+    const uint32_t halfway = 1u << (shift - 1);
+    if (rest > halfway || (rest == halfway && (half & 1)))
+    {
+      half++;
+    }
+    return static_cast<GLushort>(sign | half);
+  }
+
+  // A carry out of the mantissa correctly rounds up into the exponent
+  uint32_t half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+  const uint32_t rest = mantissa & 0x1fff;
+  if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+  {
+    half++;
+  }
+  return static_cast<GLushort>(sign | half);
+}
+
+kdr::Graphics::VertexLayout kdr::Graphics::getVertexLayout(const kdr::Graphics::VertexFormat& format)
+{
+  kdr::Graphics::VertexLayout layout;
+  GLsizeiptr offset {0};
+
+  switch (format.position)
+  {
+    case kdr::Graphics::PositionFormat::Float:
+      layout.attributes.push_back({0, 3, GL_FLOAT, false, offset});
+      offset += 3 * sizeof(GLfloat);
+      break;
+    case kdr::Graphics::PositionFormat::Half:
+      layout.attributes.push_back({0, 3, GL_HALF_FLOAT, false, offset});
+      offset += 4 * sizeof(GLushort);
+      break;
+    case kdr::Graphics::PositionFormat::Snorm16:
+      layout.attributes.push_back({0, 3, GL_SHORT, true, offset});
+      offset += 4 * sizeof(GLshort);
+      break;
+  }
+
+  switch (format.color)
+  {
+    case kdr::Graphics::ColorFormat::None:
+      break;
+    case kdr::Graphics::ColorFormat::Float:
+      layout.attributes.push_back({1, 3, GL_FLOAT, false, offset});
+      offset += 3 * sizeof(GLfloat);
+      break;
+    case kdr::Graphics::ColorFormat::RGBA8:
+      layout.attributes.push_back({1, 4, GL_UNSIGNED_BYTE, true, offset});
+      offset += 4 * sizeof(GLubyte);
+      break;
+  }
+
+  switch (format.texCoord)
+  {
+    case kdr::Graphics::TexCoordFormat::None:
+      break;
+    case kdr::Graphics::TexCoordFormat::Float:
+      layout.attributes.push_back({2, 2, GL_FLOAT, false, offset});
+      offset += 2 * sizeof(GLfloat);
+      break;
+    case kdr::Graphics::TexCoordFormat::Unorm16:
+      layout.attributes.push_back({2, 2, GL_UNSIGNED_SHORT, true, offset});
+      offset += 2 * sizeof(GLushort);
+      break;
+  }
+
+  layout.stride = static_cast<GLsizei>(offset);
+  return layout;
+}
+
+std::vector<GLubyte> kdr::Graphics::packVertices(const GLfloat* vertices, const size_t vertexCount, const kdr::Graphics::VertexFormat& format)
+{
+  const kdr::Graphics::VertexLayout layout = kdr::Graphics::getVertexLayout(format);
+  std::vector<GLubyte> packed(vertexCount * layout.stride, 0);
+
+  for (size_t i = 0; i < vertexCount; i++)
+  {
+    const GLfloat* source = vertices + i * kdr::Graphics::VERTEX_FLOAT_COUNT;
+    GLubyte* destination = packed.data() + i * layout.stride;
 
-  glShaderSource(vertexShader, 1, &vertexShaderSourceC, NULL);
-  glShaderSource(fragmentShader, 1, &fragmentShaderSourceC, NULL);
+    switch (format.position)
+    {
+      case kdr::Graphics::PositionFormat::Float:
+        std::memcpy(destination, source, 3 * sizeof(GLfloat));
+        destination += 3 * sizeof(GLfloat);
+        break;
+      case kdr::Graphics::PositionFormat::Half:
+        for (int c = 0; c < 3; c++)
+        {
+          const GLushort half = floatToHalf(source[c]);
+          std::memcpy(destination + c * sizeof(GLushort), &half, sizeof(GLushort));
+        }
+        destination += 4 * sizeof(GLushort);
+        break;
+      case kdr::Graphics::PositionFormat::Snorm16:
+        for (int c = 0; c < 3; c++)
+        {
+          const GLshort snorm = static_cast<GLshort>(std::lround(std::clamp(source[c], -1.f, 1.f) * 32767.f));
+          std::memcpy(destination + c * sizeof(GLshort), &snorm, sizeof(GLshort));
+        }
+        destination += 4 * sizeof(GLshort);
+        break;
+    }
 
-  glCompileShader(vertexShader);
-  glCompileShader(fragmentShader);
+    switch (format.color)
+    {
+      case kdr::Graphics::ColorFormat::None:
+        break;
+      case kdr::Graphics::ColorFormat::Float:
+        std::memcpy(destination, source + 3, 3 * sizeof(GLfloat));
+        destination += 3 * sizeof(GLfloat);
+        break;
+      case kdr::Graphics::ColorFormat::RGBA8:
+        for (int c = 0; c < 3; c++)
+        {
+          destination[c] = static_cast<GLubyte>(std::lround(std::clamp(source[3 + c], 0.f, 1.f) * 255.f));
+        }
+        destination[3] = 255;
+        destination += 4 * sizeof(GLubyte);
+        break;
+    }
 
-  // Info Log
-  int success {0};
-  char infoLog[512];
+    switch (format.texCoord)
+    {
+      case kdr::Graphics::TexCoordFormat::None:
+        break;
+      case kdr::Graphics::TexCoordFormat::Float:
+        std::memcpy(destination, source + 6, 2 * sizeof(GLfloat));
+        break;
+      case kdr::Graphics::TexCoordFormat::Unorm16:
+        for (int c = 0; c < 2; c++)
+        {
+          const GLushort unorm = static_cast<GLushort>(std::lround(std::clamp(source[6 + c], 0.f, 1.f) * 65535.f));
+          std::memcpy(destination + c * sizeof(GLushort), &unorm, sizeof(GLushort));
+        }
+        break;
+    }
+  }
+  return packed;
+}
+
+const std::string& kdr::Graphics::getProgramCacheDirectory()
+{
+  return programCacheDirectory();
+}
+
+void kdr::Graphics::setProgramCacheDirectory(const std::string& directory)
+{
+  programCacheDirectory() = directory;
+}
 
-  // Validating the Vertex Shader
-  glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-  if (!success)
+kdr::Graphics::Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath, const std::vector<std::string>& defines)
+{
+  this->_submit(vertexPath, fragmentPath, defines);
+  if (!this->isReady)
   {
-    glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-    std::cerr << "Failed to compile the vertex shader!\n";
-    std::cerr << "Error: " << infoLog << '\n';
+    this->_complete();
   }
+}
 
-  // Validating the Fragment Shader
-  glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-  if (!success)
+kdr::Graphics::Shader::Shader(kdr::Graphics::ShaderCompiler& compiler, const std::string& vertexPath, const std::string& fragmentPath, const std::vector<std::string>& defines)
+{
+  this->_submit(vertexPath, fragmentPath, defines);
+  if (!this->isReady)
   {
-    glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-    std::cerr << "Failed to compile the fragment shader!\n";
-    std::cerr << "Error: " << infoLog << '\n';
+    compiler._add(*this);
   }
+}
+
+kdr::Graphics::Shader::~Shader()
+{
+  this->Delete();
+}
+
+void kdr::Graphics::Shader::Finish()
+{
+  if (this->isReady)
+  {
+    return;
+  }
+  if (this->compiler != NULL)
+  {
+    this->compiler->_remove(*this);
+  }
+  this->_complete();
+}
+
+void kdr::Graphics::Shader::Delete()
+{
+  if (this->compiler != NULL)
+  {
+    this->compiler->_remove(*this);
+  }
+  this->_releaseShaders();
+  if (this->ID == 0)
+  {
+    return;
+  }
+  kdr::State::getCache().releaseProgram(this->ID);
+  glDeleteProgram(this->ID);
+  this->ID = 0;
+}
+
+GLint kdr::Graphics::Shader::getUniformHandle(const std::string& name) const
+{
+  const std::unordered_map<std::string, GLint>::const_iterator it = this->uniformHandles.find(name);
+  return it != this->uniformHandles.end() ? it->second : -1;
+}
+
+GLint kdr::Graphics::Shader::getAttributeLocation(const std::string& name) const
+{
+  for (const kdr::Graphics::ShaderVariable& attribute : this->attributes)
+  {
+    if (attribute.name == name)
+    {
+      return attribute.location;
+    }
+  }
+  return -1;
+}
+
+void kdr::Graphics::Shader::_submit(const std::string& vertexPath, const std::string& fragmentPath, const std::vector<std::string>& defines)
+{
+  // Shader Sources
+  const std::string vertexShaderSource = addDefines(kdr::File::getContents(vertexPath), defines);
+  const std::string fragmentShaderSource = addDefines(kdr::File::getContents(fragmentPath), defines);
 
-  // Shader Program
   this->ID = glCreateProgram();
-  glAttachShader(this->ID, vertexShader);
-  glAttachShader(this->ID, fragmentShader);
+
+  // Program Binary Cache
+  const std::string& cacheDirectory = kdr::Graphics::getProgramCacheDirectory();
+  if (!cacheDirectory.empty() && isProgramBinarySupported())
+  {
+    uint64_t key = hashString(vertexShaderSource);
+    key = hashString(fragmentShaderSource, key);
+    key = hashString(getGlString(GL_VENDOR), key);
+    key = hashString(getGlString(GL_RENDERER), key);
+    key = hashString(getGlString(GL_VERSION), key);
+
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    const std::string cachePath = (std::filesystem::path(cacheDirectory) / name.str()).string();
+    if (this->_loadBinary(cachePath, key))
+    {
+      this->isFromCache = true;
+      this->_complete();
+      return;
+    }
+
+    // A rejected binary leaves the program unlinked, so start over with a fresh one
+    glDeleteProgram(this->ID);
+    this->ID = glCreateProgram();
+    glProgramParameteri(this->ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    this->cachePath = cachePath;
+    this->cacheKey = key;
+  }
+
+  this->_compile(vertexShaderSource, fragmentShaderSource);
+}
+
+void kdr::Graphics::Shader::_compile(const std::string& vertexSource, const std::string& fragmentSource)
+{
+  // Shader Sources (C)
+  const char* vertexShaderSourceC = vertexSource.c_str();
+  const char* fragmentShaderSourceC = fragmentSource.c_str();
+
+  // Shaders
+  this->vertexShader = glCreateShader(GL_VERTEX_SHADER);
+  this->fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+
+  glShaderSource(this->vertexShader, 1, &vertexShaderSourceC, NULL);
+  glShaderSource(this->fragmentShader, 1, &fragmentShaderSourceC, NULL);
+
+  glCompileShader(this->vertexShader);
+  glCompileShader(this->fragmentShader);
+
+  // Shader Program, linked without checking the shaders, so nothing waits for the compiler
+  glAttachShader(this->ID, this->vertexShader);
+  glAttachShader(this->ID, this->fragmentShader);
   glLinkProgram(this->ID);
+}
+
+bool kdr::Graphics::Shader::_isCompleted() const
+{
+  GLint isCompleted {GL_FALSE};
+  glGetProgramiv(this->ID, GL_COMPLETION_STATUS_KHR, &isCompleted);
+  return isCompleted;
+}
 
-  // Validating the Shader Program
+void kdr::Graphics::Shader::_complete()
+{
+  if (this->vertexShader != 0)
+  {
+    // Info Log
+    int success {0};
+    char infoLog[512];
+
+    // Validating the Vertex Shader
+    glGetShaderiv(this->vertexShader, GL_COMPILE_STATUS, &success);
+    if (!success)
+    {
+      glGetShaderInfoLog(this->vertexShader, 512, NULL, infoLog);
+      std::cerr << "Failed to compile the vertex shader!\n";
+      std::cerr << "Error: " << infoLog << '\n';
+    }
+
+    // Validating the Fragment Shader
+    glGetShaderiv(this->fragmentShader, GL_COMPILE_STATUS, &success);
+    if (!success)
+    {
+      glGetShaderInfoLog(this->fragmentShader, 512, NULL, infoLog);
+      std::cerr << "Failed to compile the fragment shader!\n";
+      std::cerr << "Error: " << infoLog << '\n';
+    }
+
+    // Validating the Shader Program
+    glGetProgramiv(this->ID, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+      glGetProgramInfoLog(this->ID, 512, NULL, infoLog);
+      std::cerr << "Failed to link the shader program!\n";
+      std::cerr << "Error: " << infoLog << '\n';
+    }
+    else if (!this->cachePath.empty())
+    {
+      this->_saveBinary(this->cachePath, this->cacheKey);
+    }
+
+    // Deleting the Shaders
+    this->_releaseShaders();
+  }
+
+  // Linking the Camera Block
+  const GLuint cameraBlockIndex = glGetUniformBlockIndex(this->ID, kdr::Graphics::CAMERA_BLOCK_NAME.c_str());
+  if (cameraBlockIndex != GL_INVALID_INDEX)
+  {
+    glUniformBlockBinding(this->ID, cameraBlockIndex, kdr::Graphics::CAMERA_BLOCK_BINDING);
+  }
+
+  this->_reflect();
+  this->cachePath.clear();
+  this->isReady = true;
+}
+
+void kdr::Graphics::Shader::_releaseShaders()
+{
+  if (this->vertexShader == 0)
+  {
+    return;
+  }
+  glDetachShader(this->ID, this->vertexShader);
+  glDetachShader(this->ID, this->fragmentShader);
+  glDeleteShader(this->vertexShader);
+  glDeleteShader(this->fragmentShader);
+  this->vertexShader = 0;
+  this->fragmentShader = 0;
+}
+
+bool kdr::Graphics::Shader::_loadBinary(const std::string& cachePath, const uint64_t key)
+{
+  std::ifstream file(cachePath, std::ios::binary);
+  if (!file.is_open())
+  {
+    return false;
+  }
+
+  ProgramCacheHeader header;
+  file.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (
+    !file ||
+    std::memcmp(header.magic, "KDRP", 4) != 0 ||
+    header.version != PROGRAM_CACHE_VERSION ||
+    header.key != key
+  )
+  {
+    return false;
+  }
+  // A corrupt header could ask for gigabytes, so the size must match what the file holds
+  const std::streamoff binaryBegin = file.tellg();
+  file.seekg(0, std::ios::end);
+  const std::streamoff binaryEnd = file.tellg();
+  if (binaryBegin < 0 || binaryEnd - binaryBegin != static_cast<std::streamoff>(header.binarySize))
+  {
+    return false;
+  }
+  file.seekg(binaryBegin);
+  std::vector<char> binary(header.binarySize);
+  file.read(binary.data(), binary.size());
+  if (!file)
+  {
+    return false;
+  }
+
+  glProgramBinary(this->ID, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+  GLint success {0};
   glGetProgramiv(this->ID, GL_LINK_STATUS, &success);
-  if (!success)
+  return success;
+}
+
+void kdr::Graphics::Shader::_saveBinary(const std::string& cachePath, const uint64_t key) const
+{
+  GLint binarySize {0};
+  glGetProgramiv(this->ID, GL_PROGRAM_BINARY_LENGTH, &binarySize);
+  if (binarySize <= 0)
   {
-    glGetProgramInfoLog(this->ID, 512, NULL, infoLog);
-    std::cerr << "Failed to link the shader program!\n";
-    std::cerr << "Error: " << infoLog << '\n';
+    return;
   }
+  std::vector<char> binary(binarySize);
+  GLenum binaryFormat {0};
+  glGetProgramBinary(this->ID, binarySize, &binarySize, &binaryFormat, binary.data());
+
+  ProgramCacheHeader header {{'K', 'D', 'R', 'P'}, PROGRAM_CACHE_VERSION, key, binaryFormat, static_cast<uint32_t>(binarySize)};
+  std::error_code error;
+  std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
 
-  // Deleting the Shaders
-  glDeleteShader(vertexShader);
-  glDeleteShader(fragmentShader);
+  // Written aside and renamed, so a crash never leaves a truncated binary behind, and to a file
+  // of its own, so processes compiling the same program never write into each other's
+  const std::string temporaryPath = kdr::File::getTemporaryPath(cachePath);
+  {
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+      std::cerr << "Failed to write the program binary (" << cachePath << ")!\n";
+      return;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(binary.data(), binarySize);
+    if (!file)
+    {
+      std::cerr << "Failed to write the program binary (" << cachePath << ")!\n";
+      file.close();
+      std::filesystem::remove(temporaryPath, error);
+      return;
+    }
+  }
+  std::filesystem::rename(temporaryPath, cachePath, error);
+  if (error)
+  {
+    std::cerr << "Failed to write the program binary (" << cachePath << ")!\n";
+    std::filesystem::remove(temporaryPath, error);
+  }
 }
 
-kdr::Graphics::Shader::~Shader()
+void kdr::Graphics::Shader::_reflect()
+{
+  this->uniforms.clear();
+  this->attributes.clear();
+  this->uniformHandles.clear();
+
+  GLint linkStatus {0};
+  glGetProgramiv(this->ID, GL_LINK_STATUS, &linkStatus);
+  if (!linkStatus)
+  {
+    return;
+  }
+
+  GLint maxNameLength {0};
+  glGetProgramiv(this->ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+  GLint attributeMaxNameLength {0};
+  glGetProgramiv(this->ID, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &attributeMaxNameLength);
+  std::vector<GLchar> nameBuffer(static_cast<size_t>(std::max(maxNameLength, attributeMaxNameLength)) + 1);
+
+  // Uniforms
+  GLint uniformCount {0};
+  glGetProgramiv(this->ID, GL_ACTIVE_UNIFORMS, &uniformCount);
+  for (GLint i = 0; i < uniformCount; i++)
+  {
+    kdr::Graphics::ShaderVariable uniform;
+    GLsizei nameLength {0};
+    glGetActiveUniform(this->ID, i, nameBuffer.size(), &nameLength, &uniform.size, &uniform.type, nameBuffer.data());
+    uniform.name.assign(nameBuffer.data(), nameLength);
+    uniform.location = glGetUniformLocation(this->ID, uniform.name.c_str());
+
+    // Members of uniform blocks have no location and are set through buffers
+    if (uniform.location < 0)
+    {
+      continue;
+    }
+    if (uniform.name.size() > 3 && uniform.name.compare(uniform.name.size() - 3, 3, "[0]") == 0)
+    {
+      uniform.name.resize(uniform.name.size() - 3);
+    }
+    this->uniformHandles[uniform.name] = static_cast<GLint>(this->uniforms.size());
+    this->uniforms.push_back(uniform);
+  }
+  this->shadowValues.assign(this->uniforms.size() * kdr::Graphics::UNIFORM_SHADOW_SIZE, 0);
+  this->shadowFlags.assign(this->uniforms.size(), 0);
+
+  // Attributes
+  GLint attributeCount {0};
+  glGetProgramiv(this->ID, GL_ACTIVE_ATTRIBUTES, &attributeCount);
+  for (GLint i = 0; i < attributeCount; i++)
+  {
+    kdr::Graphics::ShaderVariable attribute;
+    GLsizei nameLength {0};
+    glGetActiveAttrib(this->ID, i, nameBuffer.size(), &nameLength, &attribute.size, &attribute.type, nameBuffer.data());
+    attribute.name.assign(nameBuffer.data(), nameLength);
+    attribute.location = glGetAttribLocation(this->ID, attribute.name.c_str());
+    this->attributes.push_back(attribute);
+  }
+}
+
+kdr::Graphics::ShaderCompiler::ShaderCompiler(const GLuint threadCount)
 {
-  glDeleteShader(this->ID);
+  if (GLEW_KHR_parallel_shader_compile)
+  {
+    glMaxShaderCompilerThreadsKHR(threadCount);
+    this->isParallel = true;
+  }
+  else if (GLEW_ARB_parallel_shader_compile)
+  {
+    glMaxShaderCompilerThreadsARB(threadCount);
+    this->isParallel = true;
+  }
 }
 
-kdr::Graphics::VBO::VBO(GLfloat vertices[], GLsizeiptr size)
+kdr::Graphics::ShaderCompiler::~ShaderCompiler()
+{
+  this->Finish();
+}
+
+void kdr::Graphics::ShaderCompiler::Update()
+{
+  bool hasFinishedOne {false};
+  size_t i {0};
+  while (i < this->pendingShaders.size())
+  {
+    kdr::Graphics::Shader& shader = *this->pendingShaders[i];
+
+    // Without polling, finishing a program blocks, so only one is finished per update
+    const bool isCompleted = this->isParallel ? shader._isCompleted() : !hasFinishedOne;
+    if (!isCompleted)
+    {
+      i++;
+      continue;
+    }
+    shader.compiler = NULL;
+    shader._complete();
+    hasFinishedOne = true;
+    this->pendingShaders[i] = this->pendingShaders.back();
+    this->pendingShaders.pop_back();
+  }
+}
+
+void kdr::Graphics::ShaderCompiler::Finish()
+{
+  for (kdr::Graphics::Shader* shader : this->pendingShaders)
+  {
+    shader->compiler = NULL;
+    shader->_complete();
+  }
+  this->pendingShaders.clear();
+}
+
+void kdr::Graphics::ShaderCompiler::_add(kdr::Graphics::Shader& shader)
+{
+  shader.compiler = this;
+  this->pendingShaders.push_back(&shader);
+}
+
+void kdr::Graphics::ShaderCompiler::_remove(kdr::Graphics::Shader& shader)
+{
+  shader.compiler = NULL;
+  this->pendingShaders.erase(
+    std::remove(this->pendingShaders.begin(), this->pendingShaders.end(), &shader),
+    this->pendingShaders.end()
+  );
+}
+
+kdr::Graphics::VBO::VBO(const void* vertices, GLsizeiptr size)
 {
   glGenBuffers(1, &this->ID);
   glBindBuffer(GL_ARRAY_BUFFER, this->ID);
@@ -75,14 +732,198 @@ kdr::Graphics::VBO::VBO(GLfloat vertices[], GLsizeiptr size)
   glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
-kdr::Graphics::EBO::EBO(GLuint indices[], GLsizeiptr size)
+void kdr::Graphics::VBO::SetData(const void* data, GLsizeiptr size, GLenum usage) const
 {
+  glBindBuffer(GL_ARRAY_BUFFER, this->ID);
+  glBufferData(GL_ARRAY_BUFFER, size, data, usage);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/**
+ * @brief Narrows indices to a smaller index type.
+ *
+ * @tparam T The index type.
+ * @param indices The indices.
+ * @param count The number of indices.
+ * @param primitiveRestart Whether restart markers are mapped to the largest value of the type.
+ * @return The narrowed indices.
+ */
+template <typename T>
+static std::vector<T> narrowIndices(const GLuint indices[], const size_t count, const bool primitiveRestart)
+{
+  std::vector<T> narrowed(count);
+  for (size_t i = 0; i < count; i++)
+  {
+    const bool isRestart = primitiveRestart && indices[i] == kdr::Graphics::PRIMITIVE_RESTART_INDEX;
+    narrowed[i] = isRestart ? static_cast<T>(~T(0)) : static_cast<T>(indices[i]);
+  }
+  return narrowed;
+}
+
+kdr::Graphics::EBO::EBO(const GLuint indices[], GLsizeiptr size, bool primitiveRestart)
+{
+  this->count = static_cast<GLsizei>(size / sizeof(GLuint));
+
+  // The largest value of each type is kept free, since it is the restart index
+  GLuint maxIndex {0};
+  for (GLsizei i = 0; i < this->count; i++)
+  {
+    if (!(primitiveRestart && indices[i] == kdr::Graphics::PRIMITIVE_RESTART_INDEX))
+    {
+      maxIndex = std::max(maxIndex, indices[i]);
+    }
+  }
+
   glGenBuffers(1, &this->ID);
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->ID);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, indices, GL_STATIC_DRAW);
+  if (maxIndex < 0xff)
+  {
+    this->type = GL_UNSIGNED_BYTE;
+    const std::vector<GLubyte> narrowed = narrowIndices<GLubyte>(indices, this->count, primitiveRestart);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, narrowed.size() * sizeof(GLubyte), narrowed.data(), GL_STATIC_DRAW);
+  }
+  else if (maxIndex < 0xffff)
+  {
+    this->type = GL_UNSIGNED_SHORT;
+    const std::vector<GLushort> narrowed = narrowIndices<GLushort>(indices, this->count, primitiveRestart);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, narrowed.size() * sizeof(GLushort), narrowed.data(), GL_STATIC_DRAW);
+  }
+  else
+  {
+    this->type = GL_UNSIGNED_INT;
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, indices, GL_STATIC_DRAW);
+  }
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
+kdr::Graphics::UBO::UBO(GLsizeiptr size)
+{
+  glGenBuffers(1, &this->ID);
+  glBindBuffer(GL_UNIFORM_BUFFER, this->ID);
+  glBufferData(GL_UNIFORM_BUFFER, size, NULL, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void kdr::Graphics::UBO::SetData(GLintptr offset, GLsizeiptr size, const void* data) const
+{
+  glBindBuffer(GL_UNIFORM_BUFFER, this->ID);
+  glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+kdr::Graphics::StreamBuffer::StreamBuffer(GLenum target, GLsizeiptr regionSize, GLuint regionCount)
+: target(target), regionSize(regionSize), regionCount(regionCount), regionEnd(regionSize), fences(regionCount, NULL)
+{
+  const GLsizeiptr size = regionSize * regionCount;
+  glGenBuffers(1, &this->ID);
+  glBindBuffer(this->target, this->ID);
+  if (GLEW_ARB_buffer_storage)
+  {
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(this->target, size, NULL, flags);
+    this->mapped = static_cast<GLubyte*>(glMapBufferRange(this->target, 0, size, flags));
+    if (this->mapped == NULL)
+    {
+      std::cerr << "Failed to map the stream buffer!\n";
+      // Immutable storage can't be orphaned, so the fallback needs a buffer of its own
+      glBindBuffer(this->target, 0);
+      glDeleteBuffers(1, &this->ID);
+      glGenBuffers(1, &this->ID);
+      glBindBuffer(this->target, this->ID);
+    }
+  }
+  if (this->mapped == NULL)
+  {
+    glBufferData(this->target, size, NULL, GL_STREAM_DRAW);
+  }
+  glBindBuffer(this->target, 0);
+}
+
+kdr::Graphics::StreamBuffer::~StreamBuffer()
+{
+  for (GLsync fence : this->fences)
+  {
+    if (fence != NULL)
+    {
+      glDeleteSync(fence);
+    }
+  }
+  glDeleteBuffers(1, &this->ID);
+}
+
+GLintptr kdr::Graphics::StreamBuffer::Allocate(GLsizeiptr size, GLsizeiptr alignment)
+{
+  const GLintptr offset = (this->head + alignment - 1) & ~static_cast<GLintptr>(alignment - 1);
+  if (offset + size > this->regionEnd)
+  {
+    return -1;
+  }
+  this->head = offset + size;
+  return offset;
+}
+
+void kdr::Graphics::StreamBuffer::Upload(GLintptr offset, const void* data, GLsizeiptr size) const
+{
+  if (this->mapped != NULL)
+  {
+    std::memcpy(this->mapped + offset, data, size);
+    return;
+  }
+  glBindBuffer(this->target, this->ID);
+  glBufferSubData(this->target, offset, size, data);
+  glBindBuffer(this->target, 0);
+}
+
+GLintptr kdr::Graphics::StreamBuffer::Write(const void* data, GLsizeiptr size, GLsizeiptr alignment)
+{
+  const GLintptr offset = this->Allocate(size, alignment);
+  if (offset >= 0)
+  {
+    this->Upload(offset, data, size);
+  }
+  return offset;
+}
+
+void kdr::Graphics::StreamBuffer::NextFrame()
+{
+  if (this->mapped != NULL)
+  {
+    this->fences[this->region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  }
+  this->region = (this->region + 1) % this->regionCount;
+  this->head = this->region * this->regionSize;
+  this->regionEnd = this->head + this->regionSize;
+
+  // Without persistent mapping, fresh storage keeps the driver from waiting on old draws
+  if (this->mapped == NULL)
+  {
+    if (this->region == 0)
+    {
+      glBindBuffer(this->target, this->ID);
+      glBufferData(this->target, this->regionSize * this->regionCount, NULL, GL_STREAM_DRAW);
+      glBindBuffer(this->target, 0);
+    }
+    return;
+  }
+
+  GLsync& fence = this->fences[this->region];
+  if (fence == NULL)
+  {
+    return;
+  }
+  GLenum result = glClientWaitSync(fence, 0, 0);
+  while (result == GL_TIMEOUT_EXPIRED)
+  {
+    result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+  }
+  if (result == GL_WAIT_FAILED)
+  {
+    std::cerr << "Failed to wait for the stream buffer fence!\n";
+  }
+  glDeleteSync(fence);
+  fence = NULL;
+}
+
 void kdr::Graphics::VAO::LinkAttrib(const kdr::Graphics::VBO& VBO, GLuint layout, GLuint size, GLenum type, GLsizeiptr stride, const void* offset) const
 {
   VBO.Bind();
@@ -91,6 +932,61 @@ void kdr::Graphics::VAO::LinkAttrib(const kdr::Graphics::VBO& VBO, GLuint layout
   VBO.Unbind();
 }
 
+void kdr::Graphics::VAO::LinkLayout(const kdr::Graphics::VBO& VBO, const kdr::Graphics::VertexLayout& layout) const
+{
+  bool isLinked[3] {false, false, false};
+
+  VBO.Bind();
+  for (const kdr::Graphics::VertexAttribute& attribute : layout.attributes)
+  {
+    glVertexAttribPointer(
+      attribute.location,
+      attribute.size,
+      attribute.type,
+      attribute.normalized ? GL_TRUE : GL_FALSE,
+      layout.stride,
+      reinterpret_cast<const void*>(attribute.offset)
+    );
+    glEnableVertexAttribArray(attribute.location);
+    if (attribute.location < 3)
+    {
+      isLinked[attribute.location] = true;
+    }
+  }
+  VBO.Unbind();
+
+  for (GLuint location = 0; location < 3; location++)
+  {
+    if (!isLinked[location])
+    {
+      glDisableVertexAttribArray(location);
+    }
+  }
+  // The current value of a disabled attribute is context state, so it is shared by every VAO
+  if (!isLinked[1])
+  {
+    glVertexAttrib4f(1, 1.f, 1.f, 1.f, 1.f);
+  }
+}
+
+void kdr::Graphics::VAO::LinkInstanceAttrib(const kdr::Graphics::VBO& VBO, GLuint layout, GLuint size, GLenum type, GLsizeiptr stride, const void* offset) const
+{
+  VBO.Bind();
+  glVertexAttribPointer(layout, size, type, GL_FALSE, stride, offset);
+  glEnableVertexAttribArray(layout);
+  glVertexAttribDivisor(layout, 1);
+  VBO.Unbind();
+}
+
+void kdr::Graphics::VAO::LinkInstanceAttrib(const kdr::Graphics::StreamBuffer& buffer, GLuint layout, GLuint size, GLenum type, GLsizeiptr stride, GLintptr offset) const
+{
+  glBindBuffer(GL_ARRAY_BUFFER, buffer.getID());
+  glVertexAttribPointer(layout, size, type, GL_FALSE, stride, reinterpret_cast<const void*>(offset));
+  glEnableVertexAttribArray(layout);
+  glVertexAttribDivisor(layout, 1);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
 kdr::Graphics::Texture::Texture(const std::string& pngPath, GLenum type, GLenum slot, GLenum pixelType) : type(type)
 {
   int imgWidth {0};
@@ -105,8 +1001,8 @@ kdr::Graphics::Texture::Texture(const std::string& pngPath, GLenum type, GLenum
   }
 
   glGenTextures(1, &this->ID);
-  glActiveTexture(slot);
-  glBindTexture(this->type, this->ID);
+  kdr::State::getCache().activeTexture(slot);
+  kdr::State::getCache().bindTexture(this->type, this->ID);
 
   glTexParameteri(this->type, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
   glTexParameteri(this->type, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -126,4 +1022,642 @@ kdr::Graphics::Texture::Texture(const std::string& pngPath, GLenum type, GLenum
 
   glBindTexture(slot, 0);
   delete imageData;
+
+  this->width = imgWidth;
+  this->height = imgHeight;
+  this->isReady = true;
+}
+
+kdr::Graphics::Texture::Texture(GLenum type, const kdr::Graphics::TextureSampling& sampling) : type(type), sampling(sampling)
+{
+  glGenTextures(1, &this->ID);
+}
+
+kdr::Graphics::Texture::Texture(GLenum type, GLsizei width, GLsizei height, const GLubyte* pixels, const kdr::Graphics::TextureSampling& sampling) : type(type), sampling(sampling)
+{
+  glGenTextures(1, &this->ID);
+  this->_allocate(width, height);
+  glTexSubImage2D(this->type, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+  glGenerateMipmap(this->type);
+  this->isReady = true;
+}
+
+size_t kdr::Graphics::Texture::getMemorySize() const
+{
+  const size_t texelCount = static_cast<size_t>(this->width) * this->height;
+  size_t bitsPerTexel {32};
+  if (this->internalFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT)
+  {
+    bitsPerTexel = 4;
+  }
+  else if (this->internalFormat == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT)
+  {
+    bitsPerTexel = 8;
+  }
+  return texelCount * bitsPerTexel / 8 * 4 / 3;
+}
+
+void kdr::Graphics::Texture::_allocate(const GLsizei width, const GLsizei height, const GLenum internalFormat)
+{
+  GLsizei levelCount {1};
+  while ((std::max(width, height) >> levelCount) > 0)
+  {
+    levelCount++;
+  }
+
+  kdr::State::getCache().bindTexture(this->type, this->ID);
+  glTexParameteri(this->type, GL_TEXTURE_MIN_FILTER, this->sampling.minFilter);
+  glTexParameteri(this->type, GL_TEXTURE_MAG_FILTER, this->sampling.magFilter);
+  glTexParameteri(this->type, GL_TEXTURE_WRAP_S, this->sampling.wrapS);
+  glTexParameteri(this->type, GL_TEXTURE_WRAP_T, this->sampling.wrapT);
+  if (GLEW_ARB_texture_storage)
+  {
+    glTexStorage2D(this->type, levelCount, internalFormat, width, height);
+  }
+  else
+  {
+    for (GLsizei level = 0; level < levelCount; level++)
+    {
+      glTexImage2D(
+        this->type,
+        level,
+        internalFormat,
+        std::max(width >> level, 1),
+        std::max(height >> level, 1),
+        0,
+        GL_RGBA,
+        GL_UNSIGNED_BYTE,
+        NULL
+      );
+    }
+  }
+
+  this->internalFormat = internalFormat;
+  this->width = width;
+  this->height = height;
+}
+
+kdr::Graphics::TextureArray::TextureArray(const std::vector<std::string>& pngPaths, const kdr::Graphics::TextureSampling& sampling)
+{
+  if (pngPaths.empty() || !kdr::Image::readPngSize(pngPaths[0], this->width, this->height))
+  {
+    std::cerr << "Failed to create the texture array!\n";
+    return;
+  }
+  this->layerCount = static_cast<GLsizei>(pngPaths.size());
+
+  GLsizei levelCount {1};
+  while ((std::max(this->width, this->height) >> levelCount) > 0)
+  {
+    levelCount++;
+  }
+
+  glGenTextures(1, &this->ID);
+  this->Bind();
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, sampling.minFilter);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, sampling.magFilter);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, sampling.wrapS);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, sampling.wrapT);
+  if (GLEW_ARB_texture_storage)
+  {
+    glTexStorage3D(GL_TEXTURE_2D_ARRAY, levelCount, GL_RGBA8, this->width, this->height, this->layerCount);
+  }
+  else
+  {
+    for (GLsizei level = 0; level < levelCount; level++)
+    {
+      glTexImage3D(
+        GL_TEXTURE_2D_ARRAY,
+        level,
+        GL_RGBA8,
+        std::max(this->width >> level, 1),
+        std::max(this->height >> level, 1),
+        this->layerCount,
+        0,
+        GL_RGBA,
+        GL_UNSIGNED_BYTE,
+        NULL
+      );
+    }
+  }
+
+  std::vector<GLubyte> pixels(static_cast<size_t>(this->width) * this->height * 4);
+  for (GLsizei layer = 0; layer < this->layerCount; layer++)
+  {
+    int imgWidth {0};
+    int imgHeight {0};
+    if (!kdr::Image::readPngSize(pngPaths[layer], imgWidth, imgHeight))
+    {
+      continue;
+    }
+    if (imgWidth != this->width || imgHeight != this->height)
+    {
+      std::cerr << "Failed to add texture (" << pngPaths[layer] << ") to the texture array, its size differs!\n";
+      continue;
+    }
+    if (kdr::Image::loadRgbaFromPng(pngPaths[layer], pixels.data(), imgWidth, imgHeight))
+    {
+      glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, this->width, this->height, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    }
+  }
+  glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+}
+
+kdr::Graphics::TextureAtlas::TextureAtlas(const std::vector<std::string>& pngPaths, const GLsizei maxSize, const kdr::Graphics::TextureSampling& sampling)
+{
+  struct Image
+  {
+    GLsizei width {0};
+    GLsizei height {0};
+    GLsizei x {0};
+    GLsizei y {0};
+    bool isPlaced {false};
+    std::vector<GLubyte> pixels;
+  };
+  std::vector<Image> images(pngPaths.size());
+  std::vector<size_t> order;
+  size_t totalArea {0};
+  GLsizei widest {1};
+  for (size_t i = 0; i < pngPaths.size(); i++)
+  {
+    int imgWidth {0};
+    int imgHeight {0};
+    if (!kdr::Image::readPngSize(pngPaths[i], imgWidth, imgHeight) || imgWidth <= 0 || imgHeight <= 0)
+    {
+      continue;
+    }
+    images[i].pixels.resize(static_cast<size_t>(imgWidth) * imgHeight * 4);
+    if (!kdr::Image::loadRgbaFromPng(pngPaths[i], images[i].pixels.data(), imgWidth, imgHeight))
+    {
+      continue;
+    }
+    images[i].width = imgWidth;
+    images[i].height = imgHeight;
+    totalArea += static_cast<size_t>(imgWidth + 2 * kdr::Graphics::ATLAS_PADDING) * (imgHeight + 2 * kdr::Graphics::ATLAS_PADDING);
+    widest = std::max(widest, imgWidth + 2 * kdr::Graphics::ATLAS_PADDING);
+    order.push_back(i);
+  }
+  std::sort(order.begin(), order.end(), [&images](const size_t lhs, const size_t rhs) {
+    return images[lhs].height > images[rhs].height;
+  });
+
+  // Shelf packing, widening the atlas until everything fits or the width reaches maxSize
+  GLsizei atlasWidth {1};
+  while (atlasWidth < maxSize && (static_cast<size_t>(atlasWidth) * atlasWidth < totalArea || atlasWidth < widest))
+  {
+    atlasWidth *= 2;
+  }
+  atlasWidth = std::min(atlasWidth, maxSize);
+  GLsizei atlasHeight {1};
+  while (true)
+  {
+    GLsizei x {0};
+    GLsizei y {0};
+    GLsizei shelfHeight {0};
+    bool isComplete {true};
+    for (const size_t i : order)
+    {
+      Image& image = images[i];
+      const GLsizei paddedWidth = image.width + 2 * kdr::Graphics::ATLAS_PADDING;
+      const GLsizei paddedHeight = image.height + 2 * kdr::Graphics::ATLAS_PADDING;
+      if (x + paddedWidth > atlasWidth)
+      {
+        x = 0;
+        y += shelfHeight;
+        shelfHeight = 0;
+      }
+      image.isPlaced = paddedWidth <= atlasWidth && y + paddedHeight <= maxSize;
+      if (!image.isPlaced)
+      {
+        isComplete = false;
+        continue;
+      }
+      image.x = x + kdr::Graphics::ATLAS_PADDING;
+      image.y = y + kdr::Graphics::ATLAS_PADDING;
+      x += paddedWidth;
+      shelfHeight = std::max(shelfHeight, paddedHeight);
+      atlasHeight = std::max(atlasHeight, y + paddedHeight);
+    }
+    if (isComplete || atlasWidth >= maxSize)
+    {
+      break;
+    }
+    atlasWidth = std::min(atlasWidth * 2, maxSize);
+    atlasHeight = 1;
+  }
+
+  std::vector<GLubyte> pixels(static_cast<size_t>(atlasWidth) * atlasHeight * 4, 0);
+  this->regions.resize(pngPaths.size(), {0.f, 0.f, 0.f, 0.f, 0.f});
+  for (size_t i = 0; i < images.size(); i++)
+  {
+    const Image& image = images[i];
+    if (!image.isPlaced)
+    {
+      if (!image.pixels.empty())
+      {
+        std::cerr << "Failed to fit texture (" << pngPaths[i] << ") into the texture atlas!\n";
+      }
+      continue;
+    }
+
+    // The padding repeats the edge pixels, so filtering at the edges samples the image itself
+    const GLsizei padding = kdr::Graphics::ATLAS_PADDING;
+    for (GLsizei y = -padding; y < image.height + padding; y++)
+    {
+      const GLsizei sourceY = std::min(std::max(y, 0), image.height - 1);
+      for (GLsizei x = -padding; x < image.width + padding; x++)
+      {
+        const GLsizei sourceX = std::min(std::max(x, 0), image.width - 1);
+        std::memcpy(
+          pixels.data() + (static_cast<size_t>(image.y + y) * atlasWidth + image.x + x) * 4,
+          image.pixels.data() + (static_cast<size_t>(sourceY) * image.width + sourceX) * 4,
+          4
+        );
+      }
+    }
+
+    this->regions[i] = {
+      static_cast<GLfloat>(image.x) / atlasWidth,
+      static_cast<GLfloat>(image.y) / atlasHeight,
+      static_cast<GLfloat>(image.width) / atlasWidth,
+      static_cast<GLfloat>(image.height) / atlasHeight,
+      0.f
+    };
+  }
+
+  this->texture = new kdr::Graphics::Texture(GL_TEXTURE_2D, atlasWidth, atlasHeight, pixels.data(), sampling);
+}
+
+kdr::Graphics::TextureLoader::TextureLoader(const unsigned int threadCount, const size_t maxUploadsInFlight)
+: maxUploadsInFlight(std::max<size_t>(maxUploadsInFlight, 1))
+{
+  for (unsigned int i = 0; i < std::max(threadCount, 1u); i++)
+  {
+    this->workers.emplace_back(&kdr::Graphics::TextureLoader::_work, this);
+  }
+}
+
+kdr::Graphics::TextureLoader::~TextureLoader()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->isStopping = true;
+  }
+  this->condition.notify_all();
+  for (std::thread& worker : this->workers)
+  {
+    worker.join();
+  }
+
+  for (const std::unique_ptr<Job>& job : this->activeJobs)
+  {
+    // Compressed jobs decode into memory and never own a pixel buffer
+    if (job->PBO == 0)
+    {
+      continue;
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, job->PBO);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glDeleteBuffers(1, &job->PBO);
+  }
+}
+
+void kdr::Graphics::TextureLoader::Load(kdr::Graphics::Texture& texture, const std::string& pngPath, const kdr::Compression::Format format)
+{
+  std::unique_ptr<Job> job = std::make_unique<Job>();
+  job->texture = &texture;
+  job->path = pngPath;
+  job->format = kdr::Compression::isSupported(format) ? format : kdr::Compression::Format::None;
+  job->cacheDirectory = this->cacheDirectory;
+  this->queuedJobs.push_back(std::move(job));
+}
+
+void kdr::Graphics::TextureLoader::Cancel(const kdr::Graphics::Texture& texture)
+{
+  this->queuedJobs.erase(
+    std::remove_if(
+      this->queuedJobs.begin(),
+      this->queuedJobs.end(),
+      [&texture](const std::unique_ptr<Job>& job) { return job->texture == &texture; }
+    ),
+    this->queuedJobs.end()
+  );
+  // The workers never touch the texture, so active jobs just forget it
+  for (const std::unique_ptr<Job>& job : this->activeJobs)
+  {
+    if (job->texture == &texture)
+    {
+      job->texture = NULL;
+    }
+  }
+}
+
+void kdr::Graphics::TextureLoader::Update()
+{
+  std::vector<std::unique_ptr<Job>> decodedJobs;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (size_t i = 0; i < this->activeJobs.size();)
+    {
+      if (this->activeJobs[i]->isDecoded)
+      {
+        decodedJobs.push_back(std::move(this->activeJobs[i]));
+        this->activeJobs[i] = std::move(this->activeJobs.back());
+        this->activeJobs.pop_back();
+        continue;
+      }
+      i++;
+    }
+  }
+  for (const std::unique_ptr<Job>& job : decodedJobs)
+  {
+    this->_finish(*job);
+  }
+
+  while (!this->queuedJobs.empty() && this->activeJobs.size() < this->maxUploadsInFlight)
+  {
+    std::unique_ptr<Job> job = std::move(this->queuedJobs.front());
+    this->queuedJobs.pop_front();
+    if (!this->_start(*job))
+    {
+      continue;
+    }
+
+    Job* decodeJob = job.get();
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->activeJobs.push_back(std::move(job));
+      this->decodeQueue.push_back(decodeJob);
+    }
+    this->condition.notify_one();
+  }
+}
+
+bool kdr::Graphics::TextureLoader::_start(Job& job)
+{
+  if (job.format != kdr::Compression::Format::None)
+  {
+    return true;
+  }
+
+  int imgWidth {0};
+  int imgHeight {0};
+  if (!kdr::Image::readPngSize(job.path, imgWidth, imgHeight) || imgWidth <= 0 || imgHeight <= 0)
+  {
+    std::cerr << "Failed to load texture (" << job.path << ")!\n";
+    job.texture->isFailed = true;
+    this->finishedCount++;
+    return false;
+  }
+  job.width = imgWidth;
+  job.height = imgHeight;
+  job.texture->_allocate(job.width, job.height);
+
+  const GLsizeiptr size = static_cast<GLsizeiptr>(job.width) * job.height * 4;
+  glGenBuffers(1, &job.PBO);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, job.PBO);
+  glBufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+  job.pixels = static_cast<GLubyte*>(glMapBufferRange(
+    GL_PIXEL_UNPACK_BUFFER,
+    0,
+    size,
+    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT
+  ));
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+  if (job.pixels == NULL)
+  {
+    std::cerr << "Failed to map the pixel buffer of texture (" << job.path << ")!\n";
+    glDeleteBuffers(1, &job.PBO);
+    job.texture->isFailed = true;
+    this->finishedCount++;
+    return false;
+  }
+  return true;
+}
+
+void kdr::Graphics::TextureLoader::_finish(Job& job)
+{
+  this->finishedCount++;
+  if (job.format != kdr::Compression::Format::None)
+  {
+    const kdr::Compression::CompressedImage& image = job.compressedImage;
+    if (job.texture == NULL)
+    {
+      return;
+    }
+    if (!job.hasSucceeded)
+    {
+      std::cerr << "Failed to load texture (" << job.path << ")!\n";
+      job.texture->isFailed = true;
+      return;
+    }
+
+    const GLenum internalFormat = kdr::Compression::getInternalFormat(image.format);
+    job.texture->_allocate(image.width, image.height, internalFormat);
+    for (size_t level = 0; level < image.levels.size(); level++)
+    {
+      glCompressedTexSubImage2D(
+        job.texture->type,
+        static_cast<GLint>(level),
+        0,
+        0,
+        std::max(image.width >> level, 1),
+        std::max(image.height >> level, 1),
+        internalFormat,
+        static_cast<GLsizei>(image.levels[level].size()),
+        image.levels[level].data()
+      );
+    }
+    job.texture->isReady = true;
+    return;
+  }
+
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, job.PBO);
+  const bool isIntact = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;
+
+  if (job.texture == NULL)
+  {
+    // Cancelled, so only the pixel buffer is left to release
+  }
+  else if (job.hasSucceeded && isIntact)
+  {
+    // The copy is queued on the GPU, which keeps the buffer alive until it completes
+    kdr::State::getCache().bindTexture(job.texture->type, job.texture->ID);
+    glTexSubImage2D(job.texture->type, 0, 0, 0, job.width, job.height, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glGenerateMipmap(job.texture->type);
+    job.texture->isReady = true;
+  }
+  else
+  {
+    std::cerr << "Failed to load texture (" << job.path << ")!\n";
+    job.texture->isFailed = true;
+  }
+
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  glDeleteBuffers(1, &job.PBO);
+}
+
+void kdr::Graphics::TextureLoader::_work()
+{
+  while (true)
+  {
+    Job* job {NULL};
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->condition.wait(lock, [this]() { return this->isStopping || !this->decodeQueue.empty(); });
+      if (this->isStopping)
+      {
+        return;
+      }
+      job = this->decodeQueue.front();
+      this->decodeQueue.pop_front();
+    }
+
+    const bool hasSucceeded = job->format != kdr::Compression::Format::None
+      ? kdr::Compression::loadPng(job->path, job->format, job->cacheDirectory, job->compressedImage)
+      : kdr::Image::loadRgbaFromPng(job->path, job->pixels, job->width, job->height);
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    job->hasSucceeded = hasSucceeded;
+    job->isDecoded = true;
+  }
+}
+
+kdr::Graphics::TextureCache::TextureCache(kdr::Graphics::TextureLoader& loader, const size_t memoryBudget)
+: loader(loader), memoryBudget(memoryBudget)
+{}
+
+kdr::Graphics::TextureCache::~TextureCache()
+{
+  for (kdr::Graphics::Texture* texture : this->textures)
+  {
+    if (texture != NULL)
+    {
+      this->loader.Cancel(*texture);
+      delete texture;
+    }
+  }
+}
+
+size_t kdr::Graphics::TextureCache::acquire(const std::string& pngPath, const kdr::Graphics::TextureSampling& sampling, const kdr::Compression::Format format)
+{
+  const std::string key = kdr::Graphics::TextureCache::_makeKey(pngPath, sampling, format);
+  const std::unordered_map<std::string, size_t>::const_iterator it = this->handles.find(key);
+  if (it != this->handles.end())
+  {
+    this->referenceCounts[it->second]++;
+    this->hitCount++;
+    return it->second;
+  }
+  this->missCount++;
+
+  size_t handle = this->textures.size();
+  if (!this->freeHandles.empty())
+  {
+    handle = this->freeHandles.back();
+    this->freeHandles.pop_back();
+  }
+  else
+  {
+    this->textures.push_back(NULL);
+    this->referenceCounts.push_back(0);
+    this->keys.emplace_back();
+    this->releaseTimes.push_back(0);
+  }
+
+  this->textures[handle] = new kdr::Graphics::Texture(GL_TEXTURE_2D, sampling);
+  this->loader.Load(*this->textures[handle], pngPath, format);
+
+  this->referenceCounts[handle] = 1;
+  this->keys[handle] = key;
+  this->handles[key] = handle;
+  this->_evict();
+  return handle;
+}
+
+void kdr::Graphics::TextureCache::release(const size_t handle)
+{
+  if (this->referenceCounts[handle] == 0)
+  {
+    std::cerr << "Failed to release texture (" << handle << "), it has no references!\n";
+    return;
+  }
+  if (--this->referenceCounts[handle] > 0)
+  {
+    return;
+  }
+  this->releaseTimes[handle] = ++this->releaseClock;
+  this->_evict();
+}
+
+void kdr::Graphics::TextureCache::Update()
+{
+  if (this->loader.getFinishedCount() == this->finishedCount)
+  {
+    return;
+  }
+  this->finishedCount = this->loader.getFinishedCount();
+  this->_evict();
+}
+
+size_t kdr::Graphics::TextureCache::getMemoryUsage() const
+{
+  size_t memoryUsage {0};
+  for (const std::pair<const std::string, size_t>& entry : this->handles)
+  {
+    memoryUsage += this->textures[entry.second]->getMemorySize();
+  }
+  return memoryUsage;
+}
+
+void kdr::Graphics::TextureCache::setMemoryBudget(const size_t memoryBudget)
+{
+  this->memoryBudget = memoryBudget;
+  this->_evict();
+}
+
+void kdr::Graphics::TextureCache::_evict()
+{
+  size_t memoryUsage = this->getMemoryUsage();
+  while (memoryUsage > this->memoryBudget)
+  {
+    size_t oldest = static_cast<size_t>(-1);
+    for (const std::pair<const std::string, size_t>& entry : this->handles)
+    {
+      const size_t handle = entry.second;
+      const kdr::Graphics::Texture* texture = this->textures[handle];
+      if (this->referenceCounts[handle] > 0 || (!texture->getIsReady() && !texture->getIsFailed()))
+      {
+        continue;
+      }
+      if (oldest == static_cast<size_t>(-1) || this->releaseTimes[handle] < this->releaseTimes[oldest])
+      {
+        oldest = handle;
+      }
+    }
+    if (oldest == static_cast<size_t>(-1))
+    {
+      return;
+    }
+
+    memoryUsage -= this->textures[oldest]->getMemorySize();
+    delete this->textures[oldest];
+    this->textures[oldest] = NULL;
+    this->handles.erase(this->keys[oldest]);
+    this->keys[oldest].clear();
+    this->freeHandles.push_back(oldest);
+    this->evictionCount++;
+  }
+}
+
+std::string kdr::Graphics::TextureCache::_makeKey(const std::string& pngPath, const kdr::Graphics::TextureSampling& sampling, const kdr::Compression::Format format)
+{
+  return pngPath + '#' +
+    std::to_string(static_cast<int>(format)) + ',' +
+    std::to_string(sampling.minFilter) + ',' +
+    std::to_string(sampling.magFilter) + ',' +
+    std::to_string(sampling.wrapS) + ',' +
+    std::to_string(sampling.wrapT);
 }
@@ -63,3 +63,111 @@ bool kdr::Image::loadFromPng(const std::string& path, GLubyte** data, int& imgWi
 
   return true;
 }
+
+bool kdr::Image::readPngSize(const std::string& path, int& imgWidth, int& imgHeight)
+{
+  FILE* file = fopen(path.c_str(), "rb");
+  if (file == NULL)
+  {
+    std::cerr << "Failed to open file (" << path << ")!\n";
+    return false;
+  }
+
+  png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+  if (png == NULL) {
+    std::cerr << "Error creating PNG read structure!\n";
+    fclose(file);
+    return false;
+  }
+  png_infop info = png_create_info_struct(png);
+  if (info == NULL) {
+    std::cerr << "Error creating PNG info structure!\n";
+    png_destroy_read_struct(&png, NULL, NULL);
+    fclose(file);
+    return false;
+  }
+
+  if (setjmp(png_jmpbuf(png)))
+  {
+    png_destroy_read_struct(&png, &info, NULL);
+    fclose(file);
+    return false;
+  }
+
+  png_init_io(png, file);
+  png_read_info(png, info);
+  imgWidth = png_get_image_width(png, info);
+  imgHeight = png_get_image_height(png, info);
+
+  png_destroy_read_struct(&png, &info, NULL);
+  fclose(file);
+
+  return true;
+}
+
+bool kdr::Image::loadRgbaFromPng(const std::string& path, GLubyte* data, const int imgWidth, const int imgHeight)
+{
+  FILE* file = fopen(path.c_str(), "rb");
+  if (file == NULL)
+  {
+    std::cerr << "Failed to open file (" << path << ")!\n";
+    return false;
+  }
+
+  png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+  if (png == NULL) {
+    std::cerr << "Error creating PNG read structure!\n";
+    fclose(file);
+    return false;
+  }
+  png_infop info = png_create_info_struct(png);
+  if (info == NULL) {
+    std::cerr << "Error creating PNG info structure!\n";
+    png_destroy_read_struct(&png, NULL, NULL);
+    fclose(file);
+    return false;
+  }
+
+  // Declared before setjmp, since locals changed afterwards are indeterminate after a longjmp
+  std::vector<png_bytep> rowPointers(imgHeight);
+  if (setjmp(png_jmpbuf(png)))
+  {
+    png_destroy_read_struct(&png, &info, NULL);
+    fclose(file);
+    return false;
+  }
+
+  png_init_io(png, file);
+  png_read_info(png, info);
+  if (
+    static_cast<int>(png_get_image_width(png, info)) != imgWidth ||
+    static_cast<int>(png_get_image_height(png, info)) != imgHeight
+  )
+  {
+    std::cerr << "Failed to decode PNG file (" << path << "), its size changed!\n";
+    png_destroy_read_struct(&png, &info, NULL);
+    fclose(file);
+    return false;
+  }
+
+  png_set_expand(png);
+  png_set_strip_16(png);
+  png_set_gray_to_rgb(png);
+  png_set_filler(png, 0xff, PNG_FILLER_AFTER);
+  png_set_interlace_handling(png);
+  png_read_update_info(png, info);
+
+  // Rows are decoded straight into the buffer, bottom-up as OpenGL expects them
+  const size_t rowBytes = static_cast<size_t>(imgWidth) * 4;
+  for (int i = 0; i < imgHeight; i++)
+  {
+    rowPointers[i] = data + rowBytes * (imgHeight - 1 - i);
+  }
+  png_read_image(png, rowPointers.data());
+  png_read_end(png, NULL);
+
+  png_destroy_read_struct(&png, &info, NULL);
+  fclose(file);
+
+  return true;
+}
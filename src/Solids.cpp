@@ -1,24 +1,304 @@
 #include "Kedarium/Solids.hpp"
 
-void kdr::Solids::Solid::initializeMembers(GLfloat vertices[], GLsizeiptr verticesSize, GLuint indices[], GLsizeiptr indicesSize)
+size_t kdr::Solids::BoundsTable::add(const kdr::Solids::Solid* owner)
 {
-  this->VAO = new kdr::Graphics::VAO();
-  this->VBO = new kdr::Graphics::VBO(vertices, verticesSize);
-  this->EBO = new kdr::Graphics::EBO(indices, indicesSize);
+  size_t handle = this->indices.size();
+  if (!this->freeHandles.empty())
+  {
+    handle = this->freeHandles.back();
+    this->freeHandles.pop_back();
+  }
+  else
+  {
+    this->indices.push_back(0);
+  }
 
-  this->VAO->Bind();
-  this->VBO->Bind();
-  this->EBO->Bind();
+  this->indices[handle] = this->owners.size();
+  this->owners.push_back(owner);
+  this->handles.push_back(handle);
+  this->dirtyFlags.push_back(0);
+  this->centerXs.push_back(0.f);
+  this->centerYs.push_back(0.f);
+  this->centerZs.push_back(0.f);
+  this->radii.push_back(0.f);
+  this->minXs.push_back(0.f);
+  this->minYs.push_back(0.f);
+  this->minZs.push_back(0.f);
+  this->maxXs.push_back(0.f);
+  this->maxYs.push_back(0.f);
+  this->maxZs.push_back(0.f);
 
-  this->VAO->LinkAttrib(*this->VBO, 0, 3, GL_FLOAT, 8 * sizeof(GLfloat), (void*)0);
-  this->VAO->LinkAttrib(*this->VBO, 1, 3, GL_FLOAT, 8 * sizeof(GLfloat), (void*)(3 * sizeof(GLfloat)));
-  this->VAO->LinkAttrib(*this->VBO, 2, 2, GL_FLOAT, 8 * sizeof(GLfloat), (void*)(6 * sizeof(GLfloat)));
+  this->markDirty(handle);
+  return handle;
+}
+
+void kdr::Solids::BoundsTable::remove(const size_t handle)
+{
+  const size_t index = this->indices[handle];
+  const size_t last  = this->owners.size() - 1;
+
+  this->owners[index]     = this->owners[last];
+  this->handles[index]    = this->handles[last];
+  this->dirtyFlags[index] = this->dirtyFlags[last];
+  this->centerXs[index]   = this->centerXs[last];
+  this->centerYs[index]   = this->centerYs[last];
+  this->centerZs[index]   = this->centerZs[last];
+  this->radii[index]      = this->radii[last];
+  this->minXs[index]      = this->minXs[last];
+  this->minYs[index]      = this->minYs[last];
+  this->minZs[index]      = this->minZs[last];
+  this->maxXs[index]      = this->maxXs[last];
+  this->maxYs[index]      = this->maxYs[last];
+  this->maxZs[index]      = this->maxZs[last];
+  this->indices[this->handles[index]] = index;
+
+  this->owners.pop_back();
+  this->handles.pop_back();
+  this->dirtyFlags.pop_back();
+  this->centerXs.pop_back();
+  this->centerYs.pop_back();
+  this->centerZs.pop_back();
+  this->radii.pop_back();
+  this->minXs.pop_back();
+  this->minYs.pop_back();
+  this->minZs.pop_back();
+  this->maxXs.pop_back();
+  this->maxYs.pop_back();
+  this->maxZs.pop_back();
+
+  // Queued handles of removed entries are skipped by flush()
+  this->indices[handle] = static_cast<size_t>(-1);
+  this->freeHandles.push_back(handle);
+}
 
-  this->VAO->Unbind();
-  this->VBO->Unbind();
-  this->EBO->Unbind();
+void kdr::Solids::BoundsTable::markDirty(const size_t handle)
+{
+  const size_t index = this->indices[handle];
+  if (this->dirtyFlags[index])
+  {
+    return;
+  }
+  this->dirtyFlags[index] = 1;
+  this->dirtyHandles.push_back(handle);
 }
 
+void kdr::Solids::BoundsTable::flush()
+{
+  for (const size_t handle : this->dirtyHandles)
+  {
+    const size_t index = this->indices[handle];
+    if (index == static_cast<size_t>(-1) || !this->dirtyFlags[index])
+    {
+      continue;
+    }
+    this->dirtyFlags[index] = 0;
+
+    const kdr::Solids::Solid* owner = this->owners[index];
+    const kdr::Bounds::Box box = owner->getWorldBox();
+    const kdr::Bounds::Sphere sphere = owner->getWorldSphere();
+    this->centerXs[index] = sphere.center.x;
+    this->centerYs[index] = sphere.center.y;
+    this->centerZs[index] = sphere.center.z;
+    this->radii[index]    = sphere.radius;
+    this->minXs[index]    = box.min.x;
+    this->minYs[index]    = box.min.y;
+    this->minZs[index]    = box.min.z;
+    this->maxXs[index]    = box.max.x;
+    this->maxYs[index]    = box.max.y;
+    this->maxZs[index]    = box.max.z;
+  }
+  this->dirtyHandles.clear();
+}
+
+kdr::Solids::BoundsTable& kdr::Solids::getBoundsTable()
+{
+  static kdr::Solids::BoundsTable boundsTable;
+  return boundsTable;
+}
+
+size_t kdr::Solids::MeshRegistry::acquire(const std::string& key, GLfloat vertices[], GLsizeiptr verticesSize, GLuint indices[], GLsizeiptr indicesSize, const GLenum mode, const bool primitiveRestart)
+{
+  const std::unordered_map<std::string, size_t>::const_iterator it = this->handles.find(key);
+  if (it != this->handles.end())
+  {
+    this->referenceCounts[it->second]++;
+    return it->second;
+  }
+
+  size_t handle = this->meshes.size();
+  if (!this->freeHandles.empty())
+  {
+    handle = this->freeHandles.back();
+    this->freeHandles.pop_back();
+  }
+  else
+  {
+    this->meshes.emplace_back();
+    this->referenceCounts.push_back(0);
+    this->keys.emplace_back();
+    this->vertexData.emplace_back();
+    this->indexData.emplace_back();
+  }
+
+  this->_upload(this->meshes[handle], vertices, verticesSize, indices, indicesSize, mode, primitiveRestart);
+  this->vertexData[handle].assign(vertices, vertices + verticesSize / sizeof(GLfloat));
+  this->indexData[handle].assign(indices, indices + indicesSize / sizeof(GLuint));
+  this->isPoolDirty = true;
+
+  this->referenceCounts[handle] = 1;
+  this->keys[handle] = key;
+  this->handles[key] = handle;
+  return handle;
+}
+
+void kdr::Solids::MeshRegistry::release(const size_t handle)
+{
+  if (--this->referenceCounts[handle] > 0)
+  {
+    return;
+  }
+
+  kdr::Solids::MeshRegistry::_destroy(this->meshes[handle]);
+  this->vertexData[handle].clear();
+  this->indexData[handle].clear();
+  this->isPoolDirty = true;
+
+  this->handles.erase(this->keys[handle]);
+  this->keys[handle].clear();
+  this->freeHandles.push_back(handle);
+}
+
+const kdr::Solids::Mesh& kdr::Solids::MeshRegistry::getPool()
+{
+  if (!this->isPoolDirty)
+  {
+    return this->pool;
+  }
+
+  std::vector<GLfloat> vertices;
+  std::vector<GLuint> indices;
+  for (size_t handle = 0; handle < this->meshes.size(); handle++)
+  {
+    if (this->referenceCounts[handle] == 0)
+    {
+      continue;
+    }
+    kdr::Solids::Mesh& mesh = this->meshes[handle];
+    if (!mesh.isPooled())
+    {
+      continue;
+    }
+    mesh.firstIndex = static_cast<GLuint>(indices.size());
+    mesh.baseVertex = static_cast<GLint>(vertices.size() / kdr::Graphics::VERTEX_FLOAT_COUNT);
+    vertices.insert(vertices.end(), this->vertexData[handle].begin(), this->vertexData[handle].end());
+    indices.insert(indices.end(), this->indexData[handle].begin(), this->indexData[handle].end());
+  }
+
+  kdr::Solids::MeshRegistry::_destroy(this->pool);
+  this->_upload(this->pool, vertices.data(), vertices.size() * sizeof(GLfloat), indices.data(), indices.size() * sizeof(GLuint), GL_TRIANGLES, false);
+  this->isPoolDirty = false;
+  return this->pool;
+}
+
+void kdr::Solids::MeshRegistry::setVertexFormat(const kdr::Graphics::VertexFormat& vertexFormat)
+{
+  this->vertexFormat = vertexFormat;
+  for (size_t handle = 0; handle < this->meshes.size(); handle++)
+  {
+    if (this->referenceCounts[handle] == 0)
+    {
+      continue;
+    }
+    const GLenum mode = this->meshes[handle].mode;
+    const bool primitiveRestart = this->meshes[handle].hasPrimitiveRestart;
+    kdr::Solids::MeshRegistry::_destroy(this->meshes[handle]);
+    this->_upload(
+      this->meshes[handle],
+      this->vertexData[handle].data(),
+      this->vertexData[handle].size() * sizeof(GLfloat),
+      this->indexData[handle].data(),
+      this->indexData[handle].size() * sizeof(GLuint),
+      mode,
+      primitiveRestart
+    );
+  }
+  this->isPoolDirty = true;
+}
+
+void kdr::Solids::MeshRegistry::_upload(kdr::Solids::Mesh& mesh, const GLfloat* vertices, GLsizeiptr verticesSize, const GLuint* indices, GLsizeiptr indicesSize, const GLenum mode, const bool primitiveRestart) const
+{
+  const size_t vertexCount = verticesSize / (kdr::Graphics::VERTEX_FLOAT_COUNT * sizeof(GLfloat));
+  const std::vector<GLubyte> packedVertices = kdr::Graphics::packVertices(vertices, vertexCount, this->vertexFormat);
+
+  // The VAO is bound first, since creating the EBO would otherwise change the element
+  // buffer of whichever VAO the last render() call left bound
+  mesh.VAO = new kdr::Graphics::VAO();
+  mesh.VAO->Bind();
+  mesh.VBO = new kdr::Graphics::VBO(packedVertices.data(), packedVertices.size());
+  mesh.EBO = new kdr::Graphics::EBO(indices, indicesSize, primitiveRestart);
+  mesh.indexCount = mesh.EBO->getCount();
+  mesh.indexType = mesh.EBO->getType();
+  mesh.mode = mode;
+  mesh.hasPrimitiveRestart = primitiveRestart;
+
+  mesh.VBO->Bind();
+  mesh.EBO->Bind();
+  mesh.VAO->LinkLayout(*mesh.VBO, kdr::Graphics::getVertexLayout(this->vertexFormat));
+
+  mesh.VAO->Unbind();
+  mesh.VBO->Unbind();
+  mesh.EBO->Unbind();
+}
+
+void kdr::Solids::MeshRegistry::_destroy(kdr::Solids::Mesh& mesh)
+{
+  delete mesh.VAO;
+  delete mesh.VBO;
+  delete mesh.EBO;
+  mesh = kdr::Solids::Mesh();
+}
+
+kdr::Solids::MeshRegistry& kdr::Solids::getMeshRegistry()
+{
+  static kdr::Solids::MeshRegistry meshRegistry;
+  return meshRegistry;
+}
+
+void kdr::Solids::Solid::initializeMesh(const std::string& key, GLfloat vertices[], GLsizeiptr verticesSize, GLuint indices[], GLsizeiptr indicesSize, const kdr::Space::Vec3& dimensions)
+{
+  this->meshHandle = kdr::Solids::getMeshRegistry().acquire(key, vertices, verticesSize, indices, indicesSize);
+  this->hasMesh = true;
+  this->dimensions = dimensions;
+  this->isModelDirty = true;
+  kdr::Solids::getBoundsTable().markDirty(this->boundsHandle);
+}
+
+GLfloat unitCuboidVertices[] = {
+  -0.5f, -0.5f,  0.5f, 1.f, 1.f, 1.f, 0.f, 0.f, // 0  000 Front
+  -0.5f, -0.5f,  0.5f, 1.f, 1.f, 1.f, 1.f, 0.f, // 1  000 Left
+  -0.5f, -0.5f,  0.5f, 1.f, 1.f, 1.f, 1.f, 1.f, // 2  000 Bottom
+   0.5f, -0.5f,  0.5f, 1.f, 1.f, 1.f, 1.f, 0.f, // 3  100 Front
+   0.5f, -0.5f,  0.5f, 1.f, 1.f, 1.f, 0.f, 0.f, // 4  100 Right
+   0.5f, -0.5f,  0.5f, 1.f, 1.f, 1.f, 0.f, 1.f, // 5  100 Bottom
+  -0.5f,  0.5f,  0.5f, 1.f, 1.f, 1.f, 0.f, 1.f, // 6  010 Front
+  -0.5f,  0.5f,  0.5f, 1.f, 1.f, 1.f, 1.f, 1.f, // 7  010 Left
+  -0.5f,  0.5f,  0.5f, 1.f, 1.f, 1.f, 0.f, 0.f, // 8  010 Top
+   0.5f,  0.5f,  0.5f, 1.f, 1.f, 1.f, 1.f, 1.f, // 9  110 Front
+   0.5f,  0.5f,  0.5f, 1.f, 1.f, 1.f, 0.f, 1.f, // 10 110 Right
+   0.5f,  0.5f,  0.5f, 1.f, 1.f, 1.f, 0.f, 1.f, // 11 110 Top
+  -0.5f, -0.5f, -0.5f, 1.f, 1.f, 1.f, 0.f, 0.f, // 12 001 Left
+  -0.5f, -0.5f, -0.5f, 1.f, 1.f, 1.f, 1.f, 0.f, // 13 001 Back
+  -0.5f, -0.5f, -0.5f, 1.f, 1.f, 1.f, 1.f, 0.f, // 14 001 Bottom
+   0.5f, -0.5f, -0.5f, 1.f, 1.f, 1.f, 1.f, 0.f, // 15 101 Right
+   0.5f, -0.5f, -0.5f, 1.f, 1.f, 1.f, 0.f, 0.f, // 16 101 Back
+   0.5f, -0.5f, -0.5f, 1.f, 1.f, 1.f, 0.f, 0.f, // 17 101 Bottom
+  -0.5f,  0.5f, -0.5f, 1.f, 1.f, 1.f, 0.f, 1.f, // 18 011 Left
+  -0.5f,  0.5f, -0.5f, 1.f, 1.f, 1.f, 1.f, 1.f, // 19 011 Back
+  -0.5f,  0.5f, -0.5f, 1.f, 1.f, 1.f, 0.f, 1.f, // 20 011 Top
+   0.5f,  0.5f, -0.5f, 1.f, 1.f, 1.f, 0.f, 1.f, // 21 111 Back
+   0.5f,  0.5f, -0.5f, 1.f, 1.f, 1.f, 1.f, 1.f, // 22 111 Right
+   0.5f,  0.5f, -0.5f, 1.f, 1.f, 1.f, 1.f, 1.f, // 23 111 Top
+};
 GLuint cuboidIndices[] = {
   0, 3, 9,    // Front
   0, 9, 6,    // Front
@@ -36,80 +316,45 @@ GLuint cuboidIndices[] = {
 
 kdr::Solids::Cube::Cube(const kdr::Space::Vec3& position, const float edgeLength) : kdr::Solids::Solid(position)
 {
-  GLfloat cubeVertices[] = {
-    -(edgeLength / 2.f), -(edgeLength / 2.f),  (edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f, 0.f, // 0  000 Front
-    -(edgeLength / 2.f), -(edgeLength / 2.f),  (edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f, 0.f, // 1  000 Left
-    -(edgeLength / 2.f), -(edgeLength / 2.f),  (edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f, 1.f, // 2  000 Bottom
-     (edgeLength / 2.f), -(edgeLength / 2.f),  (edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f, 0.f, // 3  100 Front
-     (edgeLength / 2.f), -(edgeLength / 2.f),  (edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f, 0.f, // 4  100 Right
-     (edgeLength / 2.f), -(edgeLength / 2.f),  (edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f, 1.f, // 5  100 Bottom
-    -(edgeLength / 2.f),  (edgeLength / 2.f),  (edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f, 1.f, // 6  010 Front
-    -(edgeLength / 2.f),  (edgeLength / 2.f),  (edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f, 1.f, // 7  010 Left
-    -(edgeLength / 2.f),  (edgeLength / 2.f),  (edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f, 0.f, // 8  010 Top
-     (edgeLength / 2.f),  (edgeLength / 2.f),  (edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f, 1.f, // 9  110 Front
-     (edgeLength / 2.f),  (edgeLength / 2.f),  (edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f, 1.f, // 10 110 Right
-     (edgeLength / 2.f),  (edgeLength / 2.f),  (edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f, 1.f, // 11 110 Top
-    -(edgeLength / 2.f), -(edgeLength / 2.f), -(edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f, 0.f, // 12 001 Left
-    -(edgeLength / 2.f), -(edgeLength / 2.f), -(edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f, 0.f, // 13 001 Back
-    -(edgeLength / 2.f), -(edgeLength / 2.f), -(edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f, 0.f, // 14 001 Bottom
-     (edgeLength / 2.f), -(edgeLength / 2.f), -(edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f, 0.f, // 15 101 Right
-     (edgeLength / 2.f), -(edgeLength / 2.f), -(edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f, 0.f, // 16 101 Back
-     (edgeLength / 2.f), -(edgeLength / 2.f), -(edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f, 0.f, // 17 101 Bottom
-    -(edgeLength / 2.f),  (edgeLength / 2.f), -(edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f, 1.f, // 18 011 Left
-    -(edgeLength / 2.f),  (edgeLength / 2.f), -(edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f, 1.f, // 19 011 Back
-    -(edgeLength / 2.f),  (edgeLength / 2.f), -(edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f, 1.f, // 20 011 Top
-     (edgeLength / 2.f),  (edgeLength / 2.f), -(edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f, 1.f, // 21 111 Back
-     (edgeLength / 2.f),  (edgeLength / 2.f), -(edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f, 1.f, // 22 111 Right
-     (edgeLength / 2.f),  (edgeLength / 2.f), -(edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f, 1.f, // 23 111 Top
-  };
-  this->initializeMembers(cubeVertices, sizeof(cubeVertices), cuboidIndices, sizeof(cuboidIndices));
+  this->initializeMesh("Cuboid", unitCuboidVertices, sizeof(unitCuboidVertices), cuboidIndices, sizeof(cuboidIndices), {edgeLength, edgeLength, edgeLength});
+  this->setLocalBounds(
+    kdr::Bounds::Box(-edgeLength / 2.f, edgeLength / 2.f),
+    kdr::Bounds::Sphere(0.f, kdr::Space::sqrt(3.f) * edgeLength / 2.f)
+  );
 }
 
 void kdr::Solids::Cube::render()
 {
-  this->VAO->Bind();
-  glDrawElements(GL_TRIANGLES, sizeof(cuboidIndices) / sizeof(GLuint), GL_UNSIGNED_INT, NULL);
-  this->VAO->Unbind();
+  this->renderMesh();
 }
 
 kdr::Solids::Cuboid::Cuboid(const kdr::Space::Vec3& position, const float length, const float height, const float width) : kdr::Solids::Solid(position)
 {
-  GLfloat cuboidVertices[] = {
-    -(length / 2.f), -(height / 2.f),  (width / 2.f), 1.f, 1.f, 1.f, 0.f, 0.f, // 0  000 Front
-    -(length / 2.f), -(height / 2.f),  (width / 2.f), 1.f, 1.f, 1.f, 1.f, 0.f, // 1  000 Left
-    -(length / 2.f), -(height / 2.f),  (width / 2.f), 1.f, 1.f, 1.f, 1.f, 1.f, // 2  000 Bottom
-     (length / 2.f), -(height / 2.f),  (width / 2.f), 1.f, 1.f, 1.f, 1.f, 0.f, // 3  100 Front
-     (length / 2.f), -(height / 2.f),  (width / 2.f), 1.f, 1.f, 1.f, 0.f, 0.f, // 4  100 Right
-     (length / 2.f), -(height / 2.f),  (width / 2.f), 1.f, 1.f, 1.f, 0.f, 1.f, // 5  100 Bottom
-    -(length / 2.f),  (height / 2.f),  (width / 2.f), 1.f, 1.f, 1.f, 0.f, 1.f, // 6  010 Front
-    -(length / 2.f),  (height / 2.f),  (width / 2.f), 1.f, 1.f, 1.f, 1.f, 1.f, // 7  010 Left
-    -(length / 2.f),  (height / 2.f),  (width / 2.f), 1.f, 1.f, 1.f, 0.f, 0.f, // 8  010 Top
-     (length / 2.f),  (height / 2.f),  (width / 2.f), 1.f, 1.f, 1.f, 1.f, 1.f, // 9  110 Front
-     (length / 2.f),  (height / 2.f),  (width / 2.f), 1.f, 1.f, 1.f, 0.f, 1.f, // 10 110 Right
-     (length / 2.f),  (height / 2.f),  (width / 2.f), 1.f, 1.f, 1.f, 0.f, 1.f, // 11 110 Top
-    -(length / 2.f), -(height / 2.f), -(width / 2.f), 1.f, 1.f, 1.f, 0.f, 0.f, // 12 001 Left
-    -(length / 2.f), -(height / 2.f), -(width / 2.f), 1.f, 1.f, 1.f, 1.f, 0.f, // 13 001 Back
-    -(length / 2.f), -(height / 2.f), -(width / 2.f), 1.f, 1.f, 1.f, 1.f, 0.f, // 14 001 Bottom
-     (length / 2.f), -(height / 2.f), -(width / 2.f), 1.f, 1.f, 1.f, 1.f, 0.f, // 15 101 Right
-     (length / 2.f), -(height / 2.f), -(width / 2.f), 1.f, 1.f, 1.f, 0.f, 0.f, // 16 101 Back
-     (length / 2.f), -(height / 2.f), -(width / 2.f), 1.f, 1.f, 1.f, 0.f, 0.f, // 17 101 Bottom
-    -(length / 2.f),  (height / 2.f), -(width / 2.f), 1.f, 1.f, 1.f, 0.f, 1.f, // 18 011 Left
-    -(length / 2.f),  (height / 2.f), -(width / 2.f), 1.f, 1.f, 1.f, 1.f, 1.f, // 19 011 Back
-    -(length / 2.f),  (height / 2.f), -(width / 2.f), 1.f, 1.f, 1.f, 0.f, 1.f, // 20 011 Top
-     (length / 2.f),  (height / 2.f), -(width / 2.f), 1.f, 1.f, 1.f, 0.f, 1.f, // 21 111 Back
-     (length / 2.f),  (height / 2.f), -(width / 2.f), 1.f, 1.f, 1.f, 1.f, 1.f, // 22 111 Right
-     (length / 2.f),  (height / 2.f), -(width / 2.f), 1.f, 1.f, 1.f, 1.f, 1.f, // 23 111 Top
-  };
-  this->initializeMembers(cuboidVertices, sizeof(cuboidVertices), cuboidIndices, sizeof(cuboidIndices));
+  this->initializeMesh("Cuboid", unitCuboidVertices, sizeof(unitCuboidVertices), cuboidIndices, sizeof(cuboidIndices), {length, height, width});
+  const kdr::Bounds::Box box({-length / 2.f, -height / 2.f, -width / 2.f}, {length / 2.f, height / 2.f, width / 2.f});
+  this->setLocalBounds(box, kdr::Bounds::enclose(box));
 }
 
 void kdr::Solids::Cuboid::render()
 {
-  this->VAO->Bind();
-  glDrawElements(GL_TRIANGLES, sizeof(cuboidIndices) / sizeof(GLuint), GL_UNSIGNED_INT, NULL);
-  this->VAO->Unbind();
+  this->renderMesh();
 }
 
+GLfloat unitPyramidVertices[] = {
+  -0.5f, -0.5f,  0.5f, 1.f, 1.f, 1.f, 1.f,  1.f,  // 0  00 Bottom
+  -0.5f, -0.5f,  0.5f, 1.f, 1.f, 1.f, 0.f,  0.f,  // 1  00 Front
+  -0.5f, -0.5f,  0.5f, 1.f, 1.f, 1.f, 1.f,  0.f,  // 2  00 Left
+   0.5f, -0.5f,  0.5f, 1.f, 1.f, 1.f, 0.f,  1.f,  // 3  10 Bottom
+   0.5f, -0.5f,  0.5f, 1.f, 1.f, 1.f, 1.f,  0.f,  // 4  10 Front
+   0.5f, -0.5f,  0.5f, 1.f, 1.f, 1.f, 0.f,  0.f,  // 5  10 Right
+  -0.5f, -0.5f, -0.5f, 1.f, 1.f, 1.f, 1.f,  0.f,  // 6  01 Bottom
+  -0.5f, -0.5f, -0.5f, 1.f, 1.f, 1.f, 1.f,  0.f,  // 7  01 Back
+  -0.5f, -0.5f, -0.5f, 1.f, 1.f, 1.f, 0.f,  0.f,  // 8  01 Left
+   0.5f, -0.5f, -0.5f, 1.f, 1.f, 1.f, 0.f,  0.f,  // 9  11 Bottom
+   0.5f, -0.5f, -0.5f, 1.f, 1.f, 1.f, 0.f,  0.f,  // 10 11 Back
+   0.5f, -0.5f, -0.5f, 1.f, 1.f, 1.f, 1.f,  0.f,  // 11 11 Right
+   0.f,   0.5f,  0.f,  1.f, 1.f, 1.f, 0.5f, 0.5f, // 12    Top
+};
 GLuint pyramidIndices[] = {
   6, 9, 3,   // Bottom
   6, 3, 0,   // Bottom
@@ -121,31 +366,24 @@ GLuint pyramidIndices[] = {
 
 kdr::Solids::Pyramid::Pyramid(const kdr::Space::Vec3& position, const float edgeLength, const float height) : kdr::Solids::Solid(position)
 {
-  GLfloat pyramidVertices[] = {
-    -(edgeLength / 2.f), -(height / 2.f),  (edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f,  1.f,  // 0  00 Bottom
-    -(edgeLength / 2.f), -(height / 2.f),  (edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f,  0.f,  // 1  00 Front
-    -(edgeLength / 2.f), -(height / 2.f),  (edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f,  0.f,  // 2  00 Left
-     (edgeLength / 2.f), -(height / 2.f),  (edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f,  1.f,  // 3  10 Bottom
-     (edgeLength / 2.f), -(height / 2.f),  (edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f,  0.f,  // 4  10 Front
-     (edgeLength / 2.f), -(height / 2.f),  (edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f,  0.f,  // 5  10 Right
-    -(edgeLength / 2.f), -(height / 2.f), -(edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f,  0.f,  // 6  01 Bottom
-    -(edgeLength / 2.f), -(height / 2.f), -(edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f,  0.f,  // 7  01 Back
-    -(edgeLength / 2.f), -(height / 2.f), -(edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f,  0.f,  // 8  01 Left
-     (edgeLength / 2.f), -(height / 2.f), -(edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f,  0.f,  // 9  11 Bottom
-     (edgeLength / 2.f), -(height / 2.f), -(edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f,  0.f,  // 10 11 Back
-     (edgeLength / 2.f), -(height / 2.f), -(edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f,  0.f,  // 11 11 Right
-     0.f,                 (height / 2.f),  0.f,                1.f, 1.f, 1.f, 0.5f, 0.5f, // 12    Top
-  };
-  this->initializeMembers(pyramidVertices, sizeof(pyramidVertices), pyramidIndices, sizeof(pyramidIndices));
+  this->initializeMesh("Pyramid", unitPyramidVertices, sizeof(unitPyramidVertices), pyramidIndices, sizeof(pyramidIndices), {edgeLength, height, edgeLength});
+  this->setLocalBounds(
+    kdr::Bounds::Box({-edgeLength / 2.f, -height / 2.f, -edgeLength / 2.f}, {edgeLength / 2.f, height / 2.f, edgeLength / 2.f}),
+    kdr::Bounds::Sphere(0.f, kdr::Space::sqrt(edgeLength * edgeLength / 2.f + height * height / 4.f))
+  );
 }
 
 void kdr::Solids::Pyramid::render()
 {
-  this->VAO->Bind();
-  glDrawElements(GL_TRIANGLES, sizeof(pyramidIndices) / sizeof(GLuint), GL_UNSIGNED_INT, NULL);
-  this->VAO->Unbind();
+  this->renderMesh();
 }
 
+GLfloat unitPlaneVertices[] = {
+  -0.5f, 0.f,  0.5f, 1.f, 1.f, 1.f, 0.f, 0.f, // 0 00
+   0.5f, 0.f,  0.5f, 1.f, 1.f, 1.f, 1.f, 0.f, // 1 10
+  -0.5f, 0.f, -0.5f, 1.f, 1.f, 1.f, 0.f, 1.f, // 2 01
+   0.5f, 0.f, -0.5f, 1.f, 1.f, 1.f, 1.f, 1.f, // 3 11
+};
 GLuint planeIndices[] = {
   0, 1, 3, // Top
   0, 3, 2, // Top
@@ -153,22 +391,36 @@ GLuint planeIndices[] = {
 
 kdr::Solids::Plane::Plane(const kdr::Space::Vec3& position, const float length, const float width) : kdr::Solids::Solid(position)
 {
-  GLfloat planeVertices[] = {
-    -(length / 2.f), 0.f,  (width / 2.f), 1.f, 1.f, 1.f, 0.f, 0.f, // 0 00
-     (length / 2.f), 0.f,  (width / 2.f), 1.f, 1.f, 1.f, 1.f, 0.f, // 1 10
-    -(length / 2.f), 0.f, -(width / 2.f), 1.f, 1.f, 1.f, 0.f, 1.f, // 2 01
-     (length / 2.f), 0.f, -(width / 2.f), 1.f, 1.f, 1.f, 1.f, 1.f, // 3 11
-  };
-  this->initializeMembers(planeVertices, sizeof(planeVertices), planeIndices, sizeof(planeIndices));
+  this->initializeMesh("Plane", unitPlaneVertices, sizeof(unitPlaneVertices), planeIndices, sizeof(planeIndices), {length, 1.f, width});
+  const kdr::Bounds::Box box({-length / 2.f, 0.f, -width / 2.f}, {length / 2.f, 0.f, width / 2.f});
+  this->setLocalBounds(box, kdr::Bounds::enclose(box));
 }
 
 void kdr::Solids::Plane::render()
 {
-  this->VAO->Bind();
-  glDrawElements(GL_TRIANGLES, sizeof(planeIndices) / sizeof(GLuint), GL_UNSIGNED_INT, NULL);
-  this->VAO->Unbind();
+  this->renderMesh();
 }
 
+GLfloat unitOctahedronVertices[] = {
+  -0.5f,  0.f,   0.5f, 1.f, 1.f, 1.f, 0.f,  0.f, // 0  00 Front T
+  -0.5f,  0.f,   0.5f, 1.f, 1.f, 1.f, 1.f,  0.f, // 1  00 Front B
+  -0.5f,  0.f,   0.5f, 1.f, 1.f, 1.f, 1.f,  0.f, // 2  00 Left  T
+  -0.5f,  0.f,   0.5f, 1.f, 1.f, 1.f, 0.f,  0.f, // 3  00 Left  B
+   0.5f,  0.f,   0.5f, 1.f, 1.f, 1.f, 1.f,  0.f, // 4  10 Front T
+   0.5f,  0.f,   0.5f, 1.f, 1.f, 1.f, 0.f,  0.f, // 5  10 Front B
+   0.5f,  0.f,   0.5f, 1.f, 1.f, 1.f, 0.f,  0.f, // 6  10 Right T
+   0.5f,  0.f,   0.5f, 1.f, 1.f, 1.f, 1.f,  0.f, // 7  10 Right B
+  -0.5f,  0.f,  -0.5f, 1.f, 1.f, 1.f, 1.f,  0.f, // 8  01 Back  T
+  -0.5f,  0.f,  -0.5f, 1.f, 1.f, 1.f, 0.f,  0.f, // 9  01 Back  B
+  -0.5f,  0.f,  -0.5f, 1.f, 1.f, 1.f, 0.f,  0.f, // 10 01 Left  T
+  -0.5f,  0.f,  -0.5f, 1.f, 1.f, 1.f, 1.f,  0.f, // 11 01 Left  B
+   0.5f,  0.f,  -0.5f, 1.f, 1.f, 1.f, 1.f,  0.f, // 12 11 Right T
+   0.5f,  0.f,  -0.5f, 1.f, 1.f, 1.f, 0.f,  0.f, // 13 11 Right B
+   0.5f,  0.f,  -0.5f, 1.f, 1.f, 1.f, 0.f,  0.f, // 14 11 Back  T
+   0.5f,  0.f,  -0.5f, 1.f, 1.f, 1.f, 1.f,  0.f, // 15 11 Back  B
+   0.f,   0.5f,  0.f,  1.f, 1.f, 1.f, 0.5f, 1.f, // 16 Top
+   0.f,  -0.5f,  0.f,  1.f, 1.f, 1.f, 0.5f, 1.f, // 17 Top
+};
 GLuint octahedronIndices[] = {
   0, 4, 16,  // Front T
   6, 12, 16, // Right T
@@ -182,32 +434,16 @@ GLuint octahedronIndices[] = {
 
 kdr::Solids::Octahedron::Octahedron(const kdr::Space::Vec3& position, const float edgeLength, const float height) : kdr::Solids::Solid(position)
 {
-  GLfloat octahedronVertices[] = {
-    -(edgeLength / 2.f),  0.f,             (edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f,  0.f, // 0  00 Front T
-    -(edgeLength / 2.f),  0.f,             (edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f,  0.f, // 1  00 Front B
-    -(edgeLength / 2.f),  0.f,             (edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f,  0.f, // 2  00 Left  T
-    -(edgeLength / 2.f),  0.f,             (edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f,  0.f, // 3  00 Left  B
-     (edgeLength / 2.f),  0.f,             (edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f,  0.f, // 4  10 Front T
-     (edgeLength / 2.f),  0.f,             (edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f,  0.f, // 5  10 Front B
-     (edgeLength / 2.f),  0.f,             (edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f,  0.f, // 6  10 Right T
-     (edgeLength / 2.f),  0.f,             (edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f,  0.f, // 7  10 Right B
-    -(edgeLength / 2.f),  0.f,            -(edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f,  0.f, // 8  01 Back  T
-    -(edgeLength / 2.f),  0.f,            -(edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f,  0.f, // 9  01 Back  B
-    -(edgeLength / 2.f),  0.f,            -(edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f,  0.f, // 10 01 Left  T
-    -(edgeLength / 2.f),  0.f,            -(edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f,  0.f, // 11 01 Left  B
-     (edgeLength / 2.f),  0.f,            -(edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f,  0.f, // 12 11 Right T
-     (edgeLength / 2.f),  0.f,            -(edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f,  0.f, // 13 11 Right B
-     (edgeLength / 2.f),  0.f,            -(edgeLength / 2.f), 1.f, 1.f, 1.f, 0.f,  0.f, // 14 11 Back  T
-     (edgeLength / 2.f),  0.f,            -(edgeLength / 2.f), 1.f, 1.f, 1.f, 1.f,  0.f, // 15 11 Back  B
-     0.f,                 (height / 2.f),  0.f,                1.f, 1.f, 1.f, 0.5f, 1.f, // 16 Top
-     0.f,                -(height / 2.f),  0.f,                1.f, 1.f, 1.f, 0.5f, 1.f, // 17 Top
-  };
-  this->initializeMembers(octahedronVertices, sizeof(octahedronVertices), octahedronIndices, sizeof(octahedronIndices));
+  this->initializeMesh("Octahedron", unitOctahedronVertices, sizeof(unitOctahedronVertices), octahedronIndices, sizeof(octahedronIndices), {edgeLength, height, edgeLength});
+  // The square corners lie at half the diagonal, the tips at half the height
+  const float cornerRadius = edgeLength / kdr::Space::sqrt(2.f);
+  this->setLocalBounds(
+    kdr::Bounds::Box({-edgeLength / 2.f, -height / 2.f, -edgeLength / 2.f}, {edgeLength / 2.f, height / 2.f, edgeLength / 2.f}),
+    kdr::Bounds::Sphere(0.f, cornerRadius > height / 2.f ? cornerRadius : height / 2.f)
+  );
 }
 
 void kdr::Solids::Octahedron::render()
 {
-  this->VAO->Bind();
-  glDrawElements(GL_TRIANGLES, sizeof(octahedronIndices) / sizeof(GLuint), GL_UNSIGNED_INT, NULL);
-  this->VAO->Unbind();
+  this->renderMesh();
 }
@@ -1,70 +1,359 @@
 #include "Kedarium/Space.hpp"
 
-kdr::Space::Mat4 kdr::Space::translate(const kdr::Space::Mat4& mat, const kdr::Space::Vec3& vec)
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Checks whether two floats agree to within a relative tolerance of 2.5e-7 (about 2 ulps).
+ *
+ * Used by the compile-time checks below to compare constant-evaluated results, which go through
+ * the Taylor series trigonometry, with the values the runtime (libm) path produces.
+ *
+ * @param a The first value.
+ * @param b The second value.
+ * @return True if the values are close, false otherwise.
+ */
+static constexpr bool isClose(const float a, const float b)
 {
-  kdr::Space::Mat4 result {mat};
-  result[3][0] += vec.x;
-  result[3][1] += vec.y;
-  result[3][2] += vec.z;  
-  return result;
+  const float difference = a > b ? a - b : b - a;
+  const float magnitude = a > 0.f ? a : -a;
+  return difference <= magnitude * 2.5e-7f;
 }
 
-kdr::Space::Mat4 kdr::Space::rotate(const kdr::Space::Mat4& mat, const kdr::Space::Vec3& vec, const float angle)
+// Compile-time checks: every expected value below is what the runtime path returns.
+static_assert(kdr::Space::radians(180.f) == kdr::Space::PI);
+static_assert(kdr::Space::sqrt(2.f) == 0x1.6a09e6p+0f);
+static_assert(kdr::Space::sin(kdr::Space::radians(30.f)) == 0x1p-1f);
+static_assert(isClose(kdr::Space::tan(kdr::Space::radians(60.f)), 0x1.bb67bp+0f));
+static_assert(kdr::Space::dot(kdr::Space::Vec3{1.f, 2.f, 3.f}, kdr::Space::Vec3{4.f, 5.f, 6.f}) == 32.f);
+static_assert(kdr::Space::cross(kdr::Space::Vec3{1.f, 0.f, 0.f}, kdr::Space::Vec3{0.f, 1.f, 0.f}).z == 1.f);
+static_assert(kdr::Space::normalize(kdr::Space::Vec3{3.f, 0.f, 4.f}).x == 0.6f);
+static_assert(kdr::Space::translate(kdr::Space::Mat4{1.f}, {1.f, 2.f, 3.f})[3][1] == 2.f);
+static_assert((kdr::Space::Mat4{2.f} * kdr::Space::Mat4{3.f})[2][2] == 6.f);
+static_assert((kdr::Space::translate(kdr::Space::Mat4{1.f}, {1.f, 2.f, 3.f}) * kdr::Space::Vec4{1.f}).z == 4.f);
+static_assert(kdr::Space::rotate(kdr::Space::Mat4{1.f}, {1.f, 0.f, 0.f}, 90.f)[1][2] == -1.f);
+static_assert(kdr::Space::rotate(kdr::Space::Mat4{1.f}, {1.f, 0.f, 0.f}, 90.f)[2][1] == 1.f);
+static_assert(kdr::Space::lookAt({0.f, 0.f, 5.f}, {0.f, 0.f, 4.f}, {0.f, 1.f, 0.f})[3][2] == -5.f);
+static_assert(isClose(kdr::Space::perspective(60.f, 800.f / 600.f, 0.1f, 100.f)[0][0], 0x1.bb67acp-1f));
+static_assert(isClose(kdr::Space::perspective(60.f, 800.f / 600.f, 0.1f, 100.f)[1][1], 0x1.279a74p+0f));
+static_assert(kdr::Space::perspective(60.f, 800.f / 600.f, 0.1f, 100.f)[2][2] == -0x1.008334p+0f);
+static_assert(kdr::Space::perspective(60.f, 800.f / 600.f, 0.1f, 100.f)[3][2] == -0x1.9a029p-3f);
+
+// Layout checks: Vec4 and Mat4 are memcpy'd into GPU buffers and loaded with SSE, so their layout is part of the API.
+static_assert(sizeof(kdr::Space::Vec4) == 16 && alignof(kdr::Space::Vec4) == 16);
+static_assert(offsetof(kdr::Space::Vec4, x) == 0 && offsetof(kdr::Space::Vec4, w) == 12);
+static_assert(sizeof(kdr::Space::Mat4) == 64 && alignof(kdr::Space::Mat4) == 16);
+static_assert(sizeof(kdr::Space::Affine3x4) == 48 && alignof(kdr::Space::Affine3x4) == 16);
+static_assert(std::is_standard_layout_v<kdr::Space::Vec4> && std::is_trivially_copyable_v<kdr::Space::Vec4>);
+static_assert(std::is_standard_layout_v<kdr::Space::Mat4> && std::is_trivially_copyable_v<kdr::Space::Mat4>);
+static_assert(kdr::Space::translate(kdr::Space::Mat4{1.f}, {1.f, 2.f, 3.f}).getColumn(3).y == 2.f);
+static_assert(kdr::Space::translate(kdr::Space::Mat4{1.f}, {1.f, 2.f, 3.f}).getRow(1).w == 2.f);
+static_assert(kdr::Space::perspective(60.f, 800.f / 600.f, 0.1f, 100.f).getColumn(2).w == -1.f);
+
+/**
+ * @brief Checks the fast sincos polynomial against the exact series at compile time.
+ *
+ * @param radians The angle in radians.
+ * @return True if both the sine and the cosine are within kdr::Simd::SINCOS_MAX_ERROR.
+ */
+static constexpr bool isPolynomialSinCosClose(const float radians)
 {
-  kdr::Space::Vec3 normalizedVec = kdr::Space::normalize(vec);
-  kdr::Space::Mat4 viewMat {mat};
-
-  const float cosTheta = std::cos(kdr::Space::radians(angle));
-  const float sinTheta = std::sin(kdr::Space::radians(angle));
-  const float oneMinusCosTheta = 1 - cosTheta;
-
-  viewMat[0][0] = cosTheta + normalizedVec.x * normalizedVec.x * oneMinusCosTheta;
-  viewMat[0][1] = normalizedVec.x * normalizedVec.y * oneMinusCosTheta - normalizedVec.z * sinTheta;
-  viewMat[0][2] = normalizedVec.x * normalizedVec.z * oneMinusCosTheta + normalizedVec.y * sinTheta;
-  viewMat[1][0] = normalizedVec.y * normalizedVec.x * oneMinusCosTheta + normalizedVec.z * sinTheta;
-  viewMat[1][1] = cosTheta + normalizedVec.y * normalizedVec.y * oneMinusCosTheta;
-  viewMat[1][2] = normalizedVec.y * normalizedVec.z * oneMinusCosTheta - normalizedVec.x * sinTheta;
-  viewMat[2][0] = normalizedVec.z * normalizedVec.x * oneMinusCosTheta - normalizedVec.y * sinTheta;
-  viewMat[2][1] = normalizedVec.z * normalizedVec.y * oneMinusCosTheta + normalizedVec.x * sinTheta;
-  viewMat[2][2] = cosTheta + normalizedVec.z * normalizedVec.z * oneMinusCosTheta;
-
-  return viewMat * mat;
+  float sine {0.f};
+  float cosine {0.f};
+  kdr::Simd::sinCosPolynomial(radians, sine, cosine);
+  double exactSine {0.0};
+  double exactCosine {0.0};
+  kdr::Space::_sinCosTaylor(radians, exactSine, exactCosine);
+  const double sineError = sine > exactSine ? sine - exactSine : exactSine - sine;
+  const double cosineError = cosine > exactCosine ? cosine - exactCosine : exactCosine - cosine;
+  return sineError <= kdr::Simd::SINCOS_MAX_ERROR && cosineError <= kdr::Simd::SINCOS_MAX_ERROR;
 }
 
-kdr::Space::Mat4 kdr::Space::perspective(const float fov, const float aspect, const float zNear, const float zFar)
+static_assert(isPolynomialSinCosClose(0.f));
+static_assert(isPolynomialSinCosClose(0.7853982f));
+static_assert(isPolynomialSinCosClose(-2.5f));
+static_assert(isPolynomialSinCosClose(kdr::Space::radians(89.f)));
+static_assert(isPolynomialSinCosClose(kdr::Space::radians(-359.f)));
+static_assert(isPolynomialSinCosClose(1000.f));
+
+/**
+ * @brief The smallest number of items worth handing to a separate thread.
+ */
+constexpr size_t PARALLEL_MIN_CHUNK {4096};
+constexpr size_t SINCOS_BLOCK_SIZE  {256};
+
+/**
+ * @class WorkerPool
+ * @brief Keeps the threads of the batched operations alive between calls.
+ *
+ * Starting and joining threads for every batch costs more than most batches take, so the
+ * workers are started on first use and then sleep until the next batch. One batch runs at a
+ * time; a call that finds the pool busy (e.g., from another thread) runs on the calling thread.
+ */
+class WorkerPool
 {
-  kdr::Space::Mat4 result;
-  const float halfTanFOV = tanf(kdr::Space::radians(fov)) / 2.f;
+  public:
+    ~WorkerPool()
+    {
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->isStopping = true;
+      }
+      this->wakeCondition.notify_all();
+      for (std::thread& worker : this->workers)
+      {
+        worker.join();
+      }
+    }
+
+    /**
+     * @brief Runs the chunks of a range on the calling thread and up to helperCount workers.
+     *
+     * @param count The number of items.
+     * @param chunkSize The number of items per chunk.
+     * @param chunkCount The number of chunks.
+     * @param helperCount The number of workers helping the calling thread.
+     * @param function The callable invoked as function(begin, end) for every chunk.
+     */
+    template <typename Function>
+    void run(const size_t count, const size_t chunkSize, const size_t chunkCount, const size_t helperCount, const Function& function)
+    {
+      std::unique_lock<std::mutex> dispatchLock(this->dispatchMutex, std::try_to_lock);
+      if (!dispatchLock.owns_lock())
+      {
+        function(0, count);
+        return;
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        while (this->workers.size() < helperCount)
+        {
+          this->workers.emplace_back(&WorkerPool::_work, this, this->workers.size(), this->generation);
+        }
+        this->invoke = [](const void* context, const size_t begin, const size_t end) {
+          (*static_cast<const Function*>(context))(begin, end);
+        };
+        this->context = &function;
+        this->count = count;
+        this->chunkSize = chunkSize;
+        this->chunkCount = chunkCount;
+        this->nextChunk.store(0, std::memory_order_relaxed);
+        this->helperCount = helperCount;
+        this->pendingHelpers = helperCount;
+        this->generation++;
+      }
+      this->wakeCondition.notify_all();
+
+      this->_runChunks();
+
+      // Every helper checks out before returning, so none touches the batch once it is gone
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->doneCondition.wait(lock, [this]() { return this->pendingHelpers == 0; });
+    }
 
-  result[0][0] = 1.f / (halfTanFOV * aspect);
-  result[1][1] = 1.f / halfTanFOV;
-  result[2][2] = (zFar + zNear) / (zNear - zFar);
-  result[2][3] = -1.f;
-  result[3][2] = -(2.f * zFar * zNear) / (zFar - zNear);
+  private:
+    std::mutex dispatchMutex;
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+    std::vector<std::thread> workers;
+    size_t generation {0};
+    bool isStopping {false};
 
-  return result;
+    void (*invoke)(const void*, size_t, size_t) {NULL};
+    const void* context {NULL};
+    size_t count {0};
+    size_t chunkSize {0};
+    size_t chunkCount {0};
+    std::atomic<size_t> nextChunk {0};
+    size_t helperCount {0};
+    size_t pendingHelpers {0};
+
+    /**
+     * @brief Takes chunks of the current batch until none are left.
+     */
+    void _runChunks()
+    {
+      while (true)
+      {
+        const size_t chunk = this->nextChunk.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= this->chunkCount)
+        {
+          return;
+        }
+        const size_t begin = chunk * this->chunkSize;
+        const size_t end = begin + this->chunkSize < this->count ? begin + this->chunkSize : this->count;
+        this->invoke(this->context, begin, end);
+      }
+    }
+
+    /**
+     * @brief Waits for batches and helps with the ones that need this worker.
+     *
+     * @param index The index of the worker.
+     * @param generation The batch generation when the worker was started.
+     */
+    void _work(const size_t index, size_t generation)
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      while (true)
+      {
+        this->wakeCondition.wait(lock, [&]() { return this->isStopping || this->generation != generation; });
+        if (this->isStopping)
+        {
+          return;
+        }
+        generation = this->generation;
+        if (index >= this->helperCount)
+        {
+          continue;
+        }
+
+        lock.unlock();
+        this->_runChunks();
+        lock.lock();
+        this->pendingHelpers--;
+        if (this->pendingHelpers == 0)
+        {
+          this->doneCondition.notify_one();
+        }
+      }
+    }
+};
+
+/**
+ * @brief Gets the worker pool shared by the batched operations.
+ *
+ * @return The worker pool.
+ */
+static WorkerPool& getWorkerPool()
+{
+  static WorkerPool workerPool;
+  return workerPool;
+}
+
+/**
+ * @brief Splits the range [0, count) into contiguous chunks and runs them across threads.
+ *
+ * The calling thread works on the chunks together with the persistent workers of the pool.
+ * Chunk boundaries are multiples of 8 so every chunk but the last starts and ends on a full
+ * SIMD batch. The thread count is capped by the number of hardware threads. An empty range
+ * never calls the function, since the batch functions index their arrays by the chunk begin
+ * and may be handed null pointers along with a zero count.
+ *
+ * @param count The number of items.
+ * @param threadCount The requested number of threads.
+ * @param function The callable invoked as function(begin, end) for every chunk.
+ */
+template <typename Function>
+static void parallelFor(const size_t count, const unsigned int threadCount, const Function& function)
+{
+  if (count == 0)
+  {
+    return;
+  }
+  const unsigned int hardwareThreadCount = std::thread::hardware_concurrency();
+  size_t chunkCount = threadCount > 1 ? threadCount : 1;
+  if (hardwareThreadCount > 0 && chunkCount > hardwareThreadCount)
+  {
+    chunkCount = hardwareThreadCount;
+  }
+  if (chunkCount > count / PARALLEL_MIN_CHUNK)
+  {
+    chunkCount = count / PARALLEL_MIN_CHUNK > 1 ? count / PARALLEL_MIN_CHUNK : 1;
+  }
+  if (chunkCount == 1)
+  {
+    function(0, count);
+    return;
+  }
+
+  const size_t chunkSize = (count / chunkCount + 7) & ~static_cast<size_t>(7);
+  const size_t roundedChunkCount = (count + chunkSize - 1) / chunkSize;
+  getWorkerPool().run(count, chunkSize, roundedChunkCount, roundedChunkCount - 1, function);
+}
+
+void kdr::Space::composeMatrices(const kdr::Space::Mat4* lhs, const kdr::Space::Mat4* rhs, kdr::Space::Mat4* result, const size_t count, const unsigned int threadCount)
+{
+  parallelFor(count, threadCount, [&](const size_t begin, const size_t end) {
+    for (size_t i = begin; i < end; i++)
+    {
+      kdr::Simd::multiplyMat4(lhs[i][0], rhs[i][0], result[i][0]);
+    }
+  });
+}
+
+void kdr::Space::multiplyMatrices(const kdr::Space::Mat4& mat, const kdr::Space::Mat4* mats, kdr::Space::Mat4* result, const size_t count, const unsigned int threadCount)
+{
+  parallelFor(count, threadCount, [&](const size_t begin, const size_t end) {
+    kdr::Simd::multiplyMat4Shared(mat[0], mats[begin][0], result[begin][0], end - begin);
+  });
+}
+
+void kdr::Space::translateMatrices(const kdr::Space::Mat4* mats, const float* xs, const float* ys, const float* zs, kdr::Space::Mat4* result, const size_t count, const unsigned int threadCount)
+{
+  parallelFor(count, threadCount, [&](const size_t begin, const size_t end) {
+    for (size_t i = begin; i < end; i++)
+    {
+      if (&result[i] != &mats[i])
+      {
+        result[i] = mats[i];
+      }
+      result[i][3][0] += xs[i];
+      result[i][3][1] += ys[i];
+      result[i][3][2] += zs[i];
+    }
+  });
+}
+
+void kdr::Space::transformPoints(const kdr::Space::Mat4& mat, const float* xs, const float* ys, const float* zs, float* outXs, float* outYs, float* outZs, const size_t count, const unsigned int threadCount)
+{
+  parallelFor(count, threadCount, [&](const size_t begin, const size_t end) {
+    kdr::Simd::transformPoints(mat[0], xs + begin, ys + begin, zs + begin, outXs + begin, outYs + begin, outZs + begin, end - begin);
+  });
+}
+
+void kdr::Space::sincos(const float* radians, float* sines, float* cosines, const size_t count, const unsigned int threadCount)
+{
+  const bool isFast = kdr::Space::getTrigMode() == kdr::Space::TrigMode::Fast;
+  parallelFor(count, threadCount, [&](const size_t begin, const size_t end) {
+    if (isFast)
+    {
+      kdr::Simd::sinCos(radians + begin, sines + begin, cosines + begin, end - begin);
+      return;
+    }
+    for (size_t i = begin; i < end; i++)
+    {
+      kdr::Space::sincos(radians[i], sines[i], cosines[i]);
+    }
+  });
 }
 
-kdr::Space::Mat4 kdr::Space::lookAt(const kdr::Space::Vec3& eye, const kdr::Space::Vec3& target, const kdr::Space::Vec3& up)
+void kdr::Space::rotateMatrices(const kdr::Space::Mat4* mats, const kdr::Space::Vec3& axis, const float* angles, kdr::Space::Mat4* result, const size_t count, const unsigned int threadCount)
 {
-  kdr::Space::Vec3 front = kdr::Space::normalize(eye - target);
-  kdr::Space::Vec3 right = kdr::Space::normalize(kdr::Space::cross(up, front));
-  kdr::Space::Vec3 newUp = kdr::Space::cross(front, right);
-  kdr::Space::Mat4 result;
-
-  result[0][0] = right.x;
-  result[1][0] = right.y;
-  result[2][0] = right.z;
-  result[0][1] = newUp.x;
-  result[1][1] = newUp.y;
-  result[2][1] = newUp.z;
-  result[0][2] = front.x;
-  result[1][2] = front.y;
-  result[2][2] = front.z;
-  result[3][0] = -kdr::Space::dot(right, eye);
-  result[3][1] = -kdr::Space::dot(newUp, eye);
-  result[3][2] = -kdr::Space::dot(front, eye);
-  result[3][3] = 1.f;
-
-  return result;
+  const kdr::Space::Vec3 normalizedAxis = kdr::Space::normalize(axis);
+  parallelFor(count, threadCount, [&](const size_t begin, const size_t end) {
+    float radians[SINCOS_BLOCK_SIZE];
+    float sines[SINCOS_BLOCK_SIZE];
+    float cosines[SINCOS_BLOCK_SIZE];
+    for (size_t blockBegin = begin; blockBegin < end; blockBegin += SINCOS_BLOCK_SIZE)
+    {
+      const size_t blockCount = end - blockBegin < SINCOS_BLOCK_SIZE ? end - blockBegin : SINCOS_BLOCK_SIZE;
+      for (size_t i = 0; i < blockCount; i++)
+      {
+        radians[i] = kdr::Space::radians(angles[blockBegin + i]);
+      }
+      kdr::Space::sincos(radians, sines, cosines, blockCount);
+      for (size_t i = 0; i < blockCount; i++)
+      {
+        result[blockBegin + i] = kdr::Space::_rotate(mats[blockBegin + i], normalizedAxis, sines[i], cosines[i]);
+      }
+    }
+  });
 }
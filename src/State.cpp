@@ -0,0 +1,193 @@
+#include "Kedarium/State.hpp"
+
+void kdr::State::Cache::useProgram(const GLuint program)
+{
+  if (this->_change(this->program, program))
+  {
+    glUseProgram(program);
+  }
+}
+
+void kdr::State::Cache::bindVertexArray(const GLuint vertexArray)
+{
+  if (this->_change(this->vertexArray, vertexArray))
+  {
+    glBindVertexArray(vertexArray);
+  }
+}
+
+void kdr::State::Cache::activeTexture(const GLenum unit)
+{
+  if (this->_change(this->textureUnit, unit))
+  {
+    glActiveTexture(unit);
+  }
+}
+
+void kdr::State::Cache::bindTexture(const GLenum target, const GLuint texture)
+{
+  const size_t unitIndex = this->textureUnit - GL_TEXTURE0;
+  if (unitIndex >= kdr::State::TEXTURE_UNIT_COUNT)
+  {
+    glBindTexture(target, texture);
+    this->issuedCount++;
+    return;
+  }
+
+  kdr::State::Cache::TextureBinding& binding = this->textures[unitIndex];
+  if (binding.target == target && binding.texture == texture)
+  {
+    this->skippedCount++;
+    return;
+  }
+  binding.target = target;
+  binding.texture = texture;
+  glBindTexture(target, texture);
+  this->issuedCount++;
+}
+
+void kdr::State::Cache::setDepthState(const kdr::State::DepthState& depth)
+{
+  kdr::State::DepthState& current = this->renderState.depth;
+  if (this->_change(current.test, depth.test))
+  {
+    depth.test ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST);
+  }
+  if (this->_change(current.write, depth.write))
+  {
+    glDepthMask(depth.write ? GL_TRUE : GL_FALSE);
+  }
+  if (this->_change(current.func, depth.func))
+  {
+    glDepthFunc(depth.func);
+  }
+}
+
+void kdr::State::Cache::setCullState(const kdr::State::CullState& cull)
+{
+  kdr::State::CullState& current = this->renderState.cull;
+  if (this->_change(current.enabled, cull.enabled))
+  {
+    cull.enabled ? glEnable(GL_CULL_FACE) : glDisable(GL_CULL_FACE);
+  }
+  if (this->_change(current.face, cull.face))
+  {
+    glCullFace(cull.face);
+  }
+  if (this->_change(current.frontFace, cull.frontFace))
+  {
+    glFrontFace(cull.frontFace);
+  }
+}
+
+void kdr::State::Cache::setBlendState(const kdr::State::BlendState& blend)
+{
+  kdr::State::BlendState& current = this->renderState.blend;
+  if (this->_change(current.enabled, blend.enabled))
+  {
+    blend.enabled ? glEnable(GL_BLEND) : glDisable(GL_BLEND);
+  }
+
+  // Factors only matter while blending is enabled, so they are left alone otherwise
+  if (!blend.enabled)
+  {
+    return;
+  }
+  const bool srcChanged = this->_change(current.srcFactor, blend.srcFactor);
+  const bool dstChanged = this->_change(current.dstFactor, blend.dstFactor);
+  if (srcChanged || dstChanged)
+  {
+    glBlendFunc(blend.srcFactor, blend.dstFactor);
+  }
+  if (this->_change(current.equation, blend.equation))
+  {
+    glBlendEquation(blend.equation);
+  }
+}
+
+void kdr::State::Cache::setPolygonMode(const GLenum mode)
+{
+  if (this->_change(this->renderState.polygonMode, mode))
+  {
+    glPolygonMode(GL_FRONT_AND_BACK, mode);
+  }
+}
+
+void kdr::State::Cache::setPrimitiveRestart(const bool enabled, const GLuint index)
+{
+  if (this->_change(this->isPrimitiveRestartEnabled, enabled))
+  {
+    enabled ? glEnable(GL_PRIMITIVE_RESTART) : glDisable(GL_PRIMITIVE_RESTART);
+  }
+  if (enabled && this->_change(this->primitiveRestartIndex, index))
+  {
+    glPrimitiveRestartIndex(index);
+  }
+}
+
+void kdr::State::Cache::apply(const kdr::State::RenderState& state)
+{
+  this->setDepthState(state.depth);
+  this->setCullState(state.cull);
+  this->setBlendState(state.blend);
+  this->setPolygonMode(state.polygonMode);
+}
+
+void kdr::State::Cache::releaseProgram(const GLuint program)
+{
+  if (this->program == program)
+  {
+    this->program = kdr::State::Cache::UNKNOWN_NAME;
+  }
+}
+
+void kdr::State::Cache::releaseVertexArray(const GLuint vertexArray)
+{
+  if (this->vertexArray == vertexArray)
+  {
+    this->vertexArray = 0;
+  }
+}
+
+void kdr::State::Cache::releaseTexture(const GLuint texture)
+{
+  for (kdr::State::Cache::TextureBinding& binding : this->textures)
+  {
+    if (binding.texture == texture)
+    {
+      binding.texture = 0;
+    }
+  }
+}
+
+void kdr::State::Cache::invalidate()
+{
+  this->program = kdr::State::Cache::UNKNOWN_NAME;
+  this->vertexArray = kdr::State::Cache::UNKNOWN_NAME;
+  for (kdr::State::Cache::TextureBinding& binding : this->textures)
+  {
+    binding.texture = kdr::State::Cache::UNKNOWN_NAME;
+  }
+  this->textureUnit = GL_TEXTURE0;
+  glActiveTexture(GL_TEXTURE0);
+
+  const kdr::State::RenderState& state = this->renderState;
+  state.depth.test ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST);
+  glDepthMask(state.depth.write ? GL_TRUE : GL_FALSE);
+  glDepthFunc(state.depth.func);
+  state.cull.enabled ? glEnable(GL_CULL_FACE) : glDisable(GL_CULL_FACE);
+  glCullFace(state.cull.face);
+  glFrontFace(state.cull.frontFace);
+  state.blend.enabled ? glEnable(GL_BLEND) : glDisable(GL_BLEND);
+  glBlendFunc(state.blend.srcFactor, state.blend.dstFactor);
+  glBlendEquation(state.blend.equation);
+  glPolygonMode(GL_FRONT_AND_BACK, state.polygonMode);
+  this->isPrimitiveRestartEnabled ? glEnable(GL_PRIMITIVE_RESTART) : glDisable(GL_PRIMITIVE_RESTART);
+  glPrimitiveRestartIndex(this->primitiveRestartIndex);
+}
+
+kdr::State::Cache& kdr::State::getCache()
+{
+  static kdr::State::Cache cache;
+  return cache;
+}
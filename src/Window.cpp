@@ -1,5 +1,12 @@
 #include "Kedarium/Window.hpp"
 
+#include <algorithm>
+
+// The instance attributes read matrices and colors straight from the caller's arrays
+static_assert(sizeof(kdr::Space::Mat4) == 16 * sizeof(GLfloat));
+static_assert(sizeof(kdr::Color::RGBA) == 4 * sizeof(GLfloat));
+static_assert(sizeof(kdr::Graphics::TextureRegion) == 5 * sizeof(GLfloat));
+
 void framebufferSizeCallback(GLFWwindow* window, int width, int height)
 {
   kdr::Window* windowPtr = reinterpret_cast<kdr::Window*>(glfwGetWindowUserPointer(window));
@@ -16,6 +23,13 @@ void framebufferSizeCallback(GLFWwindow* window, int width, int height)
 
 kdr::Window::~Window()
 {
+  delete this->cameraBuffer;
+  delete this->instanceBuffer;
+  delete this->indirectBuffer;
+  delete this->textureCache;
+  delete this->textureLoader;
+  delete this->placeholderTexture;
+  delete this->shaderCompiler;
   glfwDestroyWindow(this->glfwWindow);
 }
 
@@ -60,6 +74,227 @@ void kdr::Window::unmaximize()
   this->isMaximized = false;
 }
 
+void kdr::Window::renderInstanced(
+  const kdr::Solids::Mesh& mesh,
+  const kdr::Space::Mat4* models,
+  const size_t count,
+  const kdr::Color::RGBA* colors,
+  const kdr::Graphics::TextureRegion* regions
+)
+{
+  const GLsizeiptr instanceSize =
+    sizeof(kdr::Space::Mat4) +
+    (colors != NULL ? sizeof(kdr::Color::RGBA) : 0) +
+    (regions != NULL ? sizeof(kdr::Graphics::TextureRegion) : 0);
+
+  mesh.Bind();
+  if (colors == NULL)
+  {
+    glDisableVertexAttribArray(kdr::Graphics::INSTANCE_COLOR_LOCATION);
+    glVertexAttrib4f(kdr::Graphics::INSTANCE_COLOR_LOCATION, 1.f, 1.f, 1.f, 1.f);
+  }
+  if (regions == NULL)
+  {
+    glDisableVertexAttribArray(kdr::Graphics::INSTANCE_TEXTURE_RECT_LOCATION);
+    glDisableVertexAttribArray(kdr::Graphics::INSTANCE_TEXTURE_LAYER_LOCATION);
+    glVertexAttrib4f(kdr::Graphics::INSTANCE_TEXTURE_RECT_LOCATION, 0.f, 0.f, 1.f, 1.f);
+    glVertexAttrib1f(kdr::Graphics::INSTANCE_TEXTURE_LAYER_LOCATION, 0.f);
+  }
+
+  size_t first = 0;
+  while (first < count)
+  {
+    // Leave room for aligning the model, color, and region arrays, which are written back to back
+    const size_t fitting = static_cast<size_t>(std::max<GLsizeiptr>(this->instanceBuffer->getAvailable() - 48, 0) / instanceSize);
+    const size_t batchCount = std::min(count - first, fitting);
+    if (batchCount == 0)
+    {
+      std::cerr << "Failed to fit the instances into the instance buffer!\n";
+      return;
+    }
+
+    const GLintptr modelOffset = this->instanceBuffer->Write(models + first, batchCount * sizeof(kdr::Space::Mat4));
+    this->_linkInstanceModels(mesh, modelOffset);
+    if (colors != NULL)
+    {
+      const GLintptr colorOffset = this->instanceBuffer->Write(colors + first, batchCount * sizeof(kdr::Color::RGBA));
+      mesh.VAO->LinkInstanceAttrib(*this->instanceBuffer, kdr::Graphics::INSTANCE_COLOR_LOCATION, 4, GL_FLOAT, sizeof(kdr::Color::RGBA), colorOffset);
+    }
+    if (regions != NULL)
+    {
+      const GLintptr regionOffset = this->instanceBuffer->Write(regions + first, batchCount * sizeof(kdr::Graphics::TextureRegion));
+      this->_linkInstanceRegions(mesh, regionOffset);
+    }
+
+    glDrawElementsInstanced(mesh.mode, mesh.indexCount, mesh.indexType, NULL, static_cast<GLsizei>(batchCount));
+    first += batchCount;
+  }
+}
+
+void kdr::Window::_renderBatchesIndirect()
+{
+  kdr::Solids::MeshRegistry& meshRegistry = kdr::Solids::getMeshRegistry();
+  const kdr::Solids::Mesh& pool = meshRegistry.getPool();
+
+  this->indirectCommands.clear();
+  this->indirectModels.clear();
+  this->indirectRegions.clear();
+  for (const std::pair<const size_t, InstanceBatch>& batch : this->instanceBatches)
+  {
+    const std::vector<kdr::Space::Mat4>& models = batch.second.models;
+    const std::vector<kdr::Graphics::TextureRegion>& regions = batch.second.regions;
+    if (models.empty())
+    {
+      continue;
+    }
+    const kdr::Solids::Mesh& mesh = meshRegistry.getMesh(batch.first);
+    if (!mesh.isPooled())
+    {
+      this->renderInstanced(mesh, models.data(), models.size(), NULL, regions.data());
+      continue;
+    }
+    this->indirectCommands.push_back({
+      static_cast<GLuint>(mesh.indexCount),
+      static_cast<GLuint>(models.size()),
+      mesh.firstIndex,
+      mesh.baseVertex,
+      static_cast<GLuint>(this->indirectModels.size())
+    });
+    this->indirectModels.insert(this->indirectModels.end(), models.begin(), models.end());
+    this->indirectRegions.insert(this->indirectRegions.end(), regions.begin(), regions.end());
+  }
+  if (this->indirectCommands.empty())
+  {
+    return;
+  }
+
+  pool.Bind();
+  glDisableVertexAttribArray(kdr::Graphics::INSTANCE_COLOR_LOCATION);
+  glVertexAttrib4f(kdr::Graphics::INSTANCE_COLOR_LOCATION, 1.f, 1.f, 1.f, 1.f);
+
+  // Like renderInstanced(), the instances are split into submissions that fit the instance buffer
+  const GLsizeiptr instanceSize = sizeof(kdr::Space::Mat4) + sizeof(kdr::Graphics::TextureRegion);
+  const size_t instanceCount = this->indirectModels.size();
+  size_t commandIndex {0};
+  GLuint commandFirst {0};
+  size_t first {0};
+  while (first < instanceCount)
+  {
+    // Leave room for aligning the model and region arrays, which are written back to back
+    const size_t fitting = static_cast<size_t>(std::max<GLsizeiptr>(this->instanceBuffer->getAvailable() - 32, 0) / instanceSize);
+    const size_t submissionCount = std::min(instanceCount - first, fitting);
+    if (submissionCount == 0)
+    {
+      std::cerr << "Failed to fit the instances into the instance buffer!\n";
+      return;
+    }
+
+    // The commands, or what is left of them, covering the submitted instances
+    this->indirectSubmission.clear();
+    size_t submitted {0};
+    while (submitted < submissionCount)
+    {
+      const kdr::Graphics::DrawElementsIndirectCommand& command = this->indirectCommands[commandIndex];
+      const GLuint drawnCount = static_cast<GLuint>(std::min<size_t>(command.instanceCount - commandFirst, submissionCount - submitted));
+      this->indirectSubmission.push_back({
+        command.count,
+        drawnCount,
+        command.firstIndex,
+        command.baseVertex,
+        static_cast<GLuint>(submitted)
+      });
+      submitted += drawnCount;
+      commandFirst += drawnCount;
+      if (commandFirst == command.instanceCount)
+      {
+        commandIndex++;
+        commandFirst = 0;
+      }
+    }
+
+    const GLintptr modelOffset = this->instanceBuffer->Write(this->indirectModels.data() + first, submissionCount * sizeof(kdr::Space::Mat4));
+    const GLintptr regionOffset = this->instanceBuffer->Write(this->indirectRegions.data() + first, submissionCount * sizeof(kdr::Graphics::TextureRegion));
+    this->_submitIndirect(pool, modelOffset, regionOffset);
+    first += submissionCount;
+  }
+}
+
+void kdr::Window::_submitIndirect(const kdr::Solids::Mesh& pool, const GLintptr modelOffset, const GLintptr regionOffset)
+{
+  // The base instance offsets the per-instance attributes, so one set of pointers serves all commands
+  if (this->indirectBuffer != NULL)
+  {
+    const GLintptr commandOffset = this->indirectBuffer->Write(
+      this->indirectSubmission.data(),
+      this->indirectSubmission.size() * sizeof(kdr::Graphics::DrawElementsIndirectCommand)
+    );
+    if (commandOffset >= 0)
+    {
+      this->_linkInstanceModels(pool, modelOffset);
+      this->_linkInstanceRegions(pool, regionOffset);
+      this->indirectBuffer->Bind();
+      glMultiDrawElementsIndirect(
+        GL_TRIANGLES,
+        pool.indexType,
+        reinterpret_cast<const void*>(commandOffset),
+        static_cast<GLsizei>(this->indirectSubmission.size()),
+        0
+      );
+      this->indirectBuffer->Unbind();
+      return;
+    }
+  }
+
+  for (const kdr::Graphics::DrawElementsIndirectCommand& command : this->indirectSubmission)
+  {
+    this->_linkInstanceModels(pool, modelOffset + command.baseInstance * sizeof(kdr::Space::Mat4));
+    this->_linkInstanceRegions(pool, regionOffset + command.baseInstance * sizeof(kdr::Graphics::TextureRegion));
+    glDrawElementsInstancedBaseVertex(
+      GL_TRIANGLES,
+      command.count,
+      pool.indexType,
+      reinterpret_cast<const void*>(command.firstIndex * kdr::Graphics::EBO::getIndexSize(pool.indexType)),
+      command.instanceCount,
+      command.baseVertex
+    );
+  }
+}
+
+void kdr::Window::_linkInstanceModels(const kdr::Solids::Mesh& mesh, const GLintptr offset)
+{
+  for (GLuint column = 0; column < 4; column++)
+  {
+    mesh.VAO->LinkInstanceAttrib(
+      *this->instanceBuffer,
+      kdr::Graphics::INSTANCE_MODEL_LOCATION + column,
+      4,
+      GL_FLOAT,
+      sizeof(kdr::Space::Mat4),
+      offset + column * 4 * sizeof(GLfloat)
+    );
+  }
+}
+
+void kdr::Window::_linkInstanceRegions(const kdr::Solids::Mesh& mesh, const GLintptr offset)
+{
+  mesh.VAO->LinkInstanceAttrib(
+    *this->instanceBuffer,
+    kdr::Graphics::INSTANCE_TEXTURE_RECT_LOCATION,
+    4,
+    GL_FLOAT,
+    sizeof(kdr::Graphics::TextureRegion),
+    offset
+  );
+  mesh.VAO->LinkInstanceAttrib(
+    *this->instanceBuffer,
+    kdr::Graphics::INSTANCE_TEXTURE_LAYER_LOCATION,
+    1,
+    GL_FLOAT,
+    sizeof(kdr::Graphics::TextureRegion),
+    offset + 4 * sizeof(GLfloat)
+  );
+}
+
 bool kdr::Window::_initializeGlfw()
 {
   glfwInit();
@@ -106,9 +341,44 @@ bool kdr::Window::_initializeGlew()
 
 bool kdr::Window::_initializeOpenGLSettings()
 {
-  glEnable(GL_DEPTH_TEST);
-  glEnable(GL_CULL_FACE);
-  glCullFace(GL_BACK);
+  kdr::State::getCache().apply(kdr::State::RenderState());
+  return true;
+}
+
+bool kdr::Window::_initializeCameraBuffer()
+{
+  this->cameraBuffer = new kdr::Graphics::UBO(sizeof(kdr::CameraUniforms));
+  this->cameraBuffer->BindBase(kdr::Graphics::CAMERA_BLOCK_BINDING);
+  return true;
+}
+
+bool kdr::Window::_initializeInstanceBuffer()
+{
+  this->instanceBuffer = new kdr::Graphics::StreamBuffer(GL_ARRAY_BUFFER, kdr::INSTANCE_BUFFER_REGION_SIZE);
+  return true;
+}
+
+bool kdr::Window::_initializeIndirectBuffer()
+{
+  if (GLEW_ARB_multi_draw_indirect && GLEW_ARB_base_instance)
+  {
+    this->indirectBuffer = new kdr::Graphics::StreamBuffer(GL_DRAW_INDIRECT_BUFFER, kdr::INDIRECT_BUFFER_REGION_SIZE);
+  }
+  return true;
+}
+
+bool kdr::Window::_initializeTextureLoader()
+{
+  const GLubyte whitePixel[4] {0xff, 0xff, 0xff, 0xff};
+  this->textureLoader = new kdr::Graphics::TextureLoader();
+  this->textureCache = new kdr::Graphics::TextureCache(*this->textureLoader, kdr::TEXTURE_CACHE_MEMORY_BUDGET);
+  this->placeholderTexture = new kdr::Graphics::Texture(GL_TEXTURE_2D, 1, 1, whitePixel);
+  return true;
+}
+
+bool kdr::Window::_initializeShaderCompiler()
+{
+  this->shaderCompiler = new kdr::Graphics::ShaderCompiler();
   return true;
 }
 
@@ -118,6 +388,11 @@ void kdr::Window::_initialize()
   if (!this->_initializeGlfwWindow()) return;
   if (!this->_initializeGlew()) return;
   if (!this->_initializeOpenGLSettings()) return;
+  if (!this->_initializeCameraBuffer()) return;
+  if (!this->_initializeInstanceBuffer()) return;
+  if (!this->_initializeIndirectBuffer()) return;
+  if (!this->_initializeTextureLoader()) return;
+  if (!this->_initializeShaderCompiler()) return;
 }
 
 void kdr::Window::_updateDeltaTime()
@@ -131,7 +406,7 @@ void kdr::Window::_updateCamera()
 {
   if (
     this->boundCamera == NULL ||
-    this->boundShader == 0
+    this->cameraBuffer == NULL
   ) return;
   if (this->isMouseLocked)
   {
@@ -139,7 +414,10 @@ void kdr::Window::_updateCamera()
     this->boundCamera->updateMouse(this->glfwWindow);
   }
   this->boundCamera->updateMatrix();
-  this->boundCamera->applyMatrix(this->boundShader);
+
+  const kdr::CameraUniforms cameraUniforms = this->boundCamera->getUniforms();
+  this->cameraBuffer->SetData(0, sizeof(cameraUniforms), &cameraUniforms);
+  this->frustum = kdr::Culling::Frustum(this->boundCamera->getMatrix());
 }
 
 void kdr::Window::_update()
@@ -160,6 +438,14 @@ void kdr::Window::_update()
 void kdr::Window::_render()
 {
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  this->textureLoader->Update();
+  this->textureCache->Update();
+  this->shaderCompiler->Update();
   this->render();
+  this->instanceBuffer->NextFrame();
+  if (this->indirectBuffer != NULL)
+  {
+    this->indirectBuffer->NextFrame();
+  }
   glfwSwapBuffers(this->glfwWindow);
 }
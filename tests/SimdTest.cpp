@@ -0,0 +1,370 @@
+// Compares every kdr::Simd kernel with the scalar fallback on random inputs.
+//
+// Simd.hpp is included twice: first with the vector paths compiled out and the namespace renamed
+// to kdr::SimdScalar, then as configured for this build. Both versions live side by side in this
+// translation unit, so the kernels can be checked against the scalar path bit for bit.
+
+#if defined(KDR_ENABLE_SIMD)
+  #define KDR_TEST_ENABLE_SIMD
+  #undef KDR_ENABLE_SIMD
+#endif
+#define Simd SimdScalar
+#include "Kedarium/Simd.hpp"
+#undef Simd
+#undef KDR_SIMD_HPP
+#undef KDR_IS_CONSTANT_EVALUATED
+#if defined(KDR_TEST_ENABLE_SIMD)
+  #define KDR_ENABLE_SIMD
+#endif
+#include "Kedarium/Simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The return code telling CTest the test was skipped.
+ */
+constexpr int SKIP_RETURN_CODE {77};
+/**
+ * @brief The number of random inputs every kernel is checked with.
+ */
+constexpr int ITERATION_COUNT {1000};
+/**
+ * @brief The number of elements of the batched kernels, chosen to leave a tail after 8 and 4 lanes.
+ */
+constexpr size_t BATCH_COUNT {37};
+/**
+ * @brief The relative tolerance of inverseMat4, whose SSE path uses 2x2 block determinants instead of cofactors.
+ */
+constexpr float INVERSE_TOLERANCE {1e-5f};
+
+static std::mt19937 generator {20240617u};
+static int failureCount {0};
+
+/**
+ * @brief Fills floats with random values.
+ *
+ * @param values The floats to fill.
+ * @param min The smallest value.
+ * @param max The largest value.
+ */
+static void fillRandom(std::vector<float>& values, const float min = -10.f, const float max = 10.f)
+{
+  std::uniform_real_distribution<float> distribution(min, max);
+  for (float& value : values)
+  {
+    value = distribution(generator);
+  }
+}
+
+/**
+ * @brief Makes a random matrix well conditioned by strengthening its diagonal.
+ *
+ * @param values The floats of the matrix.
+ * @param rowCount The number of rows (or columns) of the square part.
+ * @param diagonalStride The distance between two neighbouring diagonal elements.
+ */
+static void strengthenDiagonal(std::vector<float>& values, const int rowCount, const int diagonalStride)
+{
+  for (int i = 0; i < rowCount; i++)
+  {
+    float& diagonal = values[i * diagonalStride];
+    diagonal += diagonal >= 0.f ? 20.f : -20.f;
+  }
+}
+
+/**
+ * @brief Checks whether two floats are identical, ignoring the sign of zero.
+ *
+ * @param lhs The first float.
+ * @param rhs The second float.
+ * @return True if both floats have the same bits, are both zero, or are both NaN.
+ */
+static bool isIdentical(const float lhs, const float rhs)
+{
+  if (lhs == 0.f && rhs == 0.f)
+  {
+    return true;
+  }
+  if (lhs != lhs && rhs != rhs)
+  {
+    return true;
+  }
+  uint32_t lhsBits {0};
+  uint32_t rhsBits {0};
+  std::memcpy(&lhsBits, &lhs, sizeof(lhsBits));
+  std::memcpy(&rhsBits, &rhs, sizeof(rhsBits));
+  return lhsBits == rhsBits;
+}
+
+/**
+ * @brief Compares the results of a kernel with the scalar results within a tolerance.
+ *
+ * Used for kernels that compute the same result as the scalar path through a different
+ * factorization, so only the last bits may differ.
+ *
+ * @param kernel The name of the kernel.
+ * @param expected The scalar results.
+ * @param actual The kernel results.
+ * @param tolerance The largest allowed difference, relative to the largest scalar result.
+ */
+static void expectClose(const std::string& kernel, const std::vector<float>& expected, const std::vector<float>& actual, const float tolerance)
+{
+  float scale {1.f};
+  for (const float value : expected)
+  {
+    scale = std::max(scale, std::fabs(value));
+  }
+  for (size_t i = 0; i < expected.size(); i++)
+  {
+    if (!(std::fabs(expected[i] - actual[i]) <= tolerance * scale))
+    {
+      std::cerr << "Failed to match the scalar " << kernel << " at element " << i << ": ";
+      std::cerr << expected[i] << " != " << actual[i] << '\n';
+      failureCount++;
+      return;
+    }
+  }
+}
+
+/**
+ * @brief Compares the results of a kernel with the scalar results and reports the first mismatch.
+ *
+ * @tparam T The type of the results.
+ * @param kernel The name of the kernel.
+ * @param expected The scalar results.
+ * @param actual The kernel results.
+ */
+template <typename T>
+static void expectIdentical(const std::string& kernel, const std::vector<T>& expected, const std::vector<T>& actual)
+{
+  for (size_t i = 0; i < expected.size(); i++)
+  {
+    bool isSame {false};
+    if constexpr (std::is_same_v<T, float>)
+    {
+      isSame = isIdentical(expected[i], actual[i]);
+    }
+    else
+    {
+      isSame = expected[i] == actual[i];
+    }
+    if (!isSame)
+    {
+      std::cerr << "Failed to match the scalar " << kernel << " at element " << i << ": ";
+      std::cerr << +expected[i] << " != " << +actual[i] << '\n';
+      failureCount++;
+      return;
+    }
+  }
+}
+
+static void testMatrices()
+{
+  std::vector<float> lhs(16), rhs(16 * BATCH_COUNT), vec(4);
+  std::vector<float> expected(16 * BATCH_COUNT), actual(16 * BATCH_COUNT);
+  for (int iteration = 0; iteration < ITERATION_COUNT; iteration++)
+  {
+    fillRandom(lhs);
+    fillRandom(rhs);
+    fillRandom(vec);
+
+    std::vector<float> expected16(16), actual16(16);
+    kdr::SimdScalar::multiplyMat4(lhs.data(), rhs.data(), expected16.data());
+    kdr::Simd::multiplyMat4(lhs.data(), rhs.data(), actual16.data());
+    expectIdentical("multiplyMat4", expected16, actual16);
+
+    kdr::SimdScalar::multiplyMat4Shared(lhs.data(), rhs.data(), expected.data(), BATCH_COUNT);
+    kdr::Simd::multiplyMat4Shared(lhs.data(), rhs.data(), actual.data(), BATCH_COUNT);
+    expectIdentical("multiplyMat4Shared", expected, actual);
+
+    std::vector<float> expected4(4), actual4(4);
+    kdr::SimdScalar::transformVec4(lhs.data(), vec.data(), expected4.data());
+    kdr::Simd::transformVec4(lhs.data(), vec.data(), actual4.data());
+    expectIdentical("transformVec4", expected4, actual4);
+
+    strengthenDiagonal(lhs, 4, 5);
+    kdr::SimdScalar::inverseMat4(lhs.data(), expected16.data());
+    kdr::Simd::inverseMat4(lhs.data(), actual16.data());
+    expectClose("inverseMat4", expected16, actual16, INVERSE_TOLERANCE);
+  }
+}
+
+static void testVectors()
+{
+  std::vector<float> vecA(3), vecB(3);
+  std::vector<float> expected(3), actual(3);
+  for (int iteration = 0; iteration < ITERATION_COUNT; iteration++)
+  {
+    fillRandom(vecA);
+    fillRandom(vecB);
+
+    expectIdentical("dot3", std::vector<float> {kdr::SimdScalar::dot3(vecA.data(), vecB.data())}, std::vector<float> {kdr::Simd::dot3(vecA.data(), vecB.data())});
+
+    kdr::SimdScalar::cross3(vecA.data(), vecB.data(), expected.data());
+    kdr::Simd::cross3(vecA.data(), vecB.data(), actual.data());
+    expectIdentical("cross3", expected, actual);
+
+    kdr::SimdScalar::normalize3(vecA.data(), expected.data());
+    kdr::Simd::normalize3(vecA.data(), actual.data());
+    expectIdentical("normalize3", expected, actual);
+  }
+}
+
+static void testAffine()
+{
+  std::vector<float> lhs(12), rhs(12), vec(3);
+  std::vector<float> expected(12), actual(12);
+  for (int iteration = 0; iteration < ITERATION_COUNT; iteration++)
+  {
+    fillRandom(lhs);
+    fillRandom(rhs);
+    fillRandom(vec);
+
+    kdr::SimdScalar::multiplyAffine(lhs.data(), rhs.data(), expected.data());
+    kdr::Simd::multiplyAffine(lhs.data(), rhs.data(), actual.data());
+    expectIdentical("multiplyAffine", expected, actual);
+
+    std::vector<float> expected3(3), actual3(3);
+    for (const float w : {0.f, 1.f})
+    {
+      kdr::SimdScalar::transformAffine(lhs.data(), vec.data(), w, expected3.data());
+      kdr::Simd::transformAffine(lhs.data(), vec.data(), w, actual3.data());
+      expectIdentical("transformAffine", expected3, actual3);
+    }
+
+    strengthenDiagonal(lhs, 3, 5);
+    kdr::SimdScalar::inverseAffine(lhs.data(), expected.data());
+    kdr::Simd::inverseAffine(lhs.data(), actual.data());
+    expectIdentical("inverseAffine", expected, actual);
+  }
+}
+
+static void testBatches()
+{
+  std::vector<float> mat(16), planes(24);
+  std::vector<float> xs(BATCH_COUNT), ys(BATCH_COUNT), zs(BATCH_COUNT), radii(BATCH_COUNT);
+  std::vector<float> maxXs(BATCH_COUNT), maxYs(BATCH_COUNT), maxZs(BATCH_COUNT);
+  std::vector<float> expectedXs(BATCH_COUNT), expectedYs(BATCH_COUNT), expectedZs(BATCH_COUNT);
+  std::vector<float> actualXs(BATCH_COUNT), actualYs(BATCH_COUNT), actualZs(BATCH_COUNT);
+  std::vector<unsigned char> expectedVisible(BATCH_COUNT), actualVisible(BATCH_COUNT);
+  for (int iteration = 0; iteration < ITERATION_COUNT; iteration++)
+  {
+    fillRandom(mat);
+    fillRandom(planes, -1.f, 1.f);
+    fillRandom(xs);
+    fillRandom(ys);
+    fillRandom(zs);
+    fillRandom(radii, 0.f, 5.f);
+
+    kdr::SimdScalar::transformPoints(mat.data(), xs.data(), ys.data(), zs.data(), expectedXs.data(), expectedYs.data(), expectedZs.data(), BATCH_COUNT);
+    kdr::Simd::transformPoints(mat.data(), xs.data(), ys.data(), zs.data(), actualXs.data(), actualYs.data(), actualZs.data(), BATCH_COUNT);
+    expectIdentical("transformPoints (x)", expectedXs, actualXs);
+    expectIdentical("transformPoints (y)", expectedYs, actualYs);
+    expectIdentical("transformPoints (z)", expectedZs, actualZs);
+
+    kdr::SimdScalar::cullSpheres(planes.data(), xs.data(), ys.data(), zs.data(), radii.data(), BATCH_COUNT, expectedVisible.data());
+    kdr::Simd::cullSpheres(planes.data(), xs.data(), ys.data(), zs.data(), radii.data(), BATCH_COUNT, actualVisible.data());
+    expectIdentical("cullSpheres", expectedVisible, actualVisible);
+
+    for (size_t i = 0; i < BATCH_COUNT; i++)
+    {
+      maxXs[i] = xs[i] + radii[i];
+      maxYs[i] = ys[i] + radii[i];
+      maxZs[i] = zs[i] + radii[i];
+    }
+    const float* const mins[3] {xs.data(), ys.data(), zs.data()};
+    const float* const maxs[3] {maxXs.data(), maxYs.data(), maxZs.data()};
+    kdr::SimdScalar::cullBoxes(planes.data(), mins, maxs, BATCH_COUNT, expectedVisible.data());
+    kdr::Simd::cullBoxes(planes.data(), mins, maxs, BATCH_COUNT, actualVisible.data());
+    expectIdentical("cullBoxes", expectedVisible, actualVisible);
+  }
+}
+
+static void testSinCos()
+{
+  std::vector<float> radians(BATCH_COUNT);
+  std::vector<float> expectedSines(BATCH_COUNT), expectedCosines(BATCH_COUNT);
+  std::vector<float> actualSines(BATCH_COUNT), actualCosines(BATCH_COUNT);
+  for (int iteration = 0; iteration < ITERATION_COUNT; iteration++)
+  {
+    fillRandom(radians, -kdr::Simd::SINCOS_MAX_RADIANS, kdr::Simd::SINCOS_MAX_RADIANS);
+    if (iteration == 0)
+    {
+      radians[0] = 0.f;
+      radians[1] = -0.f;
+      radians[2] = 0.78539816f;
+      radians[3] = -0.78539816f;
+    }
+
+    kdr::SimdScalar::sinCos(radians.data(), expectedSines.data(), expectedCosines.data(), BATCH_COUNT);
+    kdr::Simd::sinCos(radians.data(), actualSines.data(), actualCosines.data(), BATCH_COUNT);
+    expectIdentical("sinCos (sine)", expectedSines, actualSines);
+    expectIdentical("sinCos (cosine)", expectedCosines, actualCosines);
+  }
+
+  // Out of range and non-finite angles, scattered across the lanes of every path, must match libm
+  const std::vector<float> specialRadians {
+    1e9f, -1e9f, 1e6f, -1e6f, 8192.5f, -8192.5f, 3.4e38f, -3.4e38f,
+    std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN()
+  };
+  for (int iteration = 0; iteration < ITERATION_COUNT; iteration++)
+  {
+    fillRandom(radians, -kdr::Simd::SINCOS_MAX_RADIANS, kdr::Simd::SINCOS_MAX_RADIANS);
+    for (size_t i = 0; i < radians.size(); i++)
+    {
+      if (i % 3 == static_cast<size_t>(iteration % 3))
+      {
+        radians[i] = specialRadians[(i + iteration) % specialRadians.size()];
+      }
+    }
+
+    kdr::SimdScalar::sinCos(radians.data(), expectedSines.data(), expectedCosines.data(), BATCH_COUNT);
+    kdr::Simd::sinCos(radians.data(), actualSines.data(), actualCosines.data(), BATCH_COUNT);
+    expectIdentical("sinCos out of range (sine)", expectedSines, actualSines);
+    expectIdentical("sinCos out of range (cosine)", expectedCosines, actualCosines);
+
+    std::vector<float> libmSines(BATCH_COUNT), libmCosines(BATCH_COUNT);
+    for (size_t i = 0; i < radians.size(); i++)
+    {
+      const bool isInRange = std::fabs(radians[i]) <= kdr::Simd::SINCOS_MAX_RADIANS;
+      libmSines[i] = isInRange ? actualSines[i] : std::sin(radians[i]);
+      libmCosines[i] = isInRange ? actualCosines[i] : std::cos(radians[i]);
+    }
+    expectIdentical("sinCos out of range against libm (sine)", libmSines, actualSines);
+    expectIdentical("sinCos out of range against libm (cosine)", libmCosines, actualCosines);
+  }
+}
+
+int main()
+{
+#if defined(KDR_SIMD_AVX) && (defined(__GNUC__) || defined(__clang__))
+  if (!__builtin_cpu_supports("avx"))
+  {
+    std::cout << "Skipping the AVX kernels, the CPU does not support AVX.\n";
+    return SKIP_RETURN_CODE;
+  }
+#endif
+
+  std::cout << "Testing the " << kdr::Simd::getInstructionSet() << " kernels against the " << kdr::SimdScalar::getInstructionSet() << " path.\n";
+  testMatrices();
+  testVectors();
+  testAffine();
+  testBatches();
+  testSinCos();
+
+  if (failureCount > 0)
+  {
+    std::cerr << failureCount << " kernel comparisons failed!\n";
+    return 1;
+  }
+  std::cout << "All kernels match.\n";
+  return 0;
+}